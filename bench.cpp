@@ -0,0 +1,461 @@
+#include "process.h"
+#include "dumper.h"
+
+#include <chrono>
+#include <charconv>
+#ifdef _WIN32
+#include "process_win32.h"
+#include <io.h>
+#include <fcntl.h>
+using CProcessNativeIO = CProcessWinIO;
+#else
+#include "process_linux.h"
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
+using CProcessNativeIO = CProcessLinuxIO;
+#endif
+
+#ifndef MEMOBSERVER_VERSION
+#define MEMOBSERVER_VERSION "unknown"
+#endif
+
+// Benchmarks of the hot paths against a fixture process started by the benchmark itself, so nothing but the binary is
+// needed. Results are written to stdout as one JSON document, library logs are discarded so they do not distort the timings
+namespace {
+constexpr std::uint32_t c_PageSize{ 0x1000 };
+
+struct CBenchmarkResult {
+    std::string name{ };
+    std::uint64_t iterations{ };
+    double nanosecondsPerOperation{ };
+    std::uint64_t bytesPerOperation{ }; // 0 when throughput does not apply
+};
+
+class CBenchmarkRunner {
+public:
+    CBenchmarkRunner(std::chrono::milliseconds minimumTime, const std::string& filter)
+        : m_MinimumTime{ minimumTime }, m_Filter{ filter } { }
+
+    // operation is repeated in doubling batches until one batch takes at least the minimum time
+    void run(const std::string& name, std::uint64_t bytesPerOperation, const std::function<void()>& operation) {
+        if(!m_Filter.empty() && name.find(m_Filter) == std::string::npos)
+            return;
+
+        operation(); // warm up caches and lazily built state
+        for(std::uint64_t iterations = 1; ; iterations *= 2) {
+            const auto start = std::chrono::steady_clock::now();
+            for(std::uint64_t i = 0; i < iterations; ++i) {
+                operation();
+            }
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            if(elapsed < m_MinimumTime)
+                continue;
+
+            const double nanoseconds = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+            m_Results.push_back({ name, iterations, nanoseconds / static_cast<double>(iterations), bytesPerOperation });
+            fprintf(stderr, "%-48s %12.0f ns/op\n", name.c_str(), m_Results.back().nanosecondsPerOperation);
+            return;
+        }
+    }
+
+    std::string json() const {
+        std::string json{ "{\"version\":\"" MEMOBSERVER_VERSION "\",\"benchmarks\":[" };
+        for(std::size_t i = 0; i < m_Results.size(); ++i) {
+            const auto& result = m_Results[i];
+            char buffer[256]{ };
+            sprintf_s(buffer, "%s{\"name\":\"%s\",\"iterations\":%llu,\"ns_per_op\":%.1f", i ? "," : "", result.name.c_str(),
+                      static_cast<unsigned long long>(result.iterations), result.nanosecondsPerOperation);
+            json += buffer;
+            if(result.bytesPerOperation) {
+                sprintf_s(buffer, ",\"mb_per_s\":%.1f", static_cast<double>(result.bytesPerOperation) * 1e3 / result.nanosecondsPerOperation / 1.048576);
+                json += buffer;
+            }
+            json += "}";
+        }
+        return json + "]}";
+    }
+private:
+    std::chrono::milliseconds m_MinimumTime;
+    std::string m_Filter;
+    std::vector<CBenchmarkResult> m_Results{ };
+};
+
+// keeps results of benchmarked calls observable so they are not optimized away
+volatile std::uint64_t g_Sink{ };
+
+std::uint8_t* allocatePages(std::size_t size) {
+#ifdef _WIN32
+    return static_cast<std::uint8_t*>(VirtualAlloc(std::nullptr_t(), size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+#else
+    void* pages = mmap(std::nullptr_t(), size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    return pages == MAP_FAILED ? std::nullptr_t() : static_cast<std::uint8_t*>(pages);
+#endif
+}
+
+void protectNoAccess(std::uint8_t* pages, std::size_t size) {
+#ifdef _WIN32
+    DWORD oldProtect{ };
+    VirtualProtect(pages, size, PAGE_NOACCESS, &oldProtect);
+#else
+    mprotect(pages, size, PROT_NONE);
+#endif
+}
+
+// PE32+ headers followed by sectionCount sections of sectionSize bytes, the layout CModule and CModuleDumper expect
+std::uint8_t* createImage(std::uint16_t sectionCount, std::uint32_t sectionSize) {
+    const std::uint32_t imageSize = c_PageSize + sectionCount * sectionSize;
+    std::uint8_t* image = allocatePages(imageSize);
+    if(!image)
+        throw std::runtime_error("Can not allocate the image");
+
+    auto* dosHeader = reinterpret_cast<PIMAGE_DOS_HEADER>(image);
+    dosHeader->e_magic = 0x5a4d;
+    dosHeader->e_lfanew = 0x80;
+    auto* ntHeaders = reinterpret_cast<PIMAGE_NT_HEADERS64>(image + dosHeader->e_lfanew);
+    ntHeaders->Signature = 0x4550;
+    ntHeaders->FileHeader.NumberOfSections = sectionCount;
+    ntHeaders->FileHeader.SizeOfOptionalHeader = sizeof(IMAGE_OPTIONAL_HEADER64);
+    ntHeaders->OptionalHeader.SizeOfImage = imageSize;
+    ntHeaders->OptionalHeader.SizeOfHeaders = 0x400;
+
+    PIMAGE_SECTION_HEADER sections{ IMAGE_FIRST_SECTION(ntHeaders) };
+    for(std::uint16_t i = 0; i < sectionCount; ++i) {
+        sprintf_s(reinterpret_cast<char(&)[8]>(sections[i].Name), ".s%u", i);
+        sections[i].VirtualAddress = c_PageSize + i * sectionSize;
+        sections[i].Misc.VirtualSize = sectionSize;
+        sections[i].SizeOfRawData = sectionSize;
+        sections[i].PointerToRawData = sections[i].VirtualAddress;
+        memset(image + sections[i].VirtualAddress, 0x90 + i, sectionSize);
+    }
+    return image;
+}
+
+// memory the benchmarks read, it lives in the fixture process since IProcessIO refuses to attach to its own process
+struct CFixture {
+    static constexpr std::size_t c_ContiguousSize{ 0x1000000 }, c_FragmentedSize{ 0x100000 };
+    static constexpr std::uint16_t c_SectionCount{ 8 };
+    static constexpr std::uint32_t c_SectionSize{ 0x40000 };
+    static constexpr std::uint32_t c_ImageSize{ c_PageSize + c_SectionCount * c_SectionSize };
+
+    std::uint64_t contiguous{ }, fragmented{ }, image{ };
+};
+
+CFixture createFixture() {
+    std::uint8_t* contiguous = allocatePages(CFixture::c_ContiguousSize);
+    std::uint8_t* fragmented = allocatePages(CFixture::c_FragmentedSize);
+    if(!contiguous || !fragmented)
+        throw std::runtime_error("Can not allocate the read fixtures");
+
+    // every other page is inaccessible, each read crosses a region boundary per page
+    memset(contiguous, 0x5a, CFixture::c_ContiguousSize);
+    memset(fragmented, 0xa5, CFixture::c_FragmentedSize);
+    for(std::size_t offset = c_PageSize; offset < CFixture::c_FragmentedSize; offset += 2 * c_PageSize) {
+        protectNoAccess(fragmented + offset, c_PageSize);
+    }
+
+    return { reinterpret_cast<std::uint64_t>(contiguous), reinterpret_cast<std::uint64_t>(fragmented),
+             reinterpret_cast<std::uint64_t>(createImage(CFixture::c_SectionCount, CFixture::c_SectionSize)) };
+}
+
+// The process the benchmarks attach to. On Linux it is forked after the fixture is created, so it inherits the memory at
+// the same addresses; on Windows this executable is started again with --fixture and reports its addresses over a pipe
+class CFixtureProcess final {
+public:
+    explicit CFixtureProcess(const char* executable) {
+#ifdef _WIN32
+        SECURITY_ATTRIBUTES attributes{ sizeof(attributes), std::nullptr_t(), TRUE };
+        HANDLE childInput{ }, childOutput{ };
+        if(!CreatePipe(&childInput, &m_Input, &attributes, 0) || !CreatePipe(&m_Output, &childOutput, &attributes, 0))
+            throw std::runtime_error("Can not create the fixture pipes");
+        SetHandleInformation(m_Input, HANDLE_FLAG_INHERIT, 0);
+        SetHandleInformation(m_Output, HANDLE_FLAG_INHERIT, 0);
+
+        STARTUPINFOA startupInfo{ sizeof(startupInfo) };
+        startupInfo.dwFlags = STARTF_USESTDHANDLES;
+        startupInfo.hStdInput = childInput;
+        startupInfo.hStdOutput = childOutput;
+        startupInfo.hStdError = GetStdHandle(STD_ERROR_HANDLE);
+        std::string commandLine{ "\"" + std::string(executable) + "\" --fixture" };
+        const BOOL isCreated = CreateProcessA(executable, commandLine.data(), std::nullptr_t(), std::nullptr_t(), TRUE, 0,
+                                              std::nullptr_t(), std::nullptr_t(), &startupInfo, &m_Process);
+        CloseHandle(childInput);
+        CloseHandle(childOutput);
+        if(!isCreated)
+            throw std::runtime_error("Can not start the fixture process");
+
+        std::string line{ };
+        char character{ };
+        DWORD read{ };
+        while(ReadFile(m_Output, &character, 1, &read, std::nullptr_t()) && read && character != '\n') {
+            line += character;
+        }
+        unsigned long long contiguous{ }, fragmented{ }, image{ };
+        if(sscanf_s(line.c_str(), "%llx %llx %llx", &contiguous, &fragmented, &image) != 3)
+            throw std::runtime_error("The fixture process did not report its addresses");
+        m_Fixture = { contiguous, fragmented, image };
+#else
+        (void)executable;
+        m_Fixture = createFixture();
+        m_Id = fork();
+        if(m_Id == -1)
+            throw std::runtime_error("Can not fork the fixture process");
+        if(!m_Id) {
+            prctl(PR_SET_PDEATHSIG, SIGKILL);
+            for(;;) {
+                pause();
+            }
+        }
+#endif
+    }
+
+    ~CFixtureProcess() {
+#ifdef _WIN32
+        CloseHandle(m_Input); // end of input lets the fixture exit
+        if(WaitForSingleObject(m_Process.hProcess, 5000) != WAIT_OBJECT_0)
+            TerminateProcess(m_Process.hProcess, 1);
+        CloseHandle(m_Output);
+        CloseHandle(m_Process.hThread);
+        CloseHandle(m_Process.hProcess);
+#else
+        kill(m_Id, SIGKILL);
+        waitpid(m_Id, std::nullptr_t(), 0);
+#endif
+    }
+
+    CFixtureProcess(const CFixtureProcess&) = delete;
+    CFixtureProcess& operator=(const CFixtureProcess&) = delete;
+
+    std::uint32_t id() const {
+#ifdef _WIN32
+        return m_Process.dwProcessId;
+#else
+        return static_cast<std::uint32_t>(m_Id);
+#endif
+    }
+
+    const CFixture& fixture() const {
+        return m_Fixture;
+    }
+private:
+    CFixture m_Fixture{ };
+#ifdef _WIN32
+    PROCESS_INFORMATION m_Process{ };
+    HANDLE m_Input{ }, m_Output{ };
+#else
+    pid_t m_Id{ -1 };
+#endif
+};
+
+#ifdef _WIN32
+// the --fixture mode of this executable, see CFixtureProcess
+int runFixture() {
+    const CFixture fixture = createFixture();
+    printf("%llx %llx %llx\n", static_cast<unsigned long long>(fixture.contiguous), static_cast<unsigned long long>(fixture.fragmented),
+           static_cast<unsigned long long>(fixture.image));
+    fflush(stdout);
+    while(getchar() != EOF) { }
+    return 0;
+}
+#endif
+
+void benchmarkReads(CBenchmarkRunner& runner, IProcessIO& process, const CFixture& fixture) {
+    const std::uint64_t contiguousAddress{ fixture.contiguous }, fragmentedAddress{ fixture.fragmented };
+    std::vector<std::uint8_t> buffer(CFixture::c_ContiguousSize);
+    for(const std::uint32_t size : { 0x1000u, 0x10000u, 0x100000u }) {
+        const std::string suffix{ "/" + std::to_string(size / 1024) + "k" };
+        runner.run("read/readToBuffer" + suffix, size, [&]() -> void {
+            g_Sink = process.readToBuffer(contiguousAddress, size, buffer.data());
+        });
+        runner.run("read/readPages/contiguous" + suffix, size, [&]() -> void {
+            g_Sink = process.readPages(contiguousAddress, size, buffer.data());
+        });
+        runner.run("read/readCached" + suffix, size, [&]() -> void {
+            g_Sink = process.readCached(contiguousAddress, size, buffer.data());
+        });
+        runner.run("read/readAvailable/fragmented" + suffix, size, [&]() -> void {
+            g_Sink = process.readAvailable(fragmentedAddress, size, buffer.data()).size();
+        });
+
+        CBytesProtectionMask mask(size);
+        runner.run("read/readPages/fragmented+mask" + suffix, size, [&]() -> void {
+            g_Sink = process.readPages(fragmentedAddress, size, buffer.data(), &mask);
+        });
+    }
+
+    std::vector<CReadRequest> requests{ };
+    for(std::size_t offset = 0; offset < CFixture::c_ContiguousSize; offset += 0x10000) {
+        requests.push_back({ contiguousAddress + offset, 0x100, buffer.data() + offset });
+    }
+    runner.run("read/readScatter/256x256b", requests.size() * 0x100, [&]() -> void {
+        g_Sink = process.readScatter(requests);
+    });
+}
+
+void benchmarkMask(CBenchmarkRunner& runner) {
+    constexpr std::size_t c_MaskSize{ 0x100000 };
+    runner.run("mask/setProtection/uniform", c_MaskSize, [&]() -> void {
+        CBytesProtectionMask mask(c_MaskSize);
+        for(std::size_t offset = 0; offset < c_MaskSize; offset += c_PageSize) {
+            mask.setProtection(offset, c_PageSize, PAGE_READWRITE);
+        }
+        g_Sink = mask.runCount();
+    });
+    runner.run("mask/setProtection/alternating", c_MaskSize, [&]() -> void {
+        CBytesProtectionMask mask(c_MaskSize);
+        for(std::size_t offset = 0; offset < c_MaskSize; offset += c_PageSize) {
+            mask.setProtection(offset, c_PageSize, (offset / c_PageSize) % 2 ? PAGE_NOACCESS : PAGE_READWRITE);
+        }
+        g_Sink = mask.runCount();
+    });
+}
+
+void benchmarkFormatting(CBenchmarkRunner& runner) {
+    constexpr std::size_t c_ViewSize{ 0x1000 }, c_BulkSize{ 0x100000 };
+    std::vector<std::uint8_t> bytes(c_BulkSize);
+    for(std::size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<std::uint8_t>(i * 131);
+    }
+    std::vector<char> text(c_BulkSize * 3);
+
+    runner.run("format/bytesToHex/1m", c_BulkSize, [&]() -> void {
+        g_Sink = Utilities::bytesToHex(bytes.data(), bytes.size(), text.data()) - text.data();
+    });
+    runner.run("format/bytesToASCII/1m", c_BulkSize, [&]() -> void {
+        g_Sink = Utilities::bytesToASCII(bytes.data(), bytes.size(), text.data()) - text.data();
+    });
+
+    // a hex view page: 256 rows of 16 bytes, half of them inaccessible
+    CBytesProtectionMaskFormattablePlain plainMask(c_ViewSize);
+    CBytesProtectionMaskFormattableHTML htmlMask(c_ViewSize);
+    for(std::size_t offset = 0; offset < c_ViewSize; offset += 0x800) {
+        const std::uint32_t protection = (offset / 0x800) % 2 ? PAGE_NOACCESS : PAGE_READWRITE;
+        plainMask.setProtection(offset, 0x800, protection);
+        htmlMask.setProtection(offset, 0x800, protection);
+    }
+    const std::span<const std::uint8_t> view{ bytes.data(), c_ViewSize };
+    runner.run("format/rows/plain/4k", c_ViewSize, [&]() -> void {
+        g_Sink = plainMask.formatRows(view, 0, 16).size();
+    });
+    runner.run("format/rows/html/4k", c_ViewSize, [&]() -> void {
+        g_Sink = htmlMask.formatRows(view, 0, 16).size();
+    });
+}
+
+void benchmarkModules(CBenchmarkRunner& runner, const std::shared_ptr<IProcessIO>& process, const CFixture& fixture) {
+    constexpr std::size_t c_ModuleCount{ 64 };
+    const std::uint64_t imageAddress{ fixture.image };
+    const std::uint32_t imageSize{ CFixture::c_ImageSize };
+
+    runner.run("module/parseSections/single", 0, [&]() -> void {
+        CModule module(CModuleMemento(imageAddress, imageSize, "bench"), process.get());
+        g_Sink = module.sections().size();
+    });
+
+    std::vector<CModuleMemento> mementos(c_ModuleCount, CModuleMemento(imageAddress, imageSize, "bench"));
+    runner.run("module/parseSections/lazy/64", 0, [&]() -> void {
+        std::vector<CModule> modules{ };
+        for(const auto& memento : mementos) {
+            modules.emplace_back(memento, process.get());
+        }
+        for(const auto& module : modules) {
+            g_Sink = module.sections().size();
+        }
+    });
+    runner.run("module/parseSections/prefetch/64", 0, [&]() -> void {
+        std::vector<CModule> modules{ };
+        for(const auto& memento : mementos) {
+            modules.emplace_back(memento, process.get());
+        }
+        CModule::prefetchSections(modules);
+        g_Sink = modules.back().sections().size();
+    });
+
+    runner.run("module/dump/2m", imageSize, [&]() -> void {
+        CModuleDumper dumper(process, imageAddress);
+        g_Sink = dumper.dump().size();
+    });
+}
+
+void benchmarkEnumeration(CBenchmarkRunner& runner, IProcessIO& process) {
+    const auto moduleList = process.moduleList().lock();
+    runner.run("enumerate/modules/refresh", 0, [&]() -> void {
+        g_Sink = moduleList->refresh().addedRows.size();
+    });
+    runner.run("enumerate/regions", 0, [&]() -> void {
+        g_Sink = process.regions().size();
+    });
+    runner.run("enumerate/processes/rescan", 0, [&]() -> void {
+        CProcessList processes(TSort::Name, false);
+        g_Sink = processes.data().size();
+    });
+}
+
+bool parseMilliseconds(const std::string& text, std::uint64_t& milliseconds) {
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), milliseconds);
+    return !text.empty() && error == std::errc() && end == text.data() + text.size() && milliseconds <= UINT32_MAX;
+}
+}
+
+int main(int argc, char* argv[]) {
+#ifdef _WIN32
+    if(argc == 2 && std::string(argv[1]) == "--fixture")
+        return runFixture();
+#endif
+
+    std::chrono::milliseconds minimumTime{ 200 };
+    std::string filter{ };
+    for(int i = 1; i < argc; ++i) {
+        const std::string argument{ argv[i] };
+        std::uint64_t milliseconds{ };
+        if(argument == "--min-time" && i + 1 < argc && parseMilliseconds(argv[++i], milliseconds)) {
+            minimumTime = std::chrono::milliseconds(milliseconds);
+        }
+        else if(argument == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        }
+        else {
+            fprintf(stderr, "usage: memobserver_bench [--min-time <ms per benchmark>] [--filter <name substring>]\n");
+            return 1;
+        }
+    }
+
+    // library code logs with printf, only the JSON document goes to stdout
+#ifdef _WIN32
+    const int outputDescriptor = _dup(_fileno(stdout));
+    const int nullDescriptor = _open("NUL", _O_WRONLY);
+    _dup2(nullDescriptor, _fileno(stdout));
+    FILE* output = _fdopen(outputDescriptor, "w");
+#else
+    const int outputDescriptor = dup(STDOUT_FILENO);
+    const int nullDescriptor = open("/dev/null", O_WRONLY | O_CLOEXEC);
+    dup2(nullDescriptor, STDOUT_FILENO);
+    FILE* output = fdopen(outputDescriptor, "w");
+#endif
+    if(!output)
+        return 1;
+
+    CBenchmarkRunner runner(minimumTime, filter);
+    try {
+        const CFixtureProcess fixtureProcess(argv[0]);
+        const auto process = std::make_shared<CProcessNativeIO>(CProcessMemento(fixtureProcess.id(), "memobserver_bench fixture"));
+        if(!process->isAttached())
+            throw std::runtime_error("Can not attach to the fixture process");
+
+        benchmarkReads(runner, *process, fixtureProcess.fixture());
+        benchmarkMask(runner);
+        benchmarkFormatting(runner);
+        benchmarkModules(runner, process, fixtureProcess.fixture());
+        benchmarkEnumeration(runner, *process);
+    } catch(const std::runtime_error& e) {
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    fprintf(output, "%s\n", runner.json().c_str());
+    fclose(output);
+    return 0;
+}
@@ -0,0 +1,383 @@
+#include "process.h"
+#include "dumper.h"
+#include "snapshot.h"
+#include "signature_scanner.h"
+#include "value_scanner.h"
+
+#include <cinttypes>
+#include <charconv>
+#ifdef _WIN32
+#include "process_win32.h"
+#include <io.h>
+using CProcessNativeIO = CProcessWinIO;
+#else
+#include "process_linux.h"
+#include "process_core.h"
+#include <unistd.h>
+using CProcessNativeIO = CProcessLinuxIO;
+#endif
+
+// Headless front end of the core library. Every target of a command produces one JSON object on its own line,
+// the library logs go to stderr so stdout stays machine-readable
+namespace {
+constexpr int c_ExitSuccess{ 0 }, c_ExitUsage{ 1 }, c_ExitTargetFailed{ 2 };
+
+FILE* g_Output{ stdout };
+
+void printUsage() {
+    fprintf(stderr,
+        "usage: memobserver-cli <command> [arguments]\n"
+        "  processes                                    lists running processes\n"
+        "  modules <targets>                            lists modules and their sections\n"
+        "  regions <targets>                            lists committed regions\n"
+        "  read <targets> <address> <size>              reads memory as hex, unreadable pages are left out\n"
+        "  dump <targets> <module> <directory>          dumps a module given by name or base address\n"
+        "  snapshot <targets> <directory> [MB/s]        writes a .snap file of all readable memory\n"
+        "  scan <targets> <signature> [module]          finds a byte signature, wildcards are ??\n"
+        "  find <targets> <type> <value>                finds a value, type is one of i8 i16 i32 i64 f32 f64 str\n"
+        "targets are comma separated process ids"
+#ifndef _WIN32
+        " or paths of ELF core dumps"
+#endif
+        ", addresses and sizes are hexadecimal\n");
+}
+
+std::string jsonString(const std::string& value) {
+    std::string escaped{ "\"" };
+    for(const char c : value) {
+        switch(c) {
+        case '"': escaped += "\\\""; break;
+        case '\\': escaped += "\\\\"; break;
+        case '\n': escaped += "\\n"; break;
+        case '\r': escaped += "\\r"; break;
+        case '\t': escaped += "\\t"; break;
+        default:
+            if(static_cast<unsigned char>(c) < 0x20) {
+                char buffer[8]{ };
+                sprintf_s(buffer, "\\u%04x", c);
+                escaped += buffer;
+            }
+            else {
+                escaped += c;
+            }
+        }
+    }
+    return escaped + "\"";
+}
+
+// addresses are written as hex strings, JSON numbers lose precision above 2^53
+std::string jsonAddress(std::uint64_t address) {
+    char buffer[24]{ };
+    sprintf_s(buffer, "\"%" PRIx64 "\"", address);
+    return buffer;
+}
+
+void printLine(const std::string& line) {
+    fputs(line.c_str(), g_Output);
+    fputc('\n', g_Output);
+}
+
+// @return Returns false and prints an error object when it fails
+bool printTargetError(const std::string& target, const std::string& message) {
+    printLine("{\"target\":" + jsonString(target) + ",\"error\":" + jsonString(message) + "}");
+    return false;
+}
+
+bool parseHex(const std::string& text, std::uint64_t& value) {
+    if(text.empty())
+        return false;
+
+    char* end{ };
+    value = std::strtoull(text.c_str(), &end, 16);
+    return *end == '\0';
+}
+
+bool parseDecimal(const std::string& text, std::uint64_t& value) {
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return !text.empty() && error == std::errc() && end == text.data() + text.size();
+}
+
+std::vector<std::string> splitTargets(const std::string& targets) {
+    std::vector<std::string> result{ };
+    std::size_t start{ };
+    while(start <= targets.size()) {
+        const std::size_t end = std::min(targets.find(',', start), targets.size());
+        if(end > start)
+            result.push_back(targets.substr(start, end - start));
+        start = end + 1;
+    }
+    return result;
+}
+
+class CTargets {
+public:
+    // throws std::runtime_error with the reason when the target can not be opened
+    std::shared_ptr<IProcessIO> open(const std::string& target) {
+        const bool isProcessId = !target.empty() && std::all_of(target.begin(), target.end(), [](char c) { return c >= '0' && c <= '9'; });
+        if(!isProcessId) {
+#ifndef _WIN32
+            return configure(std::make_shared<CProcessCoreIO>(target));
+#else
+            throw std::runtime_error("Not a process id");
+#endif
+        }
+
+        std::uint64_t parsedId{ };
+        if(!parseDecimal(target, parsedId) || parsedId > UINT32_MAX)
+            throw std::runtime_error("Process id out of range");
+
+        const auto id = static_cast<std::uint32_t>(parsedId);
+        auto process = std::make_shared<CProcessNativeIO>(CProcessMemento(id, processName(id)));
+        if(!process->isAttached())
+            throw std::runtime_error("Can not attach");
+
+        return configure(process);
+    }
+private:
+    std::string processName(std::uint32_t id) {
+#ifndef _WIN32
+        return CProcessLinuxIO::processName(id);
+#else
+        // one enumeration serves every target of the command
+        if(!m_Processes)
+            m_Processes = std::make_unique<CProcessList>(TSort::None, false);
+        for(const auto& process : m_Processes->data()) {
+            if(process.id() == id)
+                return process.name();
+        }
+        return { };
+#endif
+    }
+
+    static std::shared_ptr<IProcessIO> configure(std::shared_ptr<IProcessIO> process) {
+        const auto moduleList = process->moduleList().lock();
+        moduleList->setSortType(TSort::ID);
+        moduleList->refresh();
+        return process;
+    }
+
+    std::unique_ptr<CProcessList> m_Processes{ };
+};
+
+const CModule* findModule(const IProcessIO& process, const std::string& nameOrAddress) {
+    std::uint64_t address{ };
+    const bool isAddress = parseHex(nameOrAddress, address);
+    for(const auto& module : process.moduleList().lock()->data()) {
+        if(module.memento().name() == nameOrAddress || (isAddress && std::get<0>(module.memento().info()) == address))
+            return &module;
+    }
+    return std::nullptr_t();
+}
+
+std::string targetPrefix(const std::string& target, const IProcessIO& process) {
+    return "{\"target\":" + jsonString(target) + ",\"id\":" + std::to_string(process.memento().id()) + ",\"name\":" + jsonString(process.memento().name());
+}
+
+int listProcesses() {
+    CProcessList processes(TSort::ID, false);
+    for(const auto& process : processes.data()) {
+        printLine("{\"id\":" + std::to_string(process.id()) + ",\"name\":" + jsonString(process.name()) + "}");
+    }
+    return c_ExitSuccess;
+}
+
+bool listModules(const std::string& target, IProcessIO& process) {
+    std::string line{ targetPrefix(target, process) + ",\"modules\":[" };
+    const auto& modules = process.moduleList().lock()->data();
+    CModule::prefetchSections(modules);
+    for(std::size_t i = 0; i < modules.size(); ++i) {
+        const auto [baseAddress, size] = modules[i].memento().info();
+        line += (i ? ",{\"name\":" : "{\"name\":") + jsonString(modules[i].memento().name()) +
+                ",\"base\":" + jsonAddress(baseAddress) + ",\"size\":" + std::to_string(size) + ",\"sections\":[";
+        const auto& sections = modules[i].sections();
+        for(std::size_t j = 0; j < sections.size(); ++j) {
+            const auto [sectionAddress, sectionSize] = sections[j].info();
+            line += (j ? ",{\"tag\":" : "{\"tag\":") + jsonString(sections[j].tag()) +
+                    ",\"base\":" + jsonAddress(sectionAddress) + ",\"size\":" + std::to_string(sectionSize) + "}";
+        }
+        line += "]}";
+    }
+    printLine(line + "]}");
+    return true;
+}
+
+bool listRegions(const std::string& target, IProcessIO& process) {
+    std::string line{ targetPrefix(target, process) + ",\"regions\":[" };
+    bool isFirst{ true };
+    for(const auto& region : process.regions()) {
+        if(region.State != MEM_COMMIT)
+            continue;
+
+        line += (isFirst ? "{\"base\":" : ",{\"base\":") + jsonAddress(reinterpret_cast<std::uint64_t>(region.BaseAddress)) +
+                ",\"size\":" + std::to_string(region.RegionSize) + ",\"protect\":" + jsonString(region.format()) + "}";
+        isFirst = false;
+    }
+    printLine(line + "]}");
+    return true;
+}
+
+bool readMemory(const std::string& target, IProcessIO& process, std::uint64_t address, std::uint32_t size) {
+    std::vector<std::uint8_t> buffer(size);
+    const auto readRanges = process.readAvailable(address, size, buffer.data());
+
+    // one hex string per readable range, offsets are relative to the address
+    std::string line{ targetPrefix(target, process) + ",\"address\":" + jsonAddress(address) + ",\"size\":" + std::to_string(size) + ",\"ranges\":[" };
+    std::string hex(static_cast<std::size_t>(size) * 3, '\0');
+    for(std::size_t i = 0; i < readRanges.size(); ++i) {
+        const auto [offset, rangeSize] = readRanges[i];
+        char* end = Utilities::bytesToHex(buffer.data() + offset, rangeSize, hex.data());
+        std::string bytes(hex.data(), end);
+        bytes.erase(std::remove(bytes.begin(), bytes.end(), ' '), bytes.end());
+        line += (i ? "," : "") + std::string("{\"offset\":") + std::to_string(offset) + ",\"data\":" + jsonString(bytes) + "}";
+    }
+    printLine(line + "]}");
+    return !readRanges.empty();
+}
+
+bool dumpModule(const std::string& target, const std::shared_ptr<IProcessIO>& process, const std::string& moduleName, const std::string& directory) {
+    const CModule* module = findModule(*process, moduleName);
+    if(!module)
+        return printTargetError(target, "Module not found: " + moduleName);
+
+    const auto path = (std::filesystem::path(directory) / (process->memento().name() + "_" + std::to_string(process->memento().id()) + "_" + module->memento().name() + ".dump")).string();
+    CModuleDumper dumper(process, std::get<0>(module->memento().info()));
+    const bool isDumped = dumper.dumpToFile(path);
+    printLine(targetPrefix(target, *process) + ",\"module\":" + jsonString(module->memento().name()) + ",\"path\":" + jsonString(path) + ",\"ok\":" + (isDumped ? "true" : "false") + "}");
+    return isDumped;
+}
+
+bool snapshotProcess(const std::string& target, const std::shared_ptr<IProcessIO>& process, const std::string& directory, std::uint64_t bytesPerSecond) {
+    const auto path = (std::filesystem::path(directory) / (process->memento().name() + "_" + std::to_string(process->memento().id()) + ".snap")).string();
+    CSnapshotDumper dumper(process, bytesPerSecond);
+    const bool isDumped = dumper.dumpToFile(path);
+    printLine(targetPrefix(target, *process) + ",\"path\":" + jsonString(path) + ",\"ok\":" + (isDumped ? "true" : "false") + "}");
+    return isDumped;
+}
+
+bool printAddresses(const std::string& target, const IProcessIO& process, const std::vector<std::uint64_t>& addresses) {
+    std::string line{ targetPrefix(target, process) + ",\"matches\":[" };
+    for(std::size_t i = 0; i < addresses.size(); ++i) {
+        line += (i ? "," : "") + jsonAddress(addresses[i]);
+    }
+    printLine(line + "]}");
+    return true;
+}
+
+bool scanSignature(const std::string& target, const std::shared_ptr<IProcessIO>& process, const CSignature& signature, const std::string& moduleName) {
+    CSignatureScanner scanner(process);
+    if(moduleName.empty())
+        return printAddresses(target, *process, scanner.scanExecutableRegions(signature));
+
+    const CModule* module = findModule(*process, moduleName);
+    if(!module)
+        return printTargetError(target, "Module not found: " + moduleName);
+
+    return printAddresses(target, *process, scanner.scanModule(*module, signature));
+}
+
+bool findValue(const std::string& target, const std::shared_ptr<IProcessIO>& process, TScanValueType valueType, const std::string& value) {
+    CValueScanner scanner(process);
+    if(!scanner.firstScan(valueType, TScanCompare::Exact, value))
+        return printTargetError(target, "Can not parse the value: " + value);
+
+    std::vector<std::uint64_t> addresses{ };
+    for(const auto& result : scanner.results()) {
+        addresses.push_back(result.address);
+    }
+    return printAddresses(target, *process, addresses);
+}
+}
+
+int main(int argc, char* argv[]) {
+    // library code logs with printf, JSON goes to the original stdout and everything else to stderr
+#ifdef _WIN32
+    const int outputDescriptor = _dup(_fileno(stdout));
+    _dup2(_fileno(stderr), _fileno(stdout));
+    g_Output = _fdopen(outputDescriptor, "w");
+#else
+    const int outputDescriptor = dup(STDOUT_FILENO);
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+    g_Output = fdopen(outputDescriptor, "w");
+#endif
+    if(!g_Output)
+        return c_ExitUsage;
+
+    const std::vector<std::string> arguments(argv + 1, argv + argc);
+    if(arguments.empty()) {
+        printUsage();
+        return c_ExitUsage;
+    }
+
+    const std::string& command = arguments[0];
+    if(command == "processes")
+        return listProcesses();
+
+    static const std::unordered_map<std::string, std::size_t> c_MinimumArguments{
+        { "modules", 2 }, { "regions", 2 }, { "read", 4 }, { "dump", 4 }, { "snapshot", 3 }, { "scan", 3 }, { "find", 4 },
+    };
+    const auto minimumArguments = c_MinimumArguments.find(command);
+    if(minimumArguments == c_MinimumArguments.end() || arguments.size() < minimumArguments->second) {
+        printUsage();
+        return c_ExitUsage;
+    }
+
+    // everything which does not depend on the target is parsed once, before any process is opened
+    std::uint64_t address{ }, size{ }, bytesPerSecond{ };
+    std::unique_ptr<CSignature> signature{ };
+    TScanValueType valueType{ };
+    try {
+        if(command == "read" && (!parseHex(arguments[2], address) || !parseHex(arguments[3], size) || !size || size > UINT32_MAX))
+            throw std::invalid_argument("Invalid address or size");
+        if(command == "snapshot" && arguments.size() > 3 && (!parseDecimal(arguments[3], bytesPerSecond) || bytesPerSecond > (UINT64_MAX >> 20)))
+            throw std::invalid_argument("Invalid MB/s");
+        bytesPerSecond <<= 20;
+        if(command == "scan")
+            signature = std::make_unique<CSignature>(arguments[2]);
+        if(command == "find") {
+            static const std::unordered_map<std::string, TScanValueType> c_ValueTypes{
+                { "i8", TScanValueType::Int8 }, { "i16", TScanValueType::Int16 }, { "i32", TScanValueType::Int32 }, { "i64", TScanValueType::Int64 },
+                { "f32", TScanValueType::Float }, { "f64", TScanValueType::Double }, { "str", TScanValueType::String },
+            };
+            const auto type = c_ValueTypes.find(arguments[2]);
+            if(type == c_ValueTypes.end())
+                throw std::invalid_argument("Unknown value type " + arguments[2]);
+            valueType = type->second;
+        }
+    } catch(const std::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        return c_ExitUsage;
+    }
+
+    CTargets targets{ };
+    bool isSuccessful{ true };
+    for(const auto& target : splitTargets(arguments[1])) {
+        std::shared_ptr<IProcessIO> process{ };
+        try {
+            process = targets.open(target);
+        } catch(const std::runtime_error& e) {
+            isSuccessful = printTargetError(target, e.what());
+            continue;
+        }
+
+        bool isTargetSuccessful{ };
+        if(command == "modules")
+            isTargetSuccessful = listModules(target, *process);
+        else if(command == "regions")
+            isTargetSuccessful = listRegions(target, *process);
+        else if(command == "read")
+            isTargetSuccessful = readMemory(target, *process, address, static_cast<std::uint32_t>(size));
+        else if(command == "dump")
+            isTargetSuccessful = dumpModule(target, process, arguments[2], arguments[3]);
+        else if(command == "snapshot")
+            isTargetSuccessful = snapshotProcess(target, process, arguments[2], bytesPerSecond);
+        else if(command == "scan")
+            isTargetSuccessful = scanSignature(target, process, *signature, arguments.size() > 3 ? arguments[3] : "");
+        else if(command == "find")
+            isTargetSuccessful = findValue(target, process, valueType, arguments[3]);
+
+        isSuccessful = isSuccessful && isTargetSuccessful;
+        fflush(g_Output);
+    }
+
+    return isSuccessful ? c_ExitSuccess : c_ExitTargetFailed;
+}
@@ -3,31 +3,41 @@
 
 #include <QPixmap>
 #include <QFontDatabase>
-#include <thread>
+#include <QShowEvent>
+#include <QHideEvent>
+#include <QDesktopServices>
+#include <QUrl>
+#include <fstream>
+#include <filesystem>
 
 void showConsole() {
+#ifdef _WIN32
     AllocConsole();
     freopen("CONOUT$", "w", stdout);
     printf("Console allocated\n");
+#endif
 }
 
-void CMainWindow::startMemoryUpdateThread() {
-    static auto autoUpdateMemoryViewer =
-        [](CMainWindow* window, CSettingsWindow* settings) -> void {
-        while(true) {
-            std::this_thread::sleep_for( std::chrono::milliseconds(settings->memoryViewAutoUpdateInterval()) );
-            if(!settings->memoryViewIsAutoUpdateEnabled())
-                continue;
+void CMainWindow::updateMemoryRefreshState() {
+    m_MemoryRefresh->setInterval(m_Settings->memoryViewAutoUpdateInterval());
+    m_MemoryRefresh->setActive(m_Settings->memoryViewIsAutoUpdateEnabled() && m_ProcessSelector->selectedProcess() &&
+                               !ui->memoryHexView->isEmpty() && isVisible() && !isMinimized());
+}
 
-            emit window->updateMemorySignal();
-        }
-    };
+void CMainWindow::changeEvent(QEvent* event) {
+    QMainWindow::changeEvent(event);
+    if(event->type() == QEvent::WindowStateChange)
+        updateMemoryRefreshState();
+}
 
-    static bool once{ };
-    if(!once) {
-        std::thread(autoUpdateMemoryViewer, this, m_Settings).detach();
-        once = true;
-    }
+void CMainWindow::showEvent(QShowEvent* event) {
+    QMainWindow::showEvent(event);
+    updateMemoryRefreshState();
+}
+
+void CMainWindow::hideEvent(QHideEvent* event) {
+    QMainWindow::hideEvent(event);
+    updateMemoryRefreshState();
 }
 
 void CMainWindow::setupTextures() {
@@ -43,11 +53,21 @@ void CMainWindow::setupTextures() {
 
 void CMainWindow::connectSignals() {
     QObject::connect(m_Settings, &CSettingsWindow::memoryViewFormatChanged, this, &CMainWindow::onMemoryAddressFormatChanged);
+    QObject::connect(m_Settings, &CSettingsWindow::memoryViewAutoUpdateChanged, this, &CMainWindow::updateMemoryRefreshState);
 
-    QObject::connect(this, &CMainWindow::updateMemorySignal, this, &CMainWindow::updateMemoryDataEdit);
+    QObject::connect(ui->memoryHexView, &CHexView::visibleRangeChanged, this, &CMainWindow::updateMemoryInfoLabel);
+    QObject::connect(ui->memoryHexView, &CHexView::pageShown, this, [this](qint64 costMicroseconds, bool isScheduled) -> void {
+        // reads for scrolling and jumps are not the scheduler's work and must not stretch its period
+        if(isScheduled)
+            m_MemoryRefresh->addCost(std::chrono::microseconds(costMicroseconds));
+        widenProvisionalMemoryViewRange();
+        updateMemoryInfoLabel();
+    });
 
     QObject::connect(m_ProcessSelector, &CProcessSelectorWindow::processAttached, this, &CMainWindow::onProcessAttach);
     QObject::connect(m_ProcessSelector, &CProcessSelectorWindow::processDetached, this, &CMainWindow::onProcessDetach);
+
+    QObject::connect(m_MetricsTimer, &QTimer::timeout, this, &CMainWindow::updateMetricsLabel);
 }
 
 CMainWindow::CMainWindow(QWidget *parent)
@@ -55,7 +75,13 @@ CMainWindow::CMainWindow(QWidget *parent)
     , ui(new Ui::CMainWindow)
     , m_Settings{ new CSettingsWindow(this) }
     , m_ProcessSelector{ new CProcessSelectorWindow(this, m_Settings) }
-    , m_ModuleList{ new CModuleListWindow(this, m_Settings, m_ProcessSelector) } {
+    , m_ModuleList{ new CModuleListWindow(this, m_Settings, m_ProcessSelector) }
+    , m_Scanner{ new CScannerWindow(this, m_ProcessSelector) }
+    , m_Diff{ new CDiffWindow(this, m_ProcessSelector) }
+    , m_PointerScanner{ new CPointerScannerWindow(this, m_ProcessSelector) }
+    , m_MemoryRefresh{ new CRefreshScheduler(this, [this]() -> void { updateMemoryView(); }) }
+    , m_MetricsLabel{ new QLabel(this) }
+    , m_MetricsTimer{ new QTimer(this) } {
     ui->setupUi(this);
 
 #ifndef NDEBUG
@@ -64,26 +90,42 @@ CMainWindow::CMainWindow(QWidget *parent)
     setupTextures();
     connectSignals();
 
-    updateMemoryDataEdit();
-    startMemoryUpdateThread();
+    ui->memoryHexView->setOffsetRelative(m_Settings->memoryViewIsOffsetRelative());
+    updateMemoryView();
+    updateMemoryRefreshState();
+
+    // builds without MEMOBSERVER_METRICS have nothing to show
+    if(CMetrics::c_IsEnabled) {
+        ui->statusbar->addPermanentWidget(m_MetricsLabel);
+        m_MetricsTimer->start(c_MetricsUpdateInterval);
+    }
+    ui->actionSave_Metrics->setVisible(CMetrics::c_IsEnabled);
 
     m_ProcessSelector->show();
 }
 
 CMainWindow::~CMainWindow() {
     delete ui;
+    delete m_PointerScanner;
+    delete m_Diff;
+    delete m_Scanner;
     delete m_ModuleList;
     delete m_ProcessSelector;
     delete m_Settings;
 }
 
 void CMainWindow::onProcessAttach() {
-    //
+    ui->memoryHexView->setProcess(m_ProcessSelector->selectedProcess());
+    if(m_MemoryStartAddress)
+        showMemoryAddress(m_MemoryStartAddress);
+    updateMemoryRefreshState();
 }
 
 void CMainWindow::onProcessDetach() {
     m_MemoryStartAddress = { };
-    m_MemoryOffset = { };
+    ui->memoryHexView->setProcess({ });
+    updateMemoryInfoLabel();
+    updateMemoryRefreshState();
 }
 
 void CMainWindow::goToMemoryAddress(std::uint64_t address) {
@@ -92,78 +134,90 @@ void CMainWindow::goToMemoryAddress(std::uint64_t address) {
 
     ui->memoryStartAddress->setText(QString::number(address, 16));
     m_MemoryStartAddress = address;
-    m_MemoryOffset = { };
-    updateMemoryDataEdit();
+    showMemoryAddress(address);
 }
 
-void CMainWindow::updateMemoryDataEdit() {
-    ui->memoryDataEdit->clear();
-    if(!m_ProcessSelector->selectedProcess() || !m_MemoryStartAddress)
-        return;
+std::optional<std::tuple<std::uint64_t, std::uint64_t>> CMainWindow::memoryViewRange(std::uint64_t address) const {
+    const auto process = m_ProcessSelector->selectedProcess();
 
-    std::uint64_t currentAddress = m_MemoryStartAddress + m_MemoryOffset;
-
-    std::uint8_t* buffer = new std::uint8_t[c_MemoryBufferSize]{ };
-    CBytesProtectionMaskFormattablePlain protectionMask(c_MemoryBufferSize);
-    m_ProcessSelector->selectedProcess()->readPages(currentAddress, c_MemoryBufferSize, buffer, &protectionMask);
-
-    for(std::size_t i = 0; i < c_MemoryRows; ++i) {
-        QString bytesRow{ }, charsRow{ };
-        for(std::size_t j = 0; j < c_MemoryBytesInRow; ++j) {
-            std::size_t currentByteIndex = i * c_MemoryBytesInRow + j;
-            bytesRow += (protectionMask.format(currentByteIndex, buffer[currentByteIndex]) + std::string(" ")).c_str();
-            charsRow +=
-                Utilities::isValidASCIIChar(static_cast<char>(buffer[currentByteIndex])) ?
-                            static_cast<char>(buffer[currentByteIndex]) :
-                            '.';
+    // a module is shown whole, so the scrollbar spans all of its sections
+    if(const auto moduleList = process->moduleList().lock()) {
+        for(const auto& module : moduleList->data()) {
+            const auto [baseAddress, size] = module.memento().info();
+            if(address >= baseAddress && address - baseAddress < size)
+                return { baseAddress, size };
         }
+    }
 
-        char locationBuffer[32]{ };
-        auto formatLocation = [&]() -> void {
-            if(m_Settings->memoryViewIsOffsetRelative()) {
-                std::int32_t currentOffset = m_MemoryOffset + static_cast<std::int32_t>(i * c_MemoryBytesInRow);
-                bool isNegative{ currentOffset < 0 };
-                if(;isNegative) {
-                    sprintf_s(locationBuffer, "-%04x:", std::abs(currentOffset));
-                    return;
-                }
-                sprintf_s(locationBuffer, "%05x:", currentOffset);
-            } else { // abs format
-                sprintf_s(locationBuffer, "%llx: ", currentAddress + i * c_MemoryBytesInRow);
-            }
-        };
-
-        formatLocation();
-        ui->memoryDataEdit->append(QString(locationBuffer) + bytesRow + charsRow);
+    // regions come from the reader thread, a query here would block the GUI thread on a slow target
+    const MBIEx& mbi{ ui->memoryHexView->firstVisibleRegion() };
+    const auto regionBase = reinterpret_cast<std::uint64_t>(mbi.BaseAddress);
+    if(mbi.RegionSize && address >= regionBase && address - regionBase < mbi.RegionSize)
+        return std::tuple{ regionBase, static_cast<std::uint64_t>(mbi.RegionSize) };
+
+    return std::nullopt;
+}
+
+void CMainWindow::showMemoryAddress(std::uint64_t address) {
+    if(!m_ProcessSelector->selectedProcess() || !address) {
+        ui->memoryHexView->clear();
+        updateMemoryInfoLabel();
+        updateMemoryRefreshState();
+        return;
     }
 
-    ui->memoryDataEdit->append(QString("--------------------"));
+    const auto range = memoryViewRange(address);
+    m_IsMemoryRangeProvisional = !range;
+    const auto [baseAddress, size] = range.value_or(std::tuple<std::uint64_t, std::uint64_t>{ address & ~0xfffull, 0x1000 });
+    ui->memoryHexView->setRange(baseAddress, size, address);
+    updateMemoryRefreshState();
+}
+
+void CMainWindow::widenProvisionalMemoryViewRange() {
+    if(!m_IsMemoryRangeProvisional)
+        return;
+
+    m_IsMemoryRangeProvisional = false;
+    const MBIEx mbi{ ui->memoryHexView->firstVisibleRegion() }; // setRange() drops the page it comes from
+    if(mbi.RegionSize <= 0x1000)
+        return;
 
-    MBIEx mbi{ m_ProcessSelector->selectedProcess()->query(currentAddress) };
-    ui->memoryDataEdit->append(QString("Page Base and Size: ") +
-                                        QString::number(reinterpret_cast<std::uint64_t>(mbi.BaseAddress), 16) +
-                                        QString(" - ") +
-                                        QString::number(mbi.RegionSize, 16));
-    ui->memoryDataEdit->append(QString("Page Protection: ") +
-                                        QString(mbi.format().c_str()));
-    ui->memoryDataEdit->append(QString("Allocation Base and Size: ") +
-                                        QString::number(reinterpret_cast<std::uint64_t>(mbi.AllocationBase), 16) +
-                                        QString(" - ") +
-                                        QString::number(mbi.RegionSize, 16));
+    // keeps the rows on screen, the user may have scrolled within the page already
+    const std::uint64_t firstVisibleAddress = ui->memoryHexView->firstVisibleAddress();
+    ui->memoryHexView->setRange(reinterpret_cast<std::uint64_t>(mbi.BaseAddress), mbi.RegionSize, ui->memoryHexView->origin());
+    ui->memoryHexView->scrollToAddress(firstVisibleAddress);
 }
 
-void CMainWindow::on_memoryVScrollBar_valueChanged(int value) {
-    static int middleValue =
-        ui->memoryVScrollBar->minimum() +
-        (ui->memoryVScrollBar->maximum() - ui->memoryVScrollBar->minimum()) / 2;
+void CMainWindow::updateMemoryView() {
+    if(!m_ProcessSelector->selectedProcess() || ui->memoryHexView->isEmpty())
+        return;
+
+    // pages stay cached for a bit less than one auto update tick, so scrolling within fetched pages does not hit the target
+    // while every tick still sees fresh memory
+    const int updateInterval{ m_MemoryRefresh->interval() };
+    m_ProcessSelector->selectedProcess()->pageCache().setTimeToLive(std::chrono::milliseconds(updateInterval - updateInterval / 4));
 
-    if(value == middleValue) {
+    ui->memoryHexView->refresh(true);
+}
+
+void CMainWindow::updateMemoryInfoLabel() {
+    if(!m_ProcessSelector->selectedProcess() || ui->memoryHexView->isEmpty()) {
+        ui->memoryInfoLabel->setText("");
         return;
     }
 
-    m_MemoryOffset += (value - middleValue) * c_MemoryBytesInRow;
-    ui->memoryVScrollBar->setValue(middleValue);
-    updateMemoryDataEdit();
+    // the region comes with the page from the reader thread, no query on the GUI thread
+    const MBIEx& mbi{ ui->memoryHexView->firstVisibleRegion() };
+    ui->memoryInfoLabel->setText(QString("Page Base and Size: ") +
+                                 QString::number(reinterpret_cast<std::uint64_t>(mbi.BaseAddress), 16) +
+                                 QString(" - ") +
+                                 QString::number(mbi.RegionSize, 16) +
+                                 QString("\nPage Protection: ") +
+                                 QString(mbi.format().c_str()) +
+                                 QString("\nAllocation Base and Size: ") +
+                                 QString::number(reinterpret_cast<std::uint64_t>(mbi.AllocationBase), 16) +
+                                 QString(" - ") +
+                                 QString::number(mbi.RegionSize, 16));
 }
 
 void CMainWindow::on_memoryStartAddress_textChanged(const QString &arg1) {
@@ -173,33 +227,50 @@ void CMainWindow::on_memoryStartAddress_textChanged(const QString &arg1) {
         return;
 
     m_MemoryStartAddress = address;
-    m_MemoryOffset = { };
-    updateMemoryDataEdit();
+    showMemoryAddress(address);
 }
 
 void CMainWindow::onMemoryAddressFormatChanged() {
-    // yeah, i could just use updateMemoryData but this would be easier to understand
-    updateMemoryDataEdit();
+    ui->memoryHexView->setOffsetRelative(m_Settings->memoryViewIsOffsetRelative());
 }
 
 void CMainWindow::on_memoryResetOffsetButton_clicked() {
     if(!m_MemoryStartAddress)
         return;
 
-    m_MemoryOffset = { };
-    updateMemoryDataEdit();
+    ui->memoryHexView->scrollToAddress(ui->memoryHexView->origin());
 }
 
 void CMainWindow::on_actionOpen_Program_Data_Folder_triggered() {
+#ifdef _WIN32
     char cmd[MAX_PATH + 20]{ };
     sprintf_s(cmd, "explorer %s", Utilities::programDataDirectory().c_str());
     system(cmd);
+#else
+    // the directory comes from the environment, it must not go through a shell
+    QDesktopServices::openUrl(QUrl::fromLocalFile(QString::fromStdString(Utilities::programDataDirectory())));
+#endif
+}
+
+void CMainWindow::on_actionSave_Metrics_triggered() {
+    const std::string path{ (std::filesystem::path(Utilities::programDataDirectory()) /
+                             ("metrics_" + std::to_string(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now())) + ".json")).string() };
+    std::ofstream file(path, std::ios::trunc);
+    file << CMetrics::json() << '\n';
+    updateStatusBar(file ? QString("Metrics saved to ") + path.c_str() : QString("Saving metrics failed"));
 }
 
 void CMainWindow::updateStatusBar(const QString& message) {
     ui->statusbar->showMessage(message);
 }
 
+void CMainWindow::updateMetricsLabel() {
+    // the full text stays available when the status bar is too narrow for it
+    const QString text{ CMetrics::statusText().c_str() };
+    m_MetricsLabel->setText(text.left(160));
+    m_MetricsLabel->setToolTip(text.split(" | ").join('\n'));
+}
+
 void CMainWindow::on_actionSettings_triggered() {
     m_Settings->show();
 }
@@ -212,6 +283,18 @@ void CMainWindow::on_actionModule_List_triggered() {
     m_ModuleList->show();
 }
 
+void CMainWindow::on_actionScanner_triggered() {
+    m_Scanner->show();
+}
+
+void CMainWindow::on_actionMemory_Diff_triggered() {
+    m_Diff->show();
+}
+
+void CMainWindow::on_actionPointer_Scanner_triggered() {
+    m_PointerScanner->show();
+}
+
 void CMainWindow::on_actionExit_triggered() {
     close();
 }
@@ -1,10 +1,18 @@
 #pragma once
 #include <QMainWindow>
 #include <QListWidgetItem>
+#include <QLabel>
+#include <QTimer>
+#include <optional>
 #include "process.h"
 #include "settings.h"
 #include "process_selector.h"
 #include "module_list.h"
+#include "scanner_window.h"
+#include "diff_window.h"
+#include "pointer_scanner_window.h"
+#include "hex_view.h"
+#include "refresh_scheduler.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -23,39 +31,59 @@ public:
     void updateStatusBar(const QString& message = "");
     void goToMemoryAddress(std::uint64_t address);
 private slots:
-    void on_memoryVScrollBar_valueChanged(int value);
     void on_memoryStartAddress_textChanged(const QString &arg1);
     void on_memoryResetOffsetButton_clicked();
 
     void on_actionOpen_Program_Data_Folder_triggered();
+    void on_actionSave_Metrics_triggered();
     void on_actionSettings_triggered();
     void on_actionProcess_Selector_triggered();
     void on_actionModule_List_triggered();
+    void on_actionScanner_triggered();
+    void on_actionMemory_Diff_triggered();
+    void on_actionPointer_Scanner_triggered();
     void on_actionExit_triggered();
 
-    void updateMemoryDataEdit();
+    void updateMemoryView();
+    void updateMemoryInfoLabel();
     void onMemoryAddressFormatChanged();
-signals:
-    void updateMemorySignal();
+    void updateMetricsLabel();
+protected:
+    void changeEvent(QEvent* event) override;
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
 private:
     void connectSignals();
     void setupTextures();
-    void startMemoryUpdateThread();
+    // the memory view is refreshed only while auto update is on, a process is attached, something is shown and the window is visible
+    void updateMemoryRefreshState();
 
     void onProcessAttach();
     void onProcessDetach();
+
+    // @return Returns the module or region around address, nullopt when its region is not known without a query
+    std::optional<std::tuple<std::uint64_t, std::uint64_t>> memoryViewRange(std::uint64_t address) const;
+    void showMemoryAddress(std::uint64_t address);
+    // a range shown before its region was known spans one page, it grows to the region the reader returned
+    void widenProvisionalMemoryViewRange();
 private:
-    static constexpr std::size_t c_MemoryBytesInRow{ 8 }; // must be divisible by 4
-    static constexpr std::size_t c_MemoryRows{ 22 };
-    static constexpr std::size_t c_MemoryBufferSize{ c_MemoryBytesInRow * c_MemoryRows };
+    static constexpr int c_MetricsUpdateInterval{ 1000 };
 
     std::uint64_t m_MemoryStartAddress{ };
-    std::int32_t m_MemoryOffset{ };
+    bool m_IsMemoryRangeProvisional{ };
 
     Ui::CMainWindow *ui;
     CSettingsWindow* m_Settings;
     CProcessSelectorWindow* m_ProcessSelector;
     CModuleListWindow* m_ModuleList;
+    CScannerWindow* m_Scanner;
+    CDiffWindow* m_Diff;
+    CPointerScannerWindow* m_PointerScanner;
+
+    CRefreshScheduler* m_MemoryRefresh;
+
+    QLabel* m_MetricsLabel;
+    QTimer* m_MetricsTimer;
 };
 
 
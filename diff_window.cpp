@@ -0,0 +1,194 @@
+#include "diff_window.h"
+#include "ui_diff_window.h"
+#include "cmainwindow.h"
+
+CDiffWindow::CDiffWindow(QWidget *parent, CProcessSelectorWindow* processSelector)
+    : QDialog(parent)
+    , m_ProgressTimer{ new QTimer(this) }
+    , ui(new Ui::CDiffWindow)
+    , m_ProcessSelector{ processSelector } {
+    ui->setupUi(this);
+
+    if(!qobject_cast<CMainWindow*>(this->parent()))
+        throw std::runtime_error("CMainWindow must be a parent of CDiffWindow");
+
+    setRunning(false);
+    connectSignals();
+}
+
+CDiffWindow::~CDiffWindow() {
+    stopTask();
+    delete ui;
+}
+
+void CDiffWindow::connectSignals() {
+    QObject::connect(this, &CDiffWindow::taskFinished, this, &CDiffWindow::onTaskFinished, Qt::QueuedConnection);
+    QObject::connect(m_ProgressTimer, &QTimer::timeout, this, &CDiffWindow::updateProgress);
+
+    QObject::connect(m_ProcessSelector, &CProcessSelectorWindow::processAttached, this, &CDiffWindow::onProcessAttach);
+    QObject::connect(m_ProcessSelector, &CProcessSelectorWindow::processDetached, this, &CDiffWindow::onProcessDetach);
+}
+
+void CDiffWindow::onProcessAttach() {
+    m_Diff = std::make_unique<CMemoryDiff>(m_ProcessSelector->selectedProcess());
+    m_HasResult = false;
+    setRunning(false);
+    updateResultList();
+}
+
+void CDiffWindow::onProcessDetach() {
+    stopTask();
+    m_Diff.reset();
+    m_HasResult = false;
+    setRunning(false);
+    updateResultList();
+    updateDiffLastLabel();
+}
+
+void CDiffWindow::startTask(std::function<bool()> task) {
+    stopTask();
+    setRunning(true);
+    m_TaskThread = std::thread([this, task]() -> void {
+        emit taskFinished(task());
+    });
+}
+
+void CDiffWindow::stopTask() {
+    if(!m_TaskThread.joinable())
+        return;
+
+    if(m_Diff)
+        m_Diff->cancel();
+    m_TaskThread.join();
+}
+
+void CDiffWindow::setRunning(bool isRunning) {
+    ui->captureButton->setEnabled(!isRunning);
+    ui->diffButton->setEnabled(!isRunning && m_Diff && m_Diff->hasCapture());
+    ui->cancelDiffButton->setEnabled(isRunning);
+    ui->retainLine->setEnabled(!isRunning);
+
+    ui->diffProgressBar->setValue(0);
+    if(isRunning)
+        m_ProgressTimer->start(100);
+    else
+        m_ProgressTimer->stop();
+}
+
+void CDiffWindow::updateProgress() {
+    if(m_Diff)
+        ui->diffProgressBar->setValue(static_cast<int>(m_Diff->progress() * 100.f));
+}
+
+void CDiffWindow::onTaskFinished(bool isSuccessful) {
+    if(m_TaskThread.joinable())
+        m_TaskThread.join();
+
+    setRunning(false);
+    updateResultList();
+    updateDiffLastLabel(isSuccessful ? "" : "Failed, the process is gone or the task was cancelled");
+}
+
+void CDiffWindow::on_captureButton_clicked() {
+    if(!m_Diff) {
+        updateDiffLastLabel("You must select a process first");
+        return;
+    }
+
+    m_Diff->clearRetainedRanges();
+    const QStringList retained = ui->retainLine->text().split(' ', Qt::SkipEmptyParts);
+    if(!retained.isEmpty()) {
+        bool isAddressValid{ }, isSizeValid{ };
+        const std::uint64_t address = retained[0].toULongLong(&isAddressValid, 16);
+        const std::uint64_t size = retained.size() > 1 ? retained[1].toULongLong(&isSizeValid, 16) : 0;
+        if(retained.size() != 2 || !isAddressValid || !isSizeValid || !size) {
+            updateDiffLastLabel("Byte diff range must be an address and a size in hex");
+            return;
+        }
+        m_Diff->retainRange(address, size);
+    }
+
+    m_HasResult = false;
+    CMemoryDiff* diff = m_Diff.get();
+    startTask([=]() -> bool {
+        return diff->capture();
+    });
+}
+
+void CDiffWindow::on_diffButton_clicked() {
+    if(!m_Diff || !m_Diff->hasCapture())
+        return;
+
+    CMemoryDiff* diff = m_Diff.get();
+    CMemoryDiffResult* result = &m_Result;
+    bool* hasResult = &m_HasResult;
+    startTask([=]() -> bool {
+        return *hasResult = diff->diff(*result);
+    });
+}
+
+void CDiffWindow::on_cancelDiffButton_clicked() {
+    if(m_Diff)
+        m_Diff->cancel();
+}
+
+void CDiffWindow::updateResultList() {
+    ui->resultList->clear();
+    if(!m_Diff || !m_Diff->hasCapture()) {
+        ui->diffResultsLabel->setText("No capture");
+        return;
+    }
+
+    if(!m_HasResult) {
+        ui->diffResultsLabel->setText("Captured pages: " + QString::number(m_Diff->capturedPages()));
+        return;
+    }
+
+    ui->diffResultsLabel->setText("Added regions: " + QString::number(m_Result.addedRegions.size()) +
+                                  ", removed: " + QString::number(m_Result.removedRegions.size()) +
+                                  ", changed pages: " + QString::number(m_Result.changedPages.size()));
+
+    // byte runs first, they are what the user asked for explicitly
+    for(const auto& bytes : m_Result.changedBytes) {
+        QString text = QString::number(bytes.address, 16) + "    ";
+        for(std::size_t i = 0; i < bytes.after.size() && i < 16; ++i) {
+            text += QString::number(bytes.before[i], 16).rightJustified(2, '0') + ">" + QString::number(bytes.after[i], 16).rightJustified(2, '0') + " ";
+        }
+        addResult(bytes.after.size() > 16 ? text + "..." : text, bytes.address);
+    }
+    for(const auto& region : m_Result.addedRegions) {
+        addResult("+ " + QString::number(region.address, 16) + "    size " + QString::number(region.size, 16), region.address);
+    }
+    for(const auto& region : m_Result.removedRegions) {
+        addResult("- " + QString::number(region.address, 16) + "    size " + QString::number(region.size, 16), region.address);
+    }
+    for(auto page : m_Result.changedPages) {
+        addResult("~ " + QString::number(page, 16), page);
+    }
+}
+
+void CDiffWindow::addResult(const QString& text, std::uint64_t address) {
+    // listing millions of rows would stall the UI
+    if(ui->resultList->count() >= c_MaximumListedResults)
+        return;
+
+    auto item = new QListWidgetItem(text);
+    item->setData(Qt::UserRole, QVariant::fromValue<qulonglong>(address));
+    ui->resultList->addItem(item);
+}
+
+void CDiffWindow::updateDiffLastLabel(const QString& message) {
+    ui->diffLastMessageLabel->setText(message);
+}
+
+void CDiffWindow::on_resultList_itemDoubleClicked(QListWidgetItem *item) {
+    goToMemoryAddress(item->data(Qt::UserRole).toULongLong());
+}
+
+void CDiffWindow::goToMemoryAddress(std::uint64_t address) {
+    qobject_cast<CMainWindow*>(this->parent())->goToMemoryAddress(address);
+}
+
+void CDiffWindow::on_closeButton_clicked() {
+    hide();
+}
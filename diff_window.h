@@ -0,0 +1,57 @@
+#pragma once
+#include <QDialog>
+#include <QListWidgetItem>
+#include <QTimer>
+#include <thread>
+#include "memory_diff.h"
+#include "process_selector.h"
+
+namespace Ui {
+class CDiffWindow;
+}
+
+class CDiffWindow : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit CDiffWindow(QWidget *parent, CProcessSelectorWindow* processSelector);
+    ~CDiffWindow();
+signals:
+    // emitted from the diff thread
+    void taskFinished(bool isSuccessful);
+private slots:
+    void on_captureButton_clicked();
+    void on_diffButton_clicked();
+    void on_cancelDiffButton_clicked();
+    void on_resultList_itemDoubleClicked(QListWidgetItem *item);
+    void on_closeButton_clicked();
+
+    void onTaskFinished(bool isSuccessful);
+    void onProcessAttach();
+    void onProcessDetach();
+    void updateProgress();
+private:
+    void connectSignals();
+
+    // runs task on m_TaskThread, the same way CScannerWindow runs scans
+    void startTask(std::function<bool()> task);
+    void stopTask();
+    void setRunning(bool isRunning);
+
+    void updateResultList();
+    void updateDiffLastLabel(const QString& message = "");
+    void addResult(const QString& text, std::uint64_t address);
+    void goToMemoryAddress(std::uint64_t address);
+private:
+    static constexpr int c_MaximumListedResults{ 1000 };
+
+    std::unique_ptr<CMemoryDiff> m_Diff{ };
+    CMemoryDiffResult m_Result{ };
+    bool m_HasResult{ };
+    std::thread m_TaskThread{ };
+    QTimer* m_ProgressTimer;
+
+    Ui::CDiffWindow *ui;
+    CProcessSelectorWindow* m_ProcessSelector;
+};
@@ -0,0 +1,157 @@
+#include "dump_queue.h"
+#include <filesystem>
+
+CDumpQueue::CDumpQueue(std::size_t workerCount) {
+    if(!workerCount)
+        workerCount = std::max(2u, std::thread::hardware_concurrency());
+
+    for(std::size_t i = 0; i < workerCount; ++i) {
+        m_Workers.emplace_back(&CDumpQueue::workerLoop, this);
+    }
+}
+
+CDumpQueue::~CDumpQueue() {
+    {
+        std::lock_guard lock(m_Mutex);
+        m_IsStopping = true;
+    }
+    cancelAll();
+    m_JobQueued.notify_all();
+
+    for(auto& worker : m_Workers) {
+        worker.join();
+    }
+}
+
+std::size_t CDumpQueue::enqueue(std::unique_ptr<IDumper> dumper, const std::string& name, const std::string& path) {
+    auto job = std::make_shared<CDumpJob>();
+    job->status.name = name;
+    job->status.path = path;
+    job->status.state = TDumpJobState::Queued;
+    job->dumper = std::move(dumper);
+
+    std::size_t id{ };
+    {
+        std::lock_guard lock(m_Mutex);
+        id = job->status.id = m_NextId++;
+        m_Jobs.push_back(std::move(job));
+    }
+    m_JobQueued.notify_one();
+    return id;
+}
+
+void CDumpQueue::cancel(std::size_t id) {
+    std::lock_guard lock(m_Mutex);
+    for(auto& job : m_Jobs) {
+        if(job->status.id != id)
+            continue;
+
+        if(job->status.state == TDumpJobState::Queued) {
+            job->status.state = TDumpJobState::Cancelled;
+            job->status.message = "Cancelled";
+        }
+        else if(job->status.state == TDumpJobState::Running) {
+            job->dumper->cancel();
+        }
+        break;
+    }
+}
+
+void CDumpQueue::cancelAll() {
+    std::lock_guard lock(m_Mutex);
+    for(auto& job : m_Jobs) {
+        if(job->status.state == TDumpJobState::Queued) {
+            job->status.state = TDumpJobState::Cancelled;
+            job->status.message = "Cancelled";
+        }
+        else if(job->status.state == TDumpJobState::Running) {
+            job->dumper->cancel();
+        }
+    }
+}
+
+std::vector<CDumpJobStatus> CDumpQueue::jobs() const {
+    std::lock_guard lock(m_Mutex);
+    std::vector<CDumpJobStatus> jobs{ };
+    for(const auto& job : m_Jobs) {
+        if(isFinished(job->status.state))
+            continue;
+
+        jobs.push_back(job->status);
+        jobs.back().progress = job->dumper->progress();
+    }
+    return jobs;
+}
+
+std::vector<CDumpJobStatus> CDumpQueue::takeFinished() {
+    std::lock_guard lock(m_Mutex);
+    std::vector<CDumpJobStatus> finished{ };
+    std::erase_if(m_Jobs, [&finished](const std::shared_ptr<CDumpJob>& job) -> bool {
+        if(!isFinished(job->status.state))
+            return false;
+
+        finished.push_back(job->status);
+        return true;
+    });
+    return finished;
+}
+
+bool CDumpQueue::isBusy() const {
+    std::lock_guard lock(m_Mutex);
+    return std::any_of(m_Jobs.begin(), m_Jobs.end(), [](const std::shared_ptr<CDumpJob>& job) -> bool { return !isFinished(job->status.state); });
+}
+
+void CDumpQueue::workerLoop() {
+    while(true) {
+        std::shared_ptr<CDumpJob> job{ };
+        {
+            std::unique_lock lock(m_Mutex);
+            m_JobQueued.wait(lock, [this, &job]() -> bool {
+                auto queued = std::find_if(m_Jobs.begin(), m_Jobs.end(), [](const std::shared_ptr<CDumpJob>& job) -> bool { return job->status.state == TDumpJobState::Queued; });
+                if(queued != m_Jobs.end())
+                    job = *queued;
+                return m_IsStopping || job;
+            });
+            if(!job)
+                return;
+
+            job->status.state = TDumpJobState::Running;
+        }
+
+        // the job is kept alive by the local shared_ptr even if takeFinished() races with us, the status is only touched under the lock
+        runJob(*job);
+    }
+}
+
+void CDumpQueue::runJob(CDumpJob& job) {
+    TDumpJobState state{ TDumpJobState::Done };
+    std::string message{ };
+
+    if(std::filesystem::exists(job.status.path)) {
+        state = TDumpJobState::Failed;
+        message = "File " + job.status.path + " already exists";
+    }
+    else if(!job.dumper->dumpToFile(job.status.path)) {
+        // nothing half written is left behind
+        std::error_code error{ };
+        std::filesystem::remove(job.status.path, error);
+
+        state = job.dumper->isCancelled() ? TDumpJobState::Cancelled : TDumpJobState::Failed;
+        message = job.dumper->isCancelled() ? "Cancelled" : "Failed to dump " + job.status.name;
+    }
+    else {
+        message = "Saved to " + job.status.path;
+    }
+    printf("[CDumpQueue] %s: %s\n", job.status.name.c_str(), message.c_str());
+
+    std::lock_guard lock(m_Mutex);
+    job.status.state = state;
+    job.status.message = message;
+    job.status.progress = state == TDumpJobState::Done ? 1.f : job.dumper->progress();
+    // the dumped image is not needed once it is on the disk
+    job.dumper.reset();
+}
+
+bool CDumpQueue::isFinished(TDumpJobState state) {
+    return state == TDumpJobState::Done || state == TDumpJobState::Failed || state == TDumpJobState::Cancelled;
+}
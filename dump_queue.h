@@ -0,0 +1,62 @@
+#pragma once
+#include "dumper.h"
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <deque>
+
+enum class TDumpJobState : std::uint8_t {
+    Queued,
+    Running,
+    Done,
+    Failed,
+    Cancelled,
+};
+
+struct CDumpJobStatus {
+    std::size_t id{ };
+    std::string name{ };
+    std::string path{ };
+    TDumpJobState state{ };
+    float progress{ };
+    std::string message{ }; // "Saved to ..." or the reason of a failure
+};
+
+// Runs dumpers on worker threads and saves their output, so a selection or all modules are dumped in parallel
+// without blocking the caller. Jobs are started in the order they were queued
+class CDumpQueue {
+public:
+    // 0 workers means one per hardware thread, at least 2 since dumping waits on the disk as much as on the process
+    CDumpQueue(std::size_t workerCount = 0);
+    // cancels everything left and waits for the workers
+    ~CDumpQueue();
+
+    // the output of dumper is written to path with IDumper::dumpToFile, the job fails if the file already exists
+    // @return Returns id of the job
+    std::size_t enqueue(std::unique_ptr<IDumper> dumper, const std::string& name, const std::string& path);
+    void cancel(std::size_t id);
+    void cancelAll();
+
+    // @return Returns status of unfinished jobs in the order they were queued
+    std::vector<CDumpJobStatus> jobs() const;
+    // @return Returns jobs which finished since the last call, they are forgotten by the queue afterwards
+    std::vector<CDumpJobStatus> takeFinished();
+    bool isBusy() const;
+private:
+    struct CDumpJob {
+        CDumpJobStatus status{ };
+        std::unique_ptr<IDumper> dumper{ };
+    };
+
+    void workerLoop();
+    void runJob(CDumpJob& job);
+    static bool isFinished(TDumpJobState state);
+private:
+    mutable std::mutex m_Mutex{ };
+    std::condition_variable m_JobQueued{ };
+    std::deque<std::shared_ptr<CDumpJob>> m_Jobs{ };
+    std::size_t m_NextId{ 1 };
+    bool m_IsStopping{ };
+
+    std::vector<std::thread> m_Workers{ };
+};
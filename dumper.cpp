@@ -1,4 +1,5 @@
 #include "dumper.h"
+#include <fstream>
 
 IDumper::IDumper(std::weak_ptr<IProcessIO> targetProcess)
     : m_TargetProcess{ targetProcess } { }
@@ -10,10 +11,33 @@ const std::vector<std::uint8_t>& IDumper::cachedDump() {
     return dump();
 }
 
+bool IDumper::dumpToFile(const std::string& path) {
+    const auto& data = dump();
+    if(data.empty())
+        return false;
+
+    std::ofstream file(path, std::ios::trunc | std::ios::binary);
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    return static_cast<bool>(file);
+}
+
+float IDumper::progress() const {
+    return m_Progress;
+}
+
+void IDumper::cancel() {
+    m_IsCancelled = true;
+}
+
+bool IDumper::isCancelled() const {
+    return m_IsCancelled;
+}
+
 CSectionDumper::CSectionDumper(std::weak_ptr<IProcessIO> targetProcess, std::uint64_t address, std::uint32_t size)
     : IDumper(targetProcess), m_Address{ address }, m_Size{ size } { }
 
 const std::vector<std::uint8_t>& CSectionDumper::dump() {
+    CMetricScope metric{ TMetric::Dump, m_Size };
     if(m_TargetProcess.expired() || !m_Size || !m_Address)
         return m_Data = { };
 
@@ -21,6 +45,8 @@ const std::vector<std::uint8_t>& CSectionDumper::dump() {
     if(!m_TargetProcess.lock()->readToBuffer(m_Address, m_Size, buffer.data()))
         return m_Data = { };
 
+    m_Progress = 1.f;
+    metric.succeeded();
     return m_Data = std::move(buffer);
 }
 
@@ -28,6 +54,7 @@ CModuleDumper::CModuleDumper(std::weak_ptr<IProcessIO> targetProcess, std::uint6
     : IDumper(targetProcess), m_Address{ address } { }
 
 const std::vector<std::uint8_t>& CModuleDumper::dump() {
+    CMetricScope metric{ TMetric::Dump };
     if(m_TargetProcess.expired() || !m_Address)
         return m_Data = { };
 
@@ -36,16 +63,24 @@ const std::vector<std::uint8_t>& CModuleDumper::dump() {
         return m_Data = { };
 
     // signatures are already checked by the CModule::parseSections()
-    PIMAGE_DOS_HEADER dosHeader{ reinterpret_cast<PIMAGE_DOS_HEADER>(m_Module->headers().data()) };
-    PIMAGE_NT_HEADERS64 ntHeaders{ reinterpret_cast<PIMAGE_NT_HEADERS64>(m_Module->headers().data() + dosHeader->e_lfanew) };
+    const IMAGE_DOS_HEADER* dosHeader{ reinterpret_cast<const IMAGE_DOS_HEADER*>(m_Module->headers().data()) };
+    const IMAGE_NT_HEADERS64* ntHeaders{ reinterpret_cast<const IMAGE_NT_HEADERS64*>(m_Module->headers().data() + dosHeader->e_lfanew) };
     m_Size = ntHeaders->OptionalHeader.SizeOfImage;
 
     m_Data = std::vector<std::uint8_t>(m_Size, 0);
     // check for allocated size?? idkidk
 
-    // copy headers
-    memcpy(m_Data.data(), m_Module->headers().data(), ntHeaders->OptionalHeader.SizeOfHeaders);
+    // copy headers, CModule only read their first page and the rest is read with the sections
+    const std::uint32_t headersSize = std::min(ntHeaders->OptionalHeader.SizeOfHeaders, m_Size);
+    const std::uint32_t parsedHeadersSize = std::min(headersSize, static_cast<std::uint32_t>(m_Module->headers().size()));
+    memcpy(m_Data.data(), m_Module->headers().data(), parsedHeadersSize);
 
+    std::vector<CReadRequest> requests{ };
+    std::uint64_t totalSize{ };
+    if(headersSize > parsedHeadersSize) {
+        requests.push_back({ m_Address + parsedHeadersSize, headersSize - parsedHeadersSize, m_Data.data() + parsedHeadersSize });
+        totalSize += headersSize - parsedHeadersSize;
+    }
     for(auto& section : m_Module->sections()) {
         const auto& sectionHeader = section.rawInfo();
         if(!sectionHeader.VirtualAddress || !sectionHeader.PointerToRawData || !sectionHeader.Misc.VirtualSize) {
@@ -54,19 +89,138 @@ const std::vector<std::uint8_t>& CModuleDumper::dump() {
         }
 
         // fix image by that time
-        if(!m_TargetProcess.lock()->readToBuffer(m_Address + sectionHeader.VirtualAddress, sectionHeader.SizeOfRawData, m_Data.data() + sectionHeader.VirtualAddress))
+        // big sections are split so a batch never gets much larger than c_ReadBatchSize
+        for(std::uint32_t offset = 0; offset < sectionHeader.SizeOfRawData; offset += c_ReadBatchSize) {
+            const std::uint32_t size = std::min(c_ReadBatchSize, sectionHeader.SizeOfRawData - offset);
+            requests.push_back({ m_Address + sectionHeader.VirtualAddress + offset, size, m_Data.data() + sectionHeader.VirtualAddress + offset });
+            totalSize += size;
+        }
+    }
+
+    auto process = m_TargetProcess.lock();
+    std::uint64_t readSize{ };
+    for(std::size_t batchBegin = 0; batchBegin < requests.size(); ) {
+        if(isCancelled() || !process)
+            return m_Data = { };
+
+        std::size_t batchEnd = batchBegin;
+        std::uint64_t batchSize{ };
+        while(batchEnd < requests.size() && (batchEnd == batchBegin || batchSize + requests[batchEnd].size <= c_ReadBatchSize)) {
+            batchSize += requests[batchEnd++].size;
+        }
+
+        const std::span<CReadRequest> batch{ requests.data() + batchBegin, batchEnd - batchBegin };
+        if(process->readScatter(batch) != batch.size())
             return m_Data = { };
+
+        readSize += batchSize;
+        m_Progress = static_cast<float>(readSize) / static_cast<float>(totalSize);
+        batchBegin = batchEnd;
     }
 
-    fixSections();
+    fixSections(m_Data.data());
 
+    m_Progress = 1.f;
+    metric.setBytes(m_Data.size());
+    metric.succeeded();
     return m_Data;
 }
 
-void CModuleDumper::fixSections() {
-    // signatures are already checked as this function must be called at the end of this->dump()
-    PIMAGE_DOS_HEADER dosHeader{ reinterpret_cast<PIMAGE_DOS_HEADER>(m_Data.data()) };
-    PIMAGE_NT_HEADERS64 ntHeaders{ reinterpret_cast<PIMAGE_NT_HEADERS64>(m_Data.data() + dosHeader->e_lfanew) };
+bool CModuleDumper::dumpToFile(const std::string& path) {
+    CMetricScope metric{ TMetric::Dump };
+    if(m_TargetProcess.expired() || !m_Address)
+        return false;
+
+    auto process = m_TargetProcess.lock();
+    m_Module = std::make_unique<CModule>(CModuleMemento(m_Address, 0, ""), process.get());
+    if(m_Module->sections().empty())
+        return false;
+
+    // signatures are already checked by the CModule::parseSections()
+    const IMAGE_DOS_HEADER* dosHeader{ reinterpret_cast<const IMAGE_DOS_HEADER*>(m_Module->headers().data()) };
+    const IMAGE_NT_HEADERS64* ntHeaders{ reinterpret_cast<const IMAGE_NT_HEADERS64*>(m_Module->headers().data() + dosHeader->e_lfanew) };
+    m_Size = ntHeaders->OptionalHeader.SizeOfImage;
+    const std::uint32_t headersSize = std::min(ntHeaders->OptionalHeader.SizeOfHeaders, m_Size);
+
+    // sections are fixed in a copy of the headers, the part beyond the page CModule read comes from the process
+    std::vector<std::uint8_t> headers(std::max<std::size_t>(headersSize, m_Module->headers().size()), 0);
+    memcpy(headers.data(), m_Module->headers().data(), m_Module->headers().size());
+    if(headersSize > m_Module->headers().size()) {
+        const std::uint64_t parsedHeadersSize = m_Module->headers().size();
+        const std::uint32_t remainingSize = static_cast<std::uint32_t>(headersSize - parsedHeadersSize);
+        logUnreadable(m_Address + parsedHeadersSize, remainingSize,
+                      process->readAvailable(m_Address + parsedHeadersSize, remainingSize, headers.data() + parsedHeadersSize));
+    }
+    fixSections(headers.data());
+
+    std::vector<IMAGE_SECTION_HEADER> sections{ };
+    std::uint64_t totalSize{ };
+    for(auto& section : m_Module->sections()) {
+        const auto& sectionHeader = section.rawInfo();
+        if(!sectionHeader.VirtualAddress || !sectionHeader.PointerToRawData || !sectionHeader.Misc.VirtualSize) {
+            // skip abnormal section
+            continue;
+        }
+
+        sections.push_back(sectionHeader);
+        totalSize += sectionHeader.SizeOfRawData;
+    }
+    // the file is written front to back
+    std::sort(sections.begin(), sections.end(), [](const IMAGE_SECTION_HEADER& a, const IMAGE_SECTION_HEADER& b) -> bool {
+        return a.VirtualAddress < b.VirtualAddress;
+    });
+
+    std::ofstream file(path, std::ios::trunc | std::ios::binary);
+    if(!file)
+        return false;
+
+    file.write(reinterpret_cast<const char*>(headers.data()), headersSize);
+    std::uint64_t position{ headersSize };
+
+    std::vector<std::uint8_t> chunk(c_StreamChunkSize);
+    auto writeZeros = [&](std::uint64_t size) -> void {
+        std::fill(chunk.begin(), chunk.end(), 0);
+        while(size) {
+            const std::uint64_t toWrite = std::min<std::uint64_t>(size, chunk.size());
+            file.write(reinterpret_cast<const char*>(chunk.data()), toWrite);
+            position += toWrite;
+            size -= toWrite;
+        }
+    };
+
+    std::uint64_t readSize{ };
+    for(const auto& sectionHeader : sections) {
+        // overlapping sections and the ones sticking out of the image are clipped
+        const std::uint64_t begin = std::max<std::uint64_t>(sectionHeader.VirtualAddress, position);
+        const std::uint64_t end = std::min<std::uint64_t>(static_cast<std::uint64_t>(sectionHeader.VirtualAddress) + sectionHeader.SizeOfRawData, m_Size);
+        if(begin >= end)
+            continue;
+
+        writeZeros(begin - position);
+        for(std::uint64_t offset = begin; offset < end; offset += c_StreamChunkSize) {
+            if(isCancelled())
+                return false;
+
+            const std::uint32_t size = static_cast<std::uint32_t>(std::min<std::uint64_t>(c_StreamChunkSize, end - offset));
+            logUnreadable(m_Address + offset, size, process->readAvailable(m_Address + offset, size, chunk.data()));
+            file.write(reinterpret_cast<const char*>(chunk.data()), size);
+            position += size;
+
+            readSize += size;
+            m_Progress = static_cast<float>(readSize) / static_cast<float>(totalSize);
+        }
+    }
+    writeZeros(m_Size - std::min<std::uint64_t>(position, m_Size));
+
+    m_Progress = 1.f;
+    metric.setBytes(m_Size);
+    return metric.succeeded(static_cast<bool>(file));
+}
+
+void CModuleDumper::fixSections(std::uint8_t* image) {
+    // signatures are already checked by the CModule::parseSections()
+    PIMAGE_DOS_HEADER dosHeader{ reinterpret_cast<PIMAGE_DOS_HEADER>(image) };
+    PIMAGE_NT_HEADERS64 ntHeaders{ reinterpret_cast<PIMAGE_NT_HEADERS64>(image + dosHeader->e_lfanew) };
 
     PIMAGE_SECTION_HEADER sections = IMAGE_FIRST_SECTION(ntHeaders);
     for(int i = 0; i < ntHeaders->FileHeader.NumberOfSections; ++i) {
@@ -74,3 +228,14 @@ void CModuleDumper::fixSections() {
         sections[i].SizeOfRawData = sections[i].Misc.VirtualSize;
     }
 }
+
+void CModuleDumper::logUnreadable(std::uint64_t address, std::uint32_t size, const std::vector<std::pair<std::size_t, std::size_t>>& readRanges) {
+    std::size_t readEnd{ };
+    for(const auto& [offset, readSize] : readRanges) {
+        if(offset > readEnd)
+            printf("[CModuleDumper] Zero-filled unreadable %llx-%llx\n", static_cast<unsigned long long>(address + readEnd), static_cast<unsigned long long>(address + offset));
+        readEnd = offset + readSize;
+    }
+    if(readEnd < size)
+        printf("[CModuleDumper] Zero-filled unreadable %llx-%llx\n", static_cast<unsigned long long>(address + readEnd), static_cast<unsigned long long>(address + size));
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "process.h"
+#include <atomic>
 
 class IDumper {
 public:
@@ -8,9 +9,20 @@ public:
 
     const std::vector<std::uint8_t>& cachedDump();
     virtual const std::vector<std::uint8_t>& dump() = 0;
+    // writes the dump to a new file at path, the default one goes through dump() so the whole dump stays in memory
+    // @return Returns false when the dump failed, was cancelled or the file could not be written
+    virtual bool dumpToFile(const std::string& path);
+
+    // both are safe to call from other threads while dump() runs, a cancelled dump returns empty data
+    float progress() const;
+    void cancel();
+    bool isCancelled() const;
 protected:
     mutable std::vector<std::uint8_t> m_Data{ };
     std::weak_ptr<IProcessIO> m_TargetProcess;
+
+    std::atomic<float> m_Progress{ };
+    std::atomic<bool> m_IsCancelled{ };
 };
 
 class CSectionDumper : public IDumper {
@@ -30,8 +42,17 @@ public:
     ~CModuleDumper() = default;
 
     virtual const std::vector<std::uint8_t>& dump() override;
+    // streams headers and sections to the file chunk by chunk, memory use does not depend on the image size.
+    // Unlike dump() unreadable ranges are zero-filled and logged instead of failing the whole dump
+    virtual bool dumpToFile(const std::string& path) override;
 private:
-    void fixSections();
+    // sections are read in batches of this many bytes, progress and cancellation are checked between them
+    static constexpr std::uint32_t c_ReadBatchSize{ 0x800000 };
+    static constexpr std::uint32_t c_StreamChunkSize{ 0x100000 };
+
+    // image must start with the headers
+    static void fixSections(std::uint8_t* image);
+    static void logUnreadable(std::uint64_t address, std::uint32_t size, const std::vector<std::pair<std::size_t, std::size_t>>& readRanges);
 
     std::unique_ptr<CModule> m_Module{ };
     std::uint64_t m_Address{ };
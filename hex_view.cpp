@@ -0,0 +1,309 @@
+#include "hex_view.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+#include <QScrollBar>
+
+CHexViewReader::CHexViewReader(QObject* parent)
+    : QObject(parent) {
+    m_ReaderThread = std::thread(&CHexViewReader::readPages, this);
+}
+
+CHexViewReader::~CHexViewReader() {
+    {
+        std::scoped_lock lock{ m_Mutex };
+        m_IsStopping = true;
+    }
+    m_Condition.notify_all();
+    m_ReaderThread.join();
+}
+
+void CHexViewReader::request(std::weak_ptr<IProcessIO> process, std::uint64_t address, std::size_t size, std::uint64_t generation, bool isScheduled) {
+    {
+        std::scoped_lock lock{ m_Mutex };
+        m_Request = CRequest{ process, address, size, generation, isScheduled };
+    }
+    m_Condition.notify_all();
+}
+
+void CHexViewReader::cancel() {
+    std::scoped_lock lock{ m_Mutex };
+    m_Request.reset();
+}
+
+bool CHexViewReader::take(CHexViewPage& page, std::uint64_t minimumGeneration) {
+    bool isTaken{ };
+    {
+        std::scoped_lock lock{ m_Mutex };
+        if(!m_IsCompleted)
+            return false;
+
+        m_IsCompleted = false;
+        isTaken = m_Page.generation >= minimumGeneration;
+        if(isTaken) {
+            // same window as the page on screen: highlight what changed
+            const std::size_t size = m_Page.bytes.size();
+            m_Page.changedBytes.assign(size, false);
+            if(m_Page.address == page.address && size == page.bytes.size() && page.mask) {
+                for(std::size_t i = 0; i < size; ++i) {
+                    m_Page.changedBytes[i] = m_Page.bytes[i] != page.bytes[i] || m_Page.mask->type(i) != page.mask->type(i);
+                }
+            }
+            std::swap(page, m_Page);
+        }
+    }
+    m_Condition.notify_all();
+    return isTaken;
+}
+
+void CHexViewReader::readPages() {
+    for(;;) {
+        CRequest request{ };
+        {
+            std::unique_lock lock{ m_Mutex };
+            // a completed page is not overwritten before the view took it
+            m_Condition.wait(lock, [this]() -> bool { return m_IsStopping || (m_Request && !m_IsCompleted); });
+            if(m_IsStopping)
+                return;
+
+            request = std::move(*m_Request);
+            m_Request.reset();
+        }
+
+        std::shared_ptr<IProcessIO> process = request.process.lock();
+        if(!process) // released before the read started
+            continue;
+
+        const auto start = std::chrono::steady_clock::now();
+        m_Page.address = request.address;
+        m_Page.bytes.assign(request.size, 0);
+        m_Page.mask = std::make_unique<CBytesProtectionMaskFormattablePlain>(request.size);
+        process->readPages(request.address, static_cast<std::uint32_t>(request.size), m_Page.bytes.data(), m_Page.mask.get(), true);
+        m_Page.region = process->queryCached(request.address);
+        m_Page.generation = request.generation;
+        m_Page.cost = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        m_Page.isScheduled = request.isScheduled;
+
+        {
+            std::scoped_lock lock{ m_Mutex };
+            // also the page of a request cancelled while reading, take() drops it by the generation
+            m_IsCompleted = true;
+        }
+        // The view may have released the process during the read, then this is the last reference. The process is a
+        // QObject of the GUI thread and closes its access to the target when destroyed, so it is released there
+        QMetaObject::invokeMethod(this, [process = std::move(process)]() -> void { }, Qt::QueuedConnection);
+        emit pageCompleted();
+    }
+}
+
+CHexView::CHexView(QWidget* parent)
+    : QAbstractScrollArea(parent), m_Reader{ new CHexViewReader(this) } {
+    setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    viewport()->setAutoFillBackground(true);
+    updateScrollBar();
+
+    QObject::connect(m_Reader, &CHexViewReader::pageCompleted, this, &CHexView::onPageCompleted, Qt::QueuedConnection);
+}
+
+void CHexView::setProcess(std::weak_ptr<IProcessIO> process) {
+    // a read of the previous process may still be running, clear() bumps the generation so its page is never shown
+    m_Reader->cancel();
+    m_Process = process;
+    clear();
+}
+
+void CHexView::setRange(std::uint64_t baseAddress, std::uint64_t size, std::uint64_t origin) {
+    ++m_Generation;
+    m_RangeBase = baseAddress;
+    m_RangeSize = size;
+    m_Origin = origin;
+    resetBuffer();
+    updateScrollBar();
+    scrollToAddress(origin);
+}
+
+void CHexView::scrollToAddress(std::uint64_t address) {
+    if(address < m_RangeBase || address - m_RangeBase >= m_RangeSize)
+        return;
+
+    const std::uint64_t row = (address - m_RangeBase) / c_BytesInRow;
+    const std::uint64_t maxFirstRow = totalRows() > visibleRows() ? totalRows() - visibleRows() : 0;
+    verticalScrollBar()->setValue(static_cast<int>(std::min(row, maxFirstRow) / m_RowsPerStep));
+
+    // setValue does not emit when the value stays, but the row within a step may still differ
+    m_FirstRow = std::min(row, maxFirstRow);
+    refresh();
+    emit visibleRangeChanged();
+}
+
+void CHexView::setOffsetRelative(bool isRelative) {
+    m_IsOffsetRelative = isRelative;
+    viewport()->update();
+}
+
+void CHexView::clear() {
+    ++m_Generation;
+    m_RangeBase = m_RangeSize = m_Origin = m_FirstRow = { };
+    resetBuffer();
+    updateScrollBar();
+    viewport()->update();
+}
+
+std::uint64_t CHexView::origin() const {
+    return m_Origin;
+}
+
+std::uint64_t CHexView::firstVisibleAddress() const {
+    return m_RangeBase + m_FirstRow * c_BytesInRow;
+}
+
+const MBIEx& CHexView::firstVisibleRegion() const {
+    return m_Page.region;
+}
+
+bool CHexView::isEmpty() const {
+    return !m_RangeSize;
+}
+
+void CHexView::refresh(bool isScheduled) {
+    if(m_Process.expired() || !m_RangeSize) {
+        if(!m_Page.bytes.empty()) {
+            resetBuffer();
+            viewport()->update();
+        }
+        return;
+    }
+
+    const std::uint64_t address = firstVisibleAddress();
+    const std::uint64_t rangeEnd = m_RangeBase + m_RangeSize;
+    const std::size_t size = static_cast<std::size_t>(std::min<std::uint64_t>(visibleRows() * c_BytesInRow, rangeEnd - address));
+    m_Reader->request(m_Process, address, size, m_Generation, isScheduled);
+}
+
+void CHexView::onPageCompleted() {
+    const std::uint64_t previousAddress = m_Page.address;
+    const std::size_t previousSize = m_Page.bytes.size();
+    const std::vector<bool> previousChangedBytes = m_Page.changedBytes;
+    if(!m_Reader->take(m_Page, m_Generation))
+        return;
+
+    // same window as before: repaint only the rows which differ from what is on screen
+    const std::size_t size = m_Page.bytes.size();
+    if(m_Page.address == previousAddress && size == previousSize) {
+        for(std::size_t row = 0; row * c_BytesInRow < size; ++row) {
+            const auto rowBegin = row * c_BytesInRow, rowEnd = std::min(rowBegin + c_BytesInRow, size);
+            const bool isRowChanged =
+                std::find(m_Page.changedBytes.begin() + rowBegin, m_Page.changedBytes.begin() + rowEnd, true) != m_Page.changedBytes.begin() + rowEnd ||
+                std::find(previousChangedBytes.begin() + rowBegin, previousChangedBytes.begin() + rowEnd, true) != previousChangedBytes.begin() + rowEnd;
+            if(isRowChanged)
+                viewport()->update(0, static_cast<int>(row) * lineHeight(), viewport()->width(), lineHeight());
+        }
+    } else {
+        viewport()->update();
+        emit visibleRangeChanged();
+    }
+    emit pageShown(m_Page.cost.count(), m_Page.isScheduled);
+}
+
+void CHexView::paintEvent(QPaintEvent* event) {
+    static const std::unordered_map<CBytesProtectionMask::TByteType, QColor> protectionColors{
+        { CBytesProtectionMask::TByteType::NoAccess, QColor("LightSlateGray") },
+        { CBytesProtectionMask::TByteType::Guarded, QColor("Navy") },
+        { CBytesProtectionMask::TByteType::RWX, QColor("Indigo") },
+        { CBytesProtectionMask::TByteType::Execute, QColor("OliveDrab") },
+    };
+    static const QColor changedByteColor{ "#ffd27f" };
+
+    QPainter painter(viewport());
+    if(m_Page.bytes.empty() || !m_Page.mask)
+        return;
+
+    const int charWidth = fontMetrics().horizontalAdvance(QChar('0'));
+    const int ascent = fontMetrics().ascent();
+    const int bytesX = c_LocationColumnChars * charWidth;
+    const int charsX = bytesX + static_cast<int>(c_BytesInRow * 3 + 1) * charWidth;
+
+    const std::size_t firstRow = static_cast<std::size_t>(std::max(event->rect().top(), 0) / lineHeight());
+    const std::size_t lastRow = static_cast<std::size_t>(std::max(event->rect().bottom(), 0) / lineHeight());
+    for(std::size_t row = firstRow; row <= lastRow && row * c_BytesInRow < m_Page.bytes.size(); ++row) {
+        const int y = static_cast<int>(row) * lineHeight();
+
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(0, y + ascent, formatLocation(m_Page.address + row * c_BytesInRow));
+
+        const std::size_t rowBegin = row * c_BytesInRow, rowEnd = std::min(rowBegin + c_BytesInRow, m_Page.bytes.size());
+        const std::span<const std::uint8_t> rowBytes{ m_Page.bytes.data() + rowBegin, rowEnd - rowBegin };
+        for(std::size_t index = rowBegin; index < rowEnd; ++index) {
+            if(m_Page.changedBytes[index])
+                painter.fillRect(bytesX + static_cast<int>((index - rowBegin) * 3) * charWidth, y, 2 * charWidth, lineHeight(), changedByteColor);
+        }
+
+        // one drawText per protection run of the row
+        for(std::size_t index = rowBegin; index < rowEnd; ) {
+            const std::size_t runEnd = std::min(m_Page.mask->runEnd(index), rowEnd);
+            const auto colorIterator = protectionColors.find(m_Page.mask->type(index));
+            painter.setPen(colorIterator != protectionColors.end() ? colorIterator->second : palette().color(QPalette::Text));
+            painter.drawText(bytesX + static_cast<int>((index - rowBegin) * 3) * charWidth, y + ascent,
+                             QString::fromStdString(m_Page.mask->formatHex(rowBytes.subspan(index - rowBegin, runEnd - index), index)));
+            index = runEnd;
+        }
+
+        char charsRow[c_BytesInRow]{ };
+        Utilities::bytesToASCII(rowBytes.data(), rowBytes.size(), charsRow);
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(charsX, y + ascent, QString::fromLatin1(charsRow, static_cast<int>(rowBytes.size())));
+    }
+}
+
+void CHexView::resizeEvent(QResizeEvent* event) {
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBar();
+    refresh();
+}
+
+void CHexView::scrollContentsBy(int dx, int dy) {
+    m_FirstRow = static_cast<std::uint64_t>(verticalScrollBar()->value()) * m_RowsPerStep;
+    refresh();
+    emit visibleRangeChanged();
+}
+
+std::size_t CHexView::visibleRows() const {
+    return static_cast<std::size_t>(std::max(1, (viewport()->height() + lineHeight() - 1) / lineHeight()));
+}
+
+std::uint64_t CHexView::totalRows() const {
+    return (m_RangeSize + c_BytesInRow - 1) / c_BytesInRow;
+}
+
+int CHexView::lineHeight() const {
+    return std::max(1, fontMetrics().height());
+}
+
+void CHexView::updateScrollBar() {
+    const std::uint64_t fullyVisibleRows = std::max<std::uint64_t>(1, viewport()->height() / lineHeight());
+    const std::uint64_t maxFirstRow = totalRows() > fullyVisibleRows ? totalRows() - fullyVisibleRows : 0;
+    m_RowsPerStep = maxFirstRow / INT_MAX + 1;
+
+    verticalScrollBar()->setRange(0, static_cast<int>(maxFirstRow / m_RowsPerStep));
+    verticalScrollBar()->setPageStep(static_cast<int>(std::max<std::uint64_t>(1, fullyVisibleRows / m_RowsPerStep)));
+    verticalScrollBar()->setSingleStep(1);
+}
+
+void CHexView::resetBuffer() {
+    m_Page = { };
+}
+
+QString CHexView::formatLocation(std::uint64_t address) const {
+    char locationBuffer[32]{ };
+    if(m_IsOffsetRelative) {
+        const std::int64_t currentOffset = static_cast<std::int64_t>(address - m_Origin);
+        if(currentOffset < 0)
+            sprintf_s(locationBuffer, "-%04llx:", static_cast<unsigned long long>(-currentOffset));
+        else
+            sprintf_s(locationBuffer, "%05llx:", static_cast<unsigned long long>(currentOffset));
+    } else { // abs format
+        sprintf_s(locationBuffer, "%llx: ", static_cast<unsigned long long>(address));
+    }
+    return QString(locationBuffer);
+}
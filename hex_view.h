@@ -0,0 +1,113 @@
+#pragma once
+#include <QAbstractScrollArea>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include "process.h"
+
+// visible rows of one read, filled on the CHexViewReader thread
+struct CHexViewPage {
+    std::uint64_t address{ };
+    std::vector<std::uint8_t> bytes{ };
+    std::unique_ptr<CBytesProtectionMaskFormattablePlain> mask{ };
+    MBIEx region{ }; // region of the first byte
+    std::vector<bool> changedBytes{ }; // against the page shown before, filled by CHexViewReader::take
+    std::uint64_t generation{ };
+    std::chrono::microseconds cost{ };
+    bool isScheduled{ }; // requested by a periodic refresh rather than by scrolling or a new range
+};
+
+// Reads pages for CHexView on its own thread. Two pages are swapped between the threads: the view paints one while the
+// reader fills the other, and a completed page waits until the view takes it. Only the newest request is kept, so
+// requests made faster than reads complete replace each other instead of queueing up
+class CHexViewReader : public QObject {
+    Q_OBJECT
+public:
+    explicit CHexViewReader(QObject* parent = nullptr);
+    ~CHexViewReader();
+
+    void request(std::weak_ptr<IProcessIO> process, std::uint64_t address, std::size_t size, std::uint64_t generation, bool isScheduled);
+    // drops the pending request without waiting for a running read, take() drops its page by the generation
+    void cancel();
+    // Swaps the completed page into page unless it is older than minimumGeneration, then the reader may start the next read
+    // @return Returns true when page was replaced
+    bool take(CHexViewPage& page, std::uint64_t minimumGeneration);
+signals:
+    // emitted on the reader thread, connections to the view are queued
+    void pageCompleted();
+private:
+    struct CRequest {
+        std::weak_ptr<IProcessIO> process{ };
+        std::uint64_t address{ };
+        std::size_t size{ };
+        std::uint64_t generation{ };
+        bool isScheduled{ };
+    };
+
+    void readPages();
+
+    std::mutex m_Mutex{ };
+    std::condition_variable m_Condition{ };
+    std::optional<CRequest> m_Request{ };
+    CHexViewPage m_Page{ }; // the back page, owned by the reader thread unless m_IsCompleted
+    bool m_IsCompleted{ }, m_IsStopping{ };
+    std::thread m_ReaderThread{ };
+};
+
+// Custom painted hex view over an address range of a process. Only the rows inside the viewport are read and drawn,
+// so the cost of a refresh depends on the viewport size and not on the size of the range
+class CHexView : public QAbstractScrollArea {
+    Q_OBJECT
+public:
+    explicit CHexView(QWidget* parent = nullptr);
+    ~CHexView() = default;
+
+    void setProcess(std::weak_ptr<IProcessIO> process);
+    // range spanned by the scrollbar, origin is the address relative locations are counted from
+    void setRange(std::uint64_t baseAddress, std::uint64_t size, std::uint64_t origin);
+    void scrollToAddress(std::uint64_t address);
+    void setOffsetRelative(bool isRelative);
+    void clear();
+
+    // requests the visible rows from the reader thread, the rows which changed since the previous page are repainted once it arrives.
+    // isScheduled marks the periodic refreshes, it comes back with pageShown
+    void refresh(bool isScheduled = false);
+
+    std::uint64_t origin() const;
+    std::uint64_t firstVisibleAddress() const;
+    // region of the first row on screen, as of the last completed read
+    const MBIEx& firstVisibleRegion() const;
+    bool isEmpty() const;
+signals:
+    void visibleRangeChanged();
+    // a page was read and shown, cost is the duration of the read on the reader thread
+    void pageShown(qint64 costMicroseconds, bool isScheduled);
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void scrollContentsBy(int dx, int dy) override;
+private:
+    static constexpr std::size_t c_BytesInRow{ 8 };
+    static constexpr int c_LocationColumnChars{ 14 };
+
+    std::size_t visibleRows() const;
+    std::uint64_t totalRows() const;
+    int lineHeight() const;
+    void updateScrollBar();
+    void resetBuffer();
+    void onPageCompleted();
+    QString formatLocation(std::uint64_t address) const;
+private:
+    std::weak_ptr<IProcessIO> m_Process{ };
+
+    std::uint64_t m_RangeBase{ }, m_RangeSize{ }, m_Origin{ };
+    std::uint64_t m_FirstRow{ };
+    std::uint64_t m_RowsPerStep{ 1 }; // QScrollBar is limited to int, ranges with more rows scroll in steps
+    bool m_IsOffsetRelative{ true };
+
+    // bumped whenever the process or the range changes, pages requested before are dropped
+    std::uint64_t m_Generation{ };
+    CHexViewReader* m_Reader;
+    // the front page, what is on screen
+    CHexViewPage m_Page{ };
+};
@@ -0,0 +1,254 @@
+#include "memory_diff.h"
+#include <algorithm>
+#include <bit>
+
+namespace {
+constexpr std::uint64_t c_Prime1{ 0x9e3779b185ebca87ull }, c_Prime2{ 0xc2b2ae3d27d4eb4full }, c_Prime3{ 0x165667b19e3779f9ull };
+
+std::uint64_t loadWord(const std::uint8_t* data) {
+    std::uint64_t word{ };
+    memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+std::uint64_t hashRound(std::uint64_t lane, std::uint64_t word) {
+    return std::rotl(lane + word * c_Prime2, 31) * c_Prime1;
+}
+}
+
+CMemoryDiff::CMemoryDiff(std::weak_ptr<IProcessIO> targetProcess)
+    : m_TargetProcess{ targetProcess } { }
+
+void CMemoryDiff::retainRange(std::uint64_t address, std::uint64_t size) {
+    if(!size)
+        return;
+
+    const std::uint64_t start = address & ~(c_PageSize - 1);
+    const std::uint64_t end = (address + size + c_PageSize - 1) & ~(c_PageSize - 1);
+    m_RetainedRanges.push_back({ start, end - start });
+    std::sort(m_RetainedRanges.begin(), m_RetainedRanges.end());
+
+    // overlapping and adjacent ranges are merged, so no page is retained (and no byte reported) twice
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> merged{ };
+    for(const auto& [rangeAddress, rangeSize] : m_RetainedRanges) {
+        if(!merged.empty() && rangeAddress <= merged.back().first + merged.back().second)
+            merged.back().second = std::max(merged.back().first + merged.back().second, rangeAddress + rangeSize) - merged.back().first;
+        else
+            merged.push_back({ rangeAddress, rangeSize });
+    }
+    m_RetainedRanges = std::move(merged);
+}
+
+void CMemoryDiff::clearRetainedRanges() {
+    m_RetainedRanges.clear();
+}
+
+bool CMemoryDiff::capture() {
+    std::vector<CRegionHashes> regions{ };
+    std::vector<CRetainedPages> retained{ };
+    if(!hashRegions(regions, &retained))
+        return false;
+
+    m_Capture = std::move(regions);
+    m_RetainedPages = std::move(retained);
+    m_HasCapture = true;
+    return true;
+}
+
+bool CMemoryDiff::diff(CMemoryDiffResult& result) {
+    if(!m_HasCapture)
+        return false;
+
+    std::vector<CRegionHashes> regions{ };
+    if(!hashRegions(regions, std::nullptr_t()))
+        return false;
+
+    // both lists are sorted by address, regions are matched by their base address
+    result = { };
+    auto before = m_Capture.begin();
+    auto after = regions.begin();
+    while(before != m_Capture.end() || after != regions.end()) {
+        if(after == regions.end() || (before != m_Capture.end() && before->region.address < after->region.address)) {
+            result.removedRegions.push_back((before++)->region);
+            continue;
+        }
+        if(before == m_Capture.end() || after->region.address < before->region.address) {
+            result.addedRegions.push_back((after++)->region);
+            continue;
+        }
+
+        if(before->region.size != after->region.size) {
+            result.removedRegions.push_back(before->region);
+            result.addedRegions.push_back(after->region);
+        }
+        comparePages(*before++, *after++, result.changedPages);
+    }
+
+    compareRetained(result.changedPages, result.changedBytes);
+    return true;
+}
+
+bool CMemoryDiff::hasCapture() const {
+    return m_HasCapture;
+}
+
+std::uint64_t CMemoryDiff::capturedPages() const {
+    std::uint64_t pages{ };
+    for(const auto& region : m_Capture) {
+        pages += region.pageHashes.size();
+    }
+    return pages;
+}
+
+void CMemoryDiff::cancel() {
+    m_IsCancelled = true;
+}
+
+float CMemoryDiff::progress() const {
+    const std::size_t totalTasks = m_TotalTasks;
+    return totalTasks ? static_cast<float>(m_CompletedTasks) / static_cast<float>(totalTasks) : 0.f;
+}
+
+std::uint64_t CMemoryDiff::hashPage(const std::uint8_t* page) {
+    // xxHash64 style rounds over 4 independent lanes, so the multiplies of neighbouring words overlap
+    std::uint64_t lanes[4]{ c_Prime1 + c_Prime2, c_Prime2, 0, 0 - c_Prime1 };
+    for(std::uint64_t offset = 0; offset < c_PageSize; offset += 32) {
+        lanes[0] = hashRound(lanes[0], loadWord(page + offset));
+        lanes[1] = hashRound(lanes[1], loadWord(page + offset + 8));
+        lanes[2] = hashRound(lanes[2], loadWord(page + offset + 16));
+        lanes[3] = hashRound(lanes[3], loadWord(page + offset + 24));
+    }
+
+    std::uint64_t hash = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+    hash ^= hash >> 33;
+    hash *= c_Prime2;
+    hash ^= hash >> 29;
+    hash *= c_Prime3;
+    hash ^= hash >> 32;
+    return hash == c_UnreadablePage ? 1 : hash;
+}
+
+bool CMemoryDiff::hashRegions(std::vector<CRegionHashes>& regions, std::vector<CRetainedPages>* retained) {
+    auto process = m_TargetProcess.lock();
+    if(!process)
+        return false;
+
+    m_IsCancelled = false;
+    m_CompletedTasks = { };
+
+    for(const auto& region : process->regions()) {
+        if(region.State != MEM_COMMIT || !region.Protect || region.Protect & (PAGE_NOACCESS | PAGE_GUARD))
+            continue;
+
+        CRegionHashes regionHashes{ };
+        regionHashes.region = { reinterpret_cast<std::uint64_t>(region.BaseAddress), region.RegionSize, region.Protect };
+        regionHashes.pageHashes.resize(region.RegionSize / c_PageSize, c_UnreadablePage);
+        regions.push_back(std::move(regionHashes));
+    }
+
+    if(retained) {
+        for(const auto& [address, size] : m_RetainedRanges) {
+            retained->push_back({ address, std::vector<std::uint8_t>(size, 0), std::vector<std::uint8_t>(size / c_PageSize, false) });
+        }
+    }
+
+    struct CChunk {
+        std::size_t region{ };
+        std::uint64_t offset{ }; // from the region start, page aligned
+        std::uint64_t size{ };
+    };
+    std::vector<CChunk> chunks{ };
+    for(std::size_t i = 0; i < regions.size(); ++i) {
+        const std::uint64_t regionSize = regions[i].pageHashes.size() * c_PageSize;
+        for(std::uint64_t offset = 0; offset < regionSize; offset += c_ChunkSize) {
+            chunks.push_back({ i, offset, std::min(c_ChunkSize, regionSize - offset) });
+        }
+    }
+    m_TotalTasks = chunks.size();
+
+    // every chunk writes its own hashes and its own part of the retained pages, nothing is shared between them
+    Utilities::parallelFor(chunks.size(), [&](std::size_t i) -> void {
+        if(m_IsCancelled)
+            return;
+
+        const auto& chunk = chunks[i];
+        auto& region = regions[chunk.region];
+        const std::uint64_t chunkAddress = region.region.address + chunk.offset;
+        std::vector<std::uint8_t> buffer(chunk.size);
+        const auto available = process->readAvailable(chunkAddress, static_cast<std::uint32_t>(chunk.size), buffer.data());
+        for(const auto& [offset, size] : available) {
+            // readAvailable works in whole pages, offset and size are page aligned
+            for(std::size_t pageOffset = offset; pageOffset < offset + size; pageOffset += c_PageSize) {
+                region.pageHashes[(chunk.offset + pageOffset) / c_PageSize] = hashPage(buffer.data() + pageOffset);
+            }
+
+            if(!retained)
+                continue;
+            for(auto& retainedPages : *retained) {
+                const std::uint64_t start = std::max(retainedPages.address, chunkAddress + offset);
+                const std::uint64_t end = std::min(retainedPages.address + retainedPages.data.size(), chunkAddress + offset + size);
+                if(start >= end)
+                    continue;
+
+                memcpy(retainedPages.data.data() + (start - retainedPages.address), buffer.data() + (start - chunkAddress), end - start);
+                std::fill(retainedPages.isPageReadable.begin() + (start - retainedPages.address) / c_PageSize,
+                          retainedPages.isPageReadable.begin() + (end - retainedPages.address) / c_PageSize, true);
+            }
+        }
+        ++m_CompletedTasks;
+    });
+
+    return !m_IsCancelled;
+}
+
+void CMemoryDiff::comparePages(const CRegionHashes& before, const CRegionHashes& after, std::vector<std::uint64_t>& changedPages) const {
+    const std::size_t pages = std::min(before.pageHashes.size(), after.pageHashes.size());
+    for(std::size_t i = 0; i < pages; ++i) {
+        if(before.pageHashes[i] != after.pageHashes[i])
+            changedPages.push_back(after.region.address + i * c_PageSize);
+    }
+}
+
+void CMemoryDiff::compareRetained(const std::vector<std::uint64_t>& changedPages, std::vector<CDiffBytes>& changedBytes) const {
+    auto process = m_TargetProcess.lock();
+    if(!process)
+        return;
+
+    std::vector<std::uint8_t> page(c_PageSize);
+    for(const auto& retainedPages : m_RetainedPages) {
+        const std::uint64_t retainedEnd = retainedPages.address + retainedPages.data.size();
+        auto changedPage = std::lower_bound(changedPages.begin(), changedPages.end(), retainedPages.address);
+        for(; changedPage != changedPages.end() && *changedPage < retainedEnd; ++changedPage) {
+            // pages unreadable at either moment have no bytes to compare, they are only listed in changedPages
+            if(!retainedPages.isPageReadable[(*changedPage - retainedPages.address) / c_PageSize])
+                continue;
+            // only the few changed pages are read again, the rest of the range is known to be equal
+            if(!process->readToBuffer(*changedPage, static_cast<std::uint32_t>(c_PageSize), page.data()))
+                continue;
+
+            const std::uint8_t* previous = retainedPages.data.data() + (*changedPage - retainedPages.address);
+            for(std::size_t i = 0; i < c_PageSize; ) {
+                if(previous[i] == page[i]) {
+                    ++i;
+                    continue;
+                }
+
+                std::size_t runEnd = i;
+                while(runEnd < c_PageSize && previous[runEnd] != page[runEnd]) {
+                    ++runEnd;
+                }
+
+                // runs touching the end of the previous page continue it
+                const std::uint64_t runAddress = *changedPage + i;
+                if(!changedBytes.empty() && changedBytes.back().address + changedBytes.back().after.size() == runAddress) {
+                    changedBytes.back().before.insert(changedBytes.back().before.end(), previous + i, previous + runEnd);
+                    changedBytes.back().after.insert(changedBytes.back().after.end(), page.begin() + i, page.begin() + runEnd);
+                }
+                else {
+                    changedBytes.push_back({ runAddress, { previous + i, previous + runEnd }, { page.begin() + i, page.begin() + runEnd } });
+                }
+                i = runEnd;
+            }
+        }
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "process.h"
+#include <atomic>
+
+struct CDiffRegion {
+    std::uint64_t address{ };
+    std::uint64_t size{ };
+    std::uint32_t protect{ };
+};
+
+// a run of bytes which differ between the capture and the diff
+struct CDiffBytes {
+    std::uint64_t address{ };
+    std::vector<std::uint8_t> before{ }, after{ };
+};
+
+struct CMemoryDiffResult {
+    // a region which kept its base address but changed its size is reported as removed and added
+    std::vector<CDiffRegion> addedRegions{ }, removedRegions{ };
+    std::vector<std::uint64_t> changedPages{ }; // ascending page addresses
+    std::vector<CDiffBytes> changedBytes{ }; // only inside retained ranges and pages readable at both moments, ascending
+};
+
+// Compares the state of a process at two moments. capture() keeps an 8 byte hash per page of every committed readable
+// region, diff() hashes the process again and reports what changed. Regions are split into chunks which are read and
+// hashed on all cores. Pages of retained ranges are also copied by capture() so their changes can be shown byte by byte
+class CMemoryDiff {
+public:
+    CMemoryDiff(std::weak_ptr<IProcessIO> targetProcess);
+    ~CMemoryDiff() = default;
+
+    // takes effect on the next capture(), the range is extended to whole pages and merged with overlapping or adjacent ones
+    void retainRange(std::uint64_t address, std::uint64_t size);
+    void clearRetainedRanges();
+
+    // @return Returns false when the process is gone or the capture was cancelled, the previous capture is kept then
+    bool capture();
+    // @return Returns false when there is no capture, the process is gone or the diff was cancelled
+    bool diff(CMemoryDiffResult& result);
+
+    bool hasCapture() const;
+    std::uint64_t capturedPages() const;
+
+    // both are safe to call from other threads while capture() or diff() runs
+    void cancel();
+    float progress() const;
+
+    static constexpr std::uint64_t c_PageSize{ 0x1000 };
+    // page hashes never take this value, it marks pages which could not be read
+    static constexpr std::uint64_t c_UnreadablePage{ 0 };
+    static std::uint64_t hashPage(const std::uint8_t* page);
+private:
+    struct CRegionHashes {
+        CDiffRegion region{ };
+        std::vector<std::uint64_t> pageHashes{ };
+    };
+
+    struct CRetainedPages {
+        std::uint64_t address{ }; // page aligned
+        std::vector<std::uint8_t> data{ };
+        std::vector<std::uint8_t> isPageReadable{ }; // per page, bytes so chunks on different threads never share an element
+    };
+
+    static constexpr std::uint64_t c_ChunkSize{ 0x100000 };
+
+    // retained: pages of m_RetainedRanges are copied there, nullptr skips the copying
+    bool hashRegions(std::vector<CRegionHashes>& regions, std::vector<CRetainedPages>* retained);
+    void comparePages(const CRegionHashes& before, const CRegionHashes& after, std::vector<std::uint64_t>& changedPages) const;
+    void compareRetained(const std::vector<std::uint64_t>& changedPages, std::vector<CDiffBytes>& changedBytes) const;
+private:
+    std::weak_ptr<IProcessIO> m_TargetProcess;
+
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> m_RetainedRanges{ };
+    std::vector<CRegionHashes> m_Capture{ };
+    std::vector<CRetainedPages> m_RetainedPages{ };
+    bool m_HasCapture{ };
+
+    std::atomic<bool> m_IsCancelled{ };
+    std::atomic<std::size_t> m_CompletedTasks{ }, m_TotalTasks{ };
+};
@@ -0,0 +1,224 @@
+#include "metrics.h"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <mutex>
+#include <cstdio>
+
+#ifdef MEMOBSERVER_METRICS
+namespace {
+constexpr std::size_t c_MetricCount{ static_cast<std::size_t>(TMetric::Count) };
+// four buckets per power of two, so a percentile is off by at most 25% of its value
+constexpr std::size_t c_BucketCount{ 252 };
+
+std::size_t bucketIndex(std::uint64_t nanoseconds) {
+    if(nanoseconds < 4)
+        return static_cast<std::size_t>(nanoseconds);
+
+    const std::size_t exponent = std::bit_width(nanoseconds) - 1;
+    return 4 * (exponent - 1) + ((nanoseconds >> (exponent - 2)) & 3);
+}
+
+// middle of the bucket's range
+std::uint64_t bucketValue(std::size_t index) {
+    if(index < 4)
+        return index;
+
+    const std::size_t exponent = index / 4 + 1;
+    const std::uint64_t lower = (4 + index % 4) << (exponent - 2);
+    return lower + (1ull << (exponent - 2)) / 2;
+}
+
+// Written by one thread only, so a relaxed load and store replace fetch_add. Other threads read it concurrently and
+// may see a count one call behind, which summaries tolerate
+class CCounter {
+public:
+    void add(std::uint64_t value) {
+        m_Value.store(m_Value.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+    std::uint64_t value() const {
+        return m_Value.load(std::memory_order_relaxed);
+    }
+private:
+    std::atomic<std::uint64_t> m_Value{ };
+};
+
+struct CThreadMetrics {
+    struct CCounters {
+        CCounter calls{ }, failures{ }, bytes{ }, nanoseconds{ };
+        std::array<CCounter, c_BucketCount> buckets{ };
+    };
+    std::array<CCounters, c_MetricCount> counters{ };
+};
+
+// Blocks are never freed: a block of an exited thread goes back to the free list and the next new thread continues its
+// counts, so short-lived worker threads (Utilities::parallelFor) do not grow the registry
+class CMetricsRegistry {
+public:
+    static CMetricsRegistry& instance() {
+        static CMetricsRegistry registry{ };
+        return registry;
+    }
+
+    CThreadMetrics* acquire() {
+        std::scoped_lock lock{ m_Mutex };
+        if(!m_FreeBlocks.empty()) {
+            CThreadMetrics* block = m_FreeBlocks.back();
+            m_FreeBlocks.pop_back();
+            return block;
+        }
+        return m_Blocks.emplace_back(std::make_unique<CThreadMetrics>()).get();
+    }
+    void release(CThreadMetrics* block) {
+        std::scoped_lock lock{ m_Mutex };
+        m_FreeBlocks.push_back(block);
+    }
+
+    template<typename F>
+    void forEachBlock(F&& function) {
+        std::scoped_lock lock{ m_Mutex };
+        for(const auto& block : m_Blocks) {
+            function(*block);
+        }
+    }
+private:
+    std::mutex m_Mutex{ };
+    std::vector<std::unique_ptr<CThreadMetrics>> m_Blocks{ };
+    std::vector<CThreadMetrics*> m_FreeBlocks{ };
+};
+
+// the registry lock is only taken on a thread's first record() and on its exit
+class CThreadMetricsLease {
+public:
+    CThreadMetricsLease()
+        : m_Block{ CMetricsRegistry::instance().acquire() } { }
+    ~CThreadMetricsLease() {
+        CMetricsRegistry::instance().release(m_Block);
+    }
+
+    CThreadMetrics& block() {
+        return *m_Block;
+    }
+private:
+    CThreadMetrics* m_Block;
+};
+
+std::uint64_t percentile(const std::array<std::uint64_t, c_BucketCount>& buckets, std::uint64_t count, double fraction) {
+    if(!count)
+        return { };
+
+    const std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(static_cast<double>(count) * fraction + 0.5));
+    std::uint64_t seen{ };
+    for(std::size_t i = 0; i < c_BucketCount; ++i) {
+        seen += buckets[i];
+        if(seen >= rank)
+            return bucketValue(i);
+    }
+    return bucketValue(c_BucketCount - 1);
+}
+}
+
+void CMetrics::record(TMetric metric, std::uint64_t bytes, std::uint64_t nanoseconds, bool isSuccessful) {
+    // the registry is a function local static, so it outlives the leases of threads which exit during shutdown
+    CMetricsRegistry::instance();
+    thread_local CThreadMetricsLease lease{ };
+
+    auto& counters = lease.block().counters[static_cast<std::size_t>(metric)];
+    counters.calls.add(1);
+    if(isSuccessful)
+        counters.bytes.add(bytes);
+    else
+        counters.failures.add(1);
+    counters.nanoseconds.add(nanoseconds);
+    counters.buckets[bucketIndex(nanoseconds)].add(1);
+}
+
+std::vector<CMetricSummary> CMetrics::summaries() {
+    std::vector<CMetricSummary> summaries(c_MetricCount);
+    std::vector<std::array<std::uint64_t, c_BucketCount>> buckets(c_MetricCount);
+    CMetricsRegistry::instance().forEachBlock([&](const CThreadMetrics& block) -> void {
+        for(std::size_t i = 0; i < c_MetricCount; ++i) {
+            const auto& counters = block.counters[i];
+            summaries[i].calls += counters.calls.value();
+            summaries[i].failures += counters.failures.value();
+            summaries[i].bytes += counters.bytes.value();
+            summaries[i].totalNanoseconds += counters.nanoseconds.value();
+            for(std::size_t j = 0; j < c_BucketCount; ++j) {
+                buckets[i][j] += counters.buckets[j].value();
+            }
+        }
+    });
+
+    for(std::size_t i = 0; i < c_MetricCount; ++i) {
+        // the bucket total rather than calls, the two may differ by in-flight records
+        std::uint64_t count{ };
+        for(const std::uint64_t bucket : buckets[i]) {
+            count += bucket;
+        }
+        summaries[i].metric = static_cast<TMetric>(i);
+        summaries[i].p50Nanoseconds = percentile(buckets[i], count, 0.5);
+        summaries[i].p99Nanoseconds = percentile(buckets[i], count, 0.99);
+    }
+    return summaries;
+}
+#endif
+
+const char* CMetrics::name(TMetric metric) {
+    switch(metric) {
+    case TMetric::ReadToBuffer: return "readToBuffer";
+    case TMetric::WriteFromBuffer: return "writeFromBuffer";
+    case TMetric::Query: return "query";
+    case TMetric::Protect: return "protect";
+    case TMetric::ReadPages: return "readPages";
+    case TMetric::ModuleListRefresh: return "moduleListRefresh";
+    case TMetric::Dump: return "dump";
+    default: return "unknown";
+    }
+}
+
+std::string CMetrics::json() {
+    std::string json{ c_IsEnabled ? "{\"enabled\":true,\"metrics\":[" : "{\"enabled\":false,\"metrics\":[" };
+    bool isFirst{ true };
+    for(const auto& summary : summaries()) {
+        char buffer[320]{ };
+        snprintf(buffer, sizeof(buffer), "%s{\"name\":\"%s\",\"calls\":%llu,\"failures\":%llu,\"bytes\":%llu,\"total_ns\":%llu,\"p50_ns\":%llu,\"p99_ns\":%llu}",
+                 isFirst ? "" : ",", name(summary.metric), static_cast<unsigned long long>(summary.calls),
+                 static_cast<unsigned long long>(summary.failures), static_cast<unsigned long long>(summary.bytes),
+                 static_cast<unsigned long long>(summary.totalNanoseconds), static_cast<unsigned long long>(summary.p50Nanoseconds),
+                 static_cast<unsigned long long>(summary.p99Nanoseconds));
+        json += buffer;
+        isFirst = false;
+    }
+    return json + "]}";
+}
+
+namespace {
+std::string formatDuration(std::uint64_t nanoseconds) {
+    char buffer[32]{ };
+    if(nanoseconds < 1000)
+        snprintf(buffer, sizeof(buffer), "%lluns", static_cast<unsigned long long>(nanoseconds));
+    else if(nanoseconds < 1000000)
+        snprintf(buffer, sizeof(buffer), "%.1fus", static_cast<double>(nanoseconds) / 1e3);
+    else
+        snprintf(buffer, sizeof(buffer), "%.1fms", static_cast<double>(nanoseconds) / 1e6);
+    return buffer;
+}
+}
+
+std::string CMetrics::statusText() {
+    std::string text{ };
+    for(const auto& summary : summaries()) {
+        if(!summary.calls)
+            continue;
+
+        if(!text.empty())
+            text += " | ";
+        text += std::string(name(summary.metric)) + " " + std::to_string(summary.calls);
+        if(summary.failures)
+            text += " (" + std::to_string(summary.failures) + " failed)";
+        text += " p50 " + formatDuration(summary.p50Nanoseconds) + " p99 " + formatDuration(summary.p99Nanoseconds);
+    }
+    return text;
+}
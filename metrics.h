@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <chrono>
+
+// operations CMetrics keeps counters and latency histograms for
+enum class TMetric {
+    ReadToBuffer,
+    WriteFromBuffer,
+    Query,
+    Protect,
+    ReadPages,
+    ModuleListRefresh,
+    Dump,
+    Count,
+};
+
+// counters of one operation summed over all threads, latencies are estimated from the histogram buckets
+struct CMetricSummary {
+    TMetric metric{ };
+    std::uint64_t calls{ }, failures{ }, bytes{ };
+    std::uint64_t totalNanoseconds{ }, p50Nanoseconds{ }, p99Nanoseconds{ };
+};
+
+// Hot-path instrumentation. Every thread records into its own block of counters, so record() takes no lock and does no
+// atomic read-modify-write; readers sum the blocks of all threads. Built only with MEMOBSERVER_METRICS, otherwise every
+// call below is an empty inline function
+class CMetrics final {
+public:
+#ifdef MEMOBSERVER_METRICS
+    static constexpr bool c_IsEnabled{ true };
+
+    // bytes are only counted for successful calls
+    static void record(TMetric metric, std::uint64_t bytes, std::uint64_t nanoseconds, bool isSuccessful);
+    // @return Returns one summary per operation, in TMetric order
+    static std::vector<CMetricSummary> summaries();
+#else
+    static constexpr bool c_IsEnabled{ false };
+
+    static void record(TMetric, std::uint64_t, std::uint64_t, bool) { }
+    static std::vector<CMetricSummary> summaries() { return { }; }
+#endif
+    static const char* name(TMetric metric);
+    // {"enabled":..,"metrics":[{"name","calls","failures","bytes","total_ns","p50_ns","p99_ns"}]}
+    static std::string json();
+    // one line for the status bar, operations which were never called are left out
+    static std::string statusText();
+};
+
+// Times the enclosing scope and records it on destruction. A scope which ends without succeeded() counts as a failure,
+// so early error returns need no extra code
+class CMetricScope final {
+public:
+#ifdef MEMOBSERVER_METRICS
+    CMetricScope(TMetric metric, std::uint64_t bytes = 0)
+        : m_Metric{ metric }, m_Bytes{ bytes }, m_Start{ std::chrono::steady_clock::now() } { }
+    ~CMetricScope() {
+        const auto elapsed = std::chrono::steady_clock::now() - m_Start;
+        CMetrics::record(m_Metric, m_Bytes, static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()), m_IsSuccessful);
+    }
+
+    // @return Returns isSuccessful, so it can wrap the returned expression
+    bool succeeded(bool isSuccessful = true) {
+        return m_IsSuccessful = isSuccessful;
+    }
+    void setBytes(std::uint64_t bytes) {
+        m_Bytes = bytes;
+    }
+#else
+    CMetricScope(TMetric, std::uint64_t = 0) { }
+
+    bool succeeded(bool isSuccessful = true) {
+        return isSuccessful;
+    }
+    void setBytes(std::uint64_t) { }
+#endif
+    CMetricScope(const CMetricScope&) = delete;
+    CMetricScope& operator=(const CMetricScope&) = delete;
+#ifdef MEMOBSERVER_METRICS
+private:
+    TMetric m_Metric;
+    std::uint64_t m_Bytes;
+    std::chrono::steady_clock::time_point m_Start;
+    bool m_IsSuccessful{ };
+#endif
+};
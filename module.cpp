@@ -1,7 +1,9 @@
 #include "module.h"
 #include "process.h"
 
+#ifdef _WIN32
 #include <TlHelp32.h>
+#endif
 
 CSection::CSection(std::uint64_t baseAddress, std::uint32_t size, char* tag, const IMAGE_SECTION_HEADER& header)
     : m_BaseAddress{ baseAddress }
@@ -60,31 +62,68 @@ CModule::CModule(const CModuleMemento& module, IProcessIO* process)
         throw std::runtime_error("m_ThisProcess can not be a nullptr");
 
     //printf("[CModule] Instantiated %s module\n", m_Memento.name().c_str());
-    parseSections();
 }
 
-const std::vector<CSection>& CModule::sections() const {
-    return m_Sections;
+void CModule::prefetchSections(std::span<const CModule> modules) {
+    std::vector<const CModule*> pending{ };
+    for(const auto& module : modules) {
+        if(!module.isParsed())
+            pending.push_back(&module);
+    }
+    if(pending.empty())
+        return;
+
+    // read into separate buffers, a module parsed lazily meanwhile must not see its headers overwritten
+    std::vector<std::vector<std::uint8_t>> headers(pending.size(), std::vector<std::uint8_t>(0x1000, 0));
+    std::vector<CReadRequest> requests(pending.size());
+    for(std::size_t i = 0; i < pending.size(); ++i) {
+        requests[i] = { std::get<0>(pending[i]->memento().info()), static_cast<std::uint32_t>(headers[i].size()), headers[i].data() };
+    }
+    pending.front()->m_ThisProcess->readScatter(requests);
+
+    for(std::size_t i = 0; i < pending.size(); ++i) {
+        const CModule& module = *pending[i];
+        std::call_once(module.m_Parsed->parseFlag, [&]() -> void {
+            if(requests[i].isSuccessful) {
+                module.m_Parsed->headers = std::move(headers[i]);
+                module.parseSectionsFromHeaders();
+            }
+            module.m_Parsed->isParsed = true;
+        });
+    }
 }
 
-std::vector<std::uint8_t>& CModule::headers() {
-    return m_Headers;
+const std::vector<CSection>& CModule::sections() const {
+    parseSections();
+    return m_Parsed->sections;
 }
 
 const std::vector<std::uint8_t>& CModule::headers() const {
-    return m_Headers;
+    parseSections();
+    return m_Parsed->headers;
 }
 
-void CModule::parseSections() {
-    auto [baseAddress, size] = memento().info();
-    if(!m_ThisProcess->readToBuffer(baseAddress, 0x1000, m_Headers.data()))
-        return;
+bool CModule::isParsed() const {
+    return m_Parsed->isParsed;
+}
+
+void CModule::parseSections() const {
+    std::call_once(m_Parsed->parseFlag, [this]() -> void {
+        auto [baseAddress, size] = memento().info();
+        if(m_ThisProcess->readToBuffer(baseAddress, 0x1000, m_Parsed->headers.data()))
+            parseSectionsFromHeaders();
+        m_Parsed->isParsed = true;
+    });
+}
 
-    PIMAGE_DOS_HEADER dosHeader{ reinterpret_cast<PIMAGE_DOS_HEADER>(m_Headers.data()) };
+void CModule::parseSectionsFromHeaders() const {
+    auto [baseAddress, size] = memento().info();
+    auto& headers = m_Parsed->headers;
+    PIMAGE_DOS_HEADER dosHeader{ reinterpret_cast<PIMAGE_DOS_HEADER>(headers.data()) };
     if(dosHeader->e_magic != 0x5a4d) // MZ signature
         return;
 
-    PIMAGE_NT_HEADERS64 ntHeaders{ reinterpret_cast<PIMAGE_NT_HEADERS64>(m_Headers.data() + dosHeader->e_lfanew) };
+    PIMAGE_NT_HEADERS64 ntHeaders{ reinterpret_cast<PIMAGE_NT_HEADERS64>(headers.data() + dosHeader->e_lfanew) };
     if(ntHeaders->Signature != 0x4550) // PE signature
         return;
 
@@ -92,7 +131,7 @@ void CModule::parseSections() {
     for(int i = 0; i < ntHeaders->FileHeader.NumberOfSections; ++i) {
         IMAGE_SECTION_HEADER section = sections[i];
         std::uint64_t sectionBaseAddress = baseAddress + section.VirtualAddress;
-        m_Sections.emplace_back(sectionBaseAddress, section.Misc.VirtualSize, reinterpret_cast<char*>(section.Name), section);
+        m_Parsed->sections.emplace_back(sectionBaseAddress, section.Misc.VirtualSize, reinterpret_cast<char*>(section.Name), section);
     }
 }
 
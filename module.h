@@ -1,8 +1,12 @@
 #pragma once
 #include "utilities.h"
 
-#include <Windows.h>
+#include "platform.h"
 #include <vector>
+#include <span>
+#include <mutex>
+#include <atomic>
+#include <memory>
 
 class CSection {
 public:
@@ -46,19 +50,30 @@ class IProcessIO;
 
 class CModule {
 public:
-    // it should be created within a context of a IProcessIO
+    // it should be created within a context of a IProcessIO, headers are read on the first sections() or headers() call
     CModule(const CModuleMemento& module, IProcessIO* process);
     ~CModule() = default;
 public:
+    // parses modules which were not parsed yet, their headers are read with a single IProcessIO::readScatter.
+    // Modules must belong to one process, copies share the parsed headers so the originals are served as well
+    static void prefetchSections(std::span<const CModule> modules);
+
     const CModuleMemento& memento() const;
     const std::vector<CSection>& sections() const;
-    std::vector<std::uint8_t>& headers();
     const std::vector<std::uint8_t>& headers() const;
+    bool isParsed() const;
 private:
-    void parseSections();
+    struct CParsedHeaders {
+        std::once_flag parseFlag{ };
+        std::atomic<bool> isParsed{ };
+        std::vector<std::uint8_t> headers{ std::vector<std::uint8_t>(0x1000, 0) };
+        std::vector<CSection> sections{ };
+    };
+
+    void parseSections() const;
+    void parseSectionsFromHeaders() const;
 
     CModuleMemento m_Memento;
     IProcessIO* m_ThisProcess{ };
-    std::vector<std::uint8_t> m_Headers{ std::vector<std::uint8_t>(0x1000, 0) };
-    std::vector<CSection> m_Sections{ };
+    std::shared_ptr<CParsedHeaders> m_Parsed{ std::make_shared<CParsedHeaders>() };
 };
@@ -2,12 +2,17 @@
 #include "ui_module_list.h"
 #include "cmainwindow.h"
 #include "dumper.h"
+#include "snapshot.h"
+#include "signature_scanner.h"
 
 CModuleListWindow::CModuleListWindow(QWidget *parent, CSettingsWindow* settings, CProcessSelectorWindow* processSelector)
     : QDialog(parent)
     , ui(new Ui::CModuleListWindow)
     , m_Settings{ settings }
-    , m_ProcessSelector{ processSelector } {
+    , m_ProcessSelector{ processSelector }
+    , m_DumpQueue{ std::make_unique<CDumpQueue>() }
+    , m_DumpJobsTimer{ new QTimer(this) }
+    , m_ModulesRefreshTimer{ new QTimer(this) } {
     ui->setupUi(this);
 
     if(!qobject_cast<CMainWindow*>(this->parent())) // im not sure how qobject_cast works (if it works like dynamic_cast then it's ok)
@@ -28,14 +33,55 @@ void CModuleListWindow::connectSignals() {
 
     QObject::connect(m_ProcessSelector, &CProcessSelectorWindow::processAttached, this, &CModuleListWindow::onProcessAttach);
     QObject::connect(m_ProcessSelector, &CProcessSelectorWindow::processDetached, this, &CModuleListWindow::onProcessDetach);
+
+    QObject::connect(m_DumpJobsTimer, &QTimer::timeout, this, &CModuleListWindow::updateDumpJobs);
+    QObject::connect(m_ModulesRefreshTimer, &QTimer::timeout, this, &CModuleListWindow::on_modulesRefreshButton_clicked);
 }
 
 void CModuleListWindow::updateModuleList() {
     ui->moduleList->clear();
 
-    for(auto& module : m_ProcessSelector->selectedProcess()->moduleList().lock()->data()) {
+    const auto moduleList = m_ProcessSelector->selectedProcess()->moduleList().lock();
+    for(auto& module : moduleList->data()) {
         ui->moduleList->addItem(QString(module.memento().format().c_str()));
     }
+
+    // sections are usually viewed right after the list, have their headers ready by then
+    moduleList->prefetchSections();
+}
+
+void CModuleListWindow::updateModuleList(const CListChanges& changes) {
+    if(changes.isReordered) {
+        updateModuleList();
+        selectModule(-1);
+        return;
+    }
+    if(changes.isEmpty())
+        return;
+
+    const bool isSelectedRemoved = std::find(changes.removedRows.begin(), changes.removedRows.end(), static_cast<std::size_t>(m_SelectedModule)) != changes.removedRows.end();
+
+    // rows shift while they are removed and inserted, currentRowChanged must not select by those rows
+    const auto moduleList = m_ProcessSelector->selectedProcess()->moduleList().lock();
+    ui->moduleList->blockSignals(true);
+    for(auto row : changes.removedRows) {
+        delete ui->moduleList->takeItem(static_cast<int>(row));
+    }
+    for(auto row : changes.addedRows) {
+        ui->moduleList->insertItem(static_cast<int>(row), QString(moduleList->data()[row].memento().format().c_str()));
+    }
+
+    if(isSelectedRemoved)
+        ui->moduleList->setCurrentRow(-1);
+    ui->moduleList->blockSignals(false);
+
+    // a kept module moves along with its row, its sections are still valid
+    if(isSelectedRemoved)
+        selectModule(-1);
+    else
+        m_SelectedModule = ui->moduleList->currentRow();
+
+    moduleList->prefetchSections();
 }
 
 void CModuleListWindow::onProcessAttach() {
@@ -46,11 +92,15 @@ void CModuleListWindow::onProcessAttach() {
 }
 
 void CModuleListWindow::onProcessDetach() {
+    // queued jobs would dump the next attached process at the addresses of this one
+    m_DumpQueue->cancelAll();
+
     ui->sectionList->clear();
     selectSection(-1);
 
     updateSectionDumpLastLabel();
     updateModuleDumpLastLabel();
+    updateSignatureScanLastLabel();
 
     ui->moduleList->clear();
     selectModule(-1);
@@ -110,9 +160,18 @@ void CModuleListWindow::on_modulesRefreshButton_clicked() {
     if(m_ProcessSelector->selectedProcess()->moduleList().expired())
         throw std::runtime_error("Expired std::weak_ptr<CModuleList>, this should not happen");
 
-    m_ProcessSelector->selectedProcess()->moduleList().lock()->refresh();
-    updateModuleList();
-    selectModule(-1);
+    const auto moduleList = m_ProcessSelector->selectedProcess()->moduleList().lock();
+    moduleList->setSortType(m_Settings->moduleListSortType());
+    moduleList->setRetrieveMethod(m_Settings->moduleListRetrieveMethod());
+    updateModuleList(moduleList->refresh());
+}
+
+void CModuleListWindow::on_modulesAutoRefreshCheckBox_toggled(bool checked) {
+    // an unchanged module list costs one enumeration and no row updates
+    if(checked)
+        m_ModulesRefreshTimer->start(c_ModulesRefreshInterval);
+    else
+        m_ModulesRefreshTimer->stop();
 }
 
 void CModuleListWindow::updateSectionInfoLines() {
@@ -135,6 +194,10 @@ void CModuleListWindow::updateModuleDumpLastLabel(const QString& message) {
     ui->dumpModuleLastMessageLabel->setText(message);
 }
 
+void CModuleListWindow::updateSignatureScanLastLabel(const QString& message) {
+    ui->signatureScanLastMessageLabel->setText(message);
+}
+
 void CModuleListWindow::updateModuleInfoLines() {
     ui->sectionList->clear();
 
@@ -200,23 +263,18 @@ void CModuleListWindow::on_dumpSectionButton_clicked() {
         return;
     }
 
-    const auto dumpBuffer = CSectionDumper(m_ProcessSelector->selectedProcess(), baseAddress, size).dump();
     const auto dumpPath =
         Utilities::generatePathForDump(
             m_ProcessSelector->selectedProcess()->memento().name(),
             m_ProcessSelector->selectedProcess()->moduleList().lock()->data()[m_SelectedModule].memento().name(),
+            baseAddress,
             selectedSection.tag()
             );
 
-    if(std::filesystem::exists(dumpPath)) {
-        updateSectionDumpLastLabel("File with the name of the dump already exist, delete it manually to proceed");
-        return;
-    }
-
-    std::ofstream outFile(dumpPath, std::ios::trunc | std::ios::binary);
-    outFile.write(reinterpret_cast<const char*>(dumpBuffer.data()), dumpBuffer.size());
-    updateSectionDumpLastLabel("Dumped successfully");
-    updateMainWindowStatusBar("Saved to " + QString(dumpPath.c_str()));
+    m_DumpQueue->enqueue(std::make_unique<CSectionDumper>(m_ProcessSelector->selectedProcess(), baseAddress, size), selectedSection.tag(), dumpPath);
+    m_DumpJobsTimer->start(100);
+    updateDumpJobs();
+    updateSectionDumpLastLabel("Queued");
 }
 
 void CModuleListWindow::on_dumpModuleButton_clicked() {
@@ -232,23 +290,97 @@ void CModuleListWindow::on_dumpModuleButton_clicked() {
         return;
     }
 
-    const auto dumpBuffer = CModuleDumper(m_ProcessSelector->selectedProcess(), baseAddress).dump();
+    enqueueModuleDump(module);
+    updateModuleDumpLastLabel("Queued");
+}
+
+void CModuleListWindow::on_dumpAllModulesButton_clicked() {
+    if(!m_ProcessSelector->selectedProcess()) {
+        updateModuleDumpLastLabel("You must select a process you want to dump");
+        return;
+    }
+
+    for(const auto& module : m_ProcessSelector->selectedProcess()->moduleList().lock()->data()) {
+        enqueueModuleDump(module);
+    }
+    updateModuleDumpLastLabel("Queued all modules");
+}
+
+void CModuleListWindow::on_snapshotProcessButton_clicked() {
+    if(!m_ProcessSelector->selectedProcess()) {
+        updateModuleDumpLastLabel("You must select a process you want to snapshot");
+        return;
+    }
+
+    const std::uint64_t bytesPerSecond = static_cast<std::uint64_t>(ui->snapshotThrottleSpinBox->value()) << 20;
+    const auto& processName = m_ProcessSelector->selectedProcess()->memento().name();
+    m_DumpQueue->enqueue(std::make_unique<CSnapshotDumper>(m_ProcessSelector->selectedProcess(), bytesPerSecond), processName, Utilities::generatePathForSnapshot(processName));
+    m_DumpJobsTimer->start(100);
+    updateDumpJobs();
+}
+
+void CModuleListWindow::on_cancelDumpsButton_clicked() {
+    m_DumpQueue->cancelAll();
+    updateDumpJobs();
+}
+
+void CModuleListWindow::enqueueModuleDump(const CModule& module) {
+    auto [baseAddress, size] = module.memento().info();
+    if(!baseAddress || !size)
+        return;
+
     const auto dumpPath =
         Utilities::generatePathForDump(
             m_ProcessSelector->selectedProcess()->memento().name(),
             module.memento().name(),
-            ""
+            baseAddress
             );
 
-    if(std::filesystem::exists(dumpPath)) {
-        updateModuleDumpLastLabel("File with the name of the dump already exist, delete it manually to proceed");
+    m_DumpQueue->enqueue(std::make_unique<CModuleDumper>(m_ProcessSelector->selectedProcess(), baseAddress), module.memento().name(), dumpPath);
+    m_DumpJobsTimer->start(100);
+    updateDumpJobs();
+}
+
+void CModuleListWindow::updateDumpJobs() {
+    ui->dumpJobList->clear();
+    for(const auto& job : m_DumpQueue->jobs()) {
+        const QString state = job.state == TDumpJobState::Queued ? "queued" : QString::number(static_cast<int>(job.progress * 100.f)) + "%";
+        ui->dumpJobList->addItem(QString(job.name.c_str()) + " - " + state);
+    }
+
+    for(const auto& job : m_DumpQueue->takeFinished()) {
+        updateMainWindowStatusBar(job.message.c_str());
+    }
+
+    if(!m_DumpQueue->isBusy())
+        m_DumpJobsTimer->stop();
+}
+
+void CModuleListWindow::on_signatureScanButton_clicked() {
+    if(!m_ProcessSelector->selectedProcess() || m_SelectedModule == -1) {
+        updateSignatureScanLastLabel("You must select a process and a module you want to scan");
+        return;
+    }
+
+    std::unique_ptr<CSignature> signature{ };
+    try {
+        signature = std::make_unique<CSignature>(ui->signatureLine->text().trimmed().toStdString());
+    } catch(const std::invalid_argument& e) {
+        updateSignatureScanLastLabel(e.what());
+        return;
+    }
+
+    CSignatureScanner scanner(m_ProcessSelector->selectedProcess());
+    const auto matches = scanner.scanModule(getSelectedModule(), *signature);
+    if(matches.empty()) {
+        updateSignatureScanLastLabel("Not found");
         return;
     }
 
-    std::ofstream outFile(dumpPath, std::ios::trunc | std::ios::binary);
-    outFile.write(reinterpret_cast<const char*>(dumpBuffer.data()), dumpBuffer.size());
-    updateModuleDumpLastLabel("Dumped successfully");
-    updateMainWindowStatusBar("Saved to " + QString(dumpPath.c_str()));
+    const auto [baseAddress, size] = getSelectedModule().memento().info();
+    updateSignatureScanLastLabel(QString::number(matches.size()) + " match(es), first at " + QString::number(matches.front(), 16) +
+                                 " (+" + QString::number(matches.front() - baseAddress, 16) + ")");
+    goToMemoryAddress(matches.front());
 }
 
 void CModuleListWindow::on_moduleList_itemDoubleClicked(QListWidgetItem *item) {
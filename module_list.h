@@ -1,9 +1,11 @@
 #pragma once
 #include <QDialog>
 #include <QListWidgetItem>
+#include <QTimer>
 #include "settings.h"
 #include "module.h"
 #include "process_selector.h"
+#include "dump_queue.h"
 
 namespace Ui {
 class CModuleListWindow;
@@ -18,6 +20,7 @@ public:
     ~CModuleListWindow();
 private slots:
     void on_modulesRefreshButton_clicked();
+    void on_modulesAutoRefreshCheckBox_toggled(bool checked);
     void on_moduleList_currentRowChanged(int currentRow);
     void on_moduleList_itemDoubleClicked(QListWidgetItem *item);
 
@@ -27,16 +30,23 @@ private slots:
 
     void on_dumpSectionButton_clicked();
     void on_dumpModuleButton_clicked();
+    void on_dumpAllModulesButton_clicked();
+    void on_snapshotProcessButton_clicked();
+    void on_cancelDumpsButton_clicked();
+    void on_signatureScanButton_clicked();
 
     void on_closeButton_clicked();
 
     void onProcessAttach();
     void onProcessDetach();
     void onModuleInfoFormatChanged();
+    void updateDumpJobs();
 private:
     void connectSignals();
 
     void updateModuleList();
+    // applies only the changed rows, the selected module stays selected unless it was removed
+    void updateModuleList(const CListChanges& changes);
 
     void selectModule(int idx = -1);
     const CModule& getSelectedModule();
@@ -49,13 +59,21 @@ private:
     void goToSelectedSection();
     void updateSectionInfoLines();
     void updateSectionDumpLastLabel(const QString& message = "");
+    void updateSignatureScanLastLabel(const QString& message = "");
+    void enqueueModuleDump(const CModule& module);
 
     void updateMainWindowStatusBar(const QString& message = "");
     void goToMemoryAddress(std::uint64_t address);
 private:
+    static constexpr int c_ModulesRefreshInterval{ 1000 };
+
     int m_SelectedModule{ -1 }, m_SelectedSection{ -1 };
 
     Ui::CModuleListWindow *ui;
     CSettingsWindow* m_Settings;
     CProcessSelectorWindow* m_ProcessSelector;
+
+    std::unique_ptr<CDumpQueue> m_DumpQueue;
+    QTimer* m_DumpJobsTimer;
+    QTimer* m_ModulesRefreshTimer;
 };
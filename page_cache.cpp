@@ -0,0 +1,136 @@
+#include "page_cache.h"
+#include "process.h"
+
+CPageCache::CPageCache(IProcessIO* process, std::size_t byteBudget)
+    : m_ThisProcess{ process }, m_ByteBudget{ byteBudget } {
+    if(!m_ThisProcess)
+        throw std::runtime_error("m_ThisProcess can not be nullptr");
+}
+
+bool CPageCache::read(std::uint64_t address, std::uint32_t size, void* buffer) {
+    CReadRequest request{ address, size, buffer };
+    return readScatter(std::span<CReadRequest>(&request, 1)) == 1;
+}
+
+std::size_t CPageCache::readScatter(std::span<CReadRequest> requests) {
+    std::lock_guard lock(m_Mutex);
+    const auto now = std::chrono::steady_clock::now();
+
+    auto forEachPage = [](const CReadRequest& request, auto&& callback) -> void {
+        if(!request.size)
+            return;
+
+        const std::uint64_t firstPage = request.address & ~static_cast<std::uint64_t>(c_PageSize - 1);
+        const std::uint64_t lastPage = (request.address + request.size - 1) & ~static_cast<std::uint64_t>(c_PageSize - 1);
+        for(std::uint64_t page = firstPage; page <= lastPage && page >= firstPage; page += c_PageSize) {
+            callback(page);
+        }
+    };
+
+    // collect missing and expired pages of all requests
+    std::vector<CReadRequest> pageRequests{ };
+    std::vector<CCachedPage*> fetchedPages{ };
+    for(const auto& request : requests) {
+        forEachPage(request, [&](std::uint64_t pageAddress) -> void {
+            CCachedPage& page = touch(pageAddress);
+            if(page.fetchTime == now) // already queued by an overlapping request
+                return;
+            if(page.fetchTime.time_since_epoch().count() && now - page.fetchTime < m_TimeToLive) {
+                ++m_Hits;
+                return;
+            }
+
+            ++m_Misses;
+            page.fetchTime = now;
+            pageRequests.push_back({ pageAddress, c_PageSize, page.data.data() });
+            fetchedPages.push_back(&page);
+        });
+    }
+
+    m_ThisProcess->readScatter(pageRequests);
+    for(std::size_t i = 0; i < fetchedPages.size(); ++i) {
+        fetchedPages[i]->isReadable = pageRequests[i].isSuccessful;
+        if(!fetchedPages[i]->isReadable)
+            std::fill(fetchedPages[i]->data.begin(), fetchedPages[i]->data.end(), 0);
+    }
+
+    // copy out before evicting, so pages of this call are never dropped halfway
+    std::size_t successfulRequests{ };
+    for(auto& request : requests) {
+        request.isSuccessful = true;
+        forEachPage(request, [&](std::uint64_t pageAddress) -> void {
+            const CCachedPage& page = *m_PageIndex[pageAddress];
+            const std::uint64_t copyStart = std::max(pageAddress, request.address);
+            const std::uint64_t copyEnd = std::min(pageAddress + c_PageSize, request.address + request.size);
+            memcpy(static_cast<std::uint8_t*>(request.buffer) + (copyStart - request.address),
+                   page.data.data() + (copyStart - pageAddress),
+                   copyEnd - copyStart);
+            request.isSuccessful &= page.isReadable;
+        });
+        successfulRequests += request.isSuccessful;
+    }
+
+    evict();
+    return successfulRequests;
+}
+
+void CPageCache::invalidate(std::uint64_t address, std::uint32_t size) {
+    if(!size)
+        return;
+
+    std::lock_guard lock(m_Mutex);
+    const std::uint64_t firstPage = address & ~static_cast<std::uint64_t>(c_PageSize - 1);
+    for(std::uint64_t page = firstPage; page < address + size && page >= firstPage; page += c_PageSize) {
+        const auto pageIterator = m_PageIndex.find(page);
+        if(pageIterator == m_PageIndex.end())
+            continue;
+
+        m_Pages.erase(pageIterator->second);
+        m_PageIndex.erase(pageIterator);
+    }
+}
+
+void CPageCache::clear() {
+    std::lock_guard lock(m_Mutex);
+    m_Pages.clear();
+    m_PageIndex.clear();
+}
+
+void CPageCache::setTimeToLive(std::chrono::milliseconds timeToLive) {
+    std::lock_guard lock(m_Mutex);
+    m_TimeToLive = timeToLive;
+}
+
+void CPageCache::setByteBudget(std::size_t byteBudget) {
+    std::lock_guard lock(m_Mutex);
+    m_ByteBudget = byteBudget;
+    evict();
+}
+
+std::uint64_t CPageCache::hits() const {
+    return m_Hits;
+}
+
+std::uint64_t CPageCache::misses() const {
+    return m_Misses;
+}
+
+CPageCache::CCachedPage& CPageCache::touch(std::uint64_t pageAddress) {
+    const auto pageIterator = m_PageIndex.find(pageAddress);
+    if(pageIterator != m_PageIndex.end()) {
+        m_Pages.splice(m_Pages.begin(), m_Pages, pageIterator->second);
+        return m_Pages.front();
+    }
+
+    m_Pages.emplace_front();
+    m_Pages.front().address = pageAddress;
+    m_PageIndex[pageAddress] = m_Pages.begin();
+    return m_Pages.front();
+}
+
+void CPageCache::evict() {
+    while(!m_Pages.empty() && m_Pages.size() * c_PageSize > m_ByteBudget) {
+        m_PageIndex.erase(m_Pages.back().address);
+        m_Pages.pop_back();
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "utilities.h"
+
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <chrono>
+#include <span>
+#include <atomic>
+
+class IProcessIO;
+struct CReadRequest;
+
+// Read-through cache of whole target pages. Pages younger than the time to live are served from memory, the least recently
+// used ones are evicted once the byte budget is exceeded. Writers must call invalidate() for the range they modified
+class CPageCache final {
+public:
+    static constexpr std::uint32_t c_PageSize{ 0x1000 };
+public:
+    CPageCache(IProcessIO* process, std::size_t byteBudget = 16 * 1024 * 1024);
+    ~CPageCache() = default;
+
+    CPageCache(const CPageCache&) = delete;
+    CPageCache& operator=(const CPageCache&) = delete;
+public:
+    // same contract as IProcessIO::readToBuffer, unreadable pages are zero-filled
+    bool read(std::uint64_t address, std::uint32_t size, void* buffer);
+    // same contract as IProcessIO::readScatter, every page missing from all requests is fetched in one batch
+    std::size_t readScatter(std::span<CReadRequest> requests);
+
+    void invalidate(std::uint64_t address, std::uint32_t size);
+    void clear();
+
+    void setTimeToLive(std::chrono::milliseconds timeToLive);
+    void setByteBudget(std::size_t byteBudget);
+
+    std::uint64_t hits() const;
+    std::uint64_t misses() const;
+private:
+    struct CCachedPage {
+        std::uint64_t address{ };
+        bool isReadable{ };
+        std::chrono::steady_clock::time_point fetchTime{ };
+        std::vector<std::uint8_t> data{ std::vector<std::uint8_t>(c_PageSize) };
+    };
+    using TPageList = std::list<CCachedPage>;
+
+    CCachedPage& touch(std::uint64_t pageAddress); // finds or inserts the page and marks it as most recently used
+    void evict();
+
+    IProcessIO* m_ThisProcess{ };
+
+    std::mutex m_Mutex{ };
+    TPageList m_Pages{ }; // most recently used first
+    std::unordered_map<std::uint64_t, TPageList::iterator> m_PageIndex{ };
+    std::size_t m_ByteBudget{ };
+    std::chrono::milliseconds m_TimeToLive{ 500 };
+
+    std::atomic<std::uint64_t> m_Hits{ }, m_Misses{ };
+};
@@ -0,0 +1,446 @@
+#include "pointer_scanner.h"
+#include <algorithm>
+#include <fstream>
+#include <cinttypes>
+#include <thread>
+
+CPointerScanner::CPointerScanner(std::weak_ptr<IProcessIO> targetProcess)
+    : m_TargetProcess{ targetProcess } { }
+
+void CPointerScanner::setTargetProcess(std::weak_ptr<IProcessIO> targetProcess) {
+    m_TargetProcess = targetProcess;
+}
+
+bool CPointerScanner::scan(std::uint64_t target, std::uint32_t maxDepth, std::uint32_t maxOffset, const std::vector<CModuleMemento>& modules, std::size_t maxResults) {
+    reset();
+    auto process = m_TargetProcess.lock();
+    if(!process || !maxDepth || maxDepth > CPointerPath::c_MaximumDepth)
+        return false;
+
+    m_IsCancelled = false;
+    m_MaxDepth = maxDepth;
+    m_MaxOffset = maxOffset;
+    m_MaxResults = maxResults;
+    setStaticRanges(modules);
+    if(!buildPointerMap(process.get())) {
+        reset();
+        return false;
+    }
+
+    // breadth first until there are enough subtrees to keep all cores busy
+    const std::size_t taskCount = std::max(1u, std::thread::hardware_concurrency()) * c_SearchTasksPerThread;
+    std::vector<CPointerPath> results{ };
+    std::vector<CSearchNode> frontier{ CSearchNode{ target } };
+    while(!frontier.empty() && frontier.size() < taskCount && !m_IsCancelled) {
+        std::vector<CSearchNode> nextFrontier{ };
+        for(const auto& node : frontier) {
+            expand(node, results, [&](const CSearchNode& next) -> void {
+                nextFrontier.push_back(next);
+            });
+        }
+        frontier = std::move(nextFrontier);
+    }
+
+    m_TotalTasks += frontier.size();
+    std::vector<std::vector<CPointerPath>> taskResults(frontier.size());
+    Utilities::parallelFor(frontier.size(), [&](std::size_t i) -> void {
+        search(frontier[i], taskResults[i]);
+        ++m_CompletedTasks;
+    });
+    if(m_IsCancelled) {
+        reset();
+        return false;
+    }
+
+    for(const auto& taskResult : taskResults) {
+        results.insert(results.end(), taskResult.begin(), taskResult.end());
+    }
+    // shorter paths first, they are the likelier ones to survive a restart
+    std::sort(results.begin(), results.end(), [](const CPointerPath& a, const CPointerPath& b) -> bool {
+        return a.depth != b.depth ? a.depth < b.depth : a < b;
+    });
+    m_Results = std::move(results);
+
+    // the map is only good for this moment of the process, the next scan builds a new one
+    m_Pointers.clear();
+    m_Pointers.shrink_to_fit();
+    m_StaticPointers.clear();
+    m_StaticPointers.shrink_to_fit();
+    return true;
+}
+
+bool CPointerScanner::revalidate(std::uint64_t target, const std::vector<CModuleMemento>& modules) {
+    auto process = m_TargetProcess.lock();
+    if(!process)
+        return false;
+
+    m_IsCancelled = false;
+    m_CompletedTasks = { };
+
+    // base of every module of the paths in this process, 0 when it is not loaded
+    std::vector<std::uint64_t> bases(m_ModuleNames.size());
+    for(const auto& module : modules) {
+        const auto name = std::find(m_ModuleNames.begin(), m_ModuleNames.end(), module.name());
+        if(name != m_ModuleNames.end() && !bases[name - m_ModuleNames.begin()])
+            bases[name - m_ModuleNames.begin()] = std::get<0>(module.info());
+    }
+
+    const std::size_t slices = (m_Results.size() + c_SliceSize - 1) / c_SliceSize;
+    m_TotalTasks = slices;
+    std::vector<std::vector<CPointerPath>> sliceResults(slices);
+    Utilities::parallelFor(slices, [&](std::size_t i) -> void {
+        if(m_IsCancelled)
+            return;
+
+        // paths of the slice are resolved together, one readScatter per level
+        const std::span<const CPointerPath> slice{ m_Results.data() + i * c_SliceSize, std::min(c_SliceSize, m_Results.size() - i * c_SliceSize) };
+        std::vector<std::uint64_t> addresses(slice.size()), values(slice.size());
+        std::vector<std::uint8_t> isResolved(slice.size());
+        for(std::size_t j = 0; j < slice.size(); ++j) {
+            const std::uint64_t base = bases[slice[j].module];
+            addresses[j] = base + slice[j].moduleOffset;
+            isResolved[j] = base != 0;
+        }
+
+        std::vector<CReadRequest> requests{ };
+        std::vector<std::size_t> requestPaths{ };
+        for(std::uint32_t level = 0; level < CPointerPath::c_MaximumDepth; ++level) {
+            requests.clear();
+            requestPaths.clear();
+            for(std::size_t j = 0; j < slice.size(); ++j) {
+                if(!isResolved[j] || level >= slice[j].depth)
+                    continue;
+                requests.push_back({ addresses[j], sizeof(std::uint64_t), &values[j] });
+                requestPaths.push_back(j);
+            }
+            if(requests.empty())
+                break;
+
+            process->readScatter(requests);
+            for(std::size_t k = 0; k < requests.size(); ++k) {
+                const std::size_t j = requestPaths[k];
+                if(requests[k].isSuccessful)
+                    addresses[j] = values[j] + slice[j].offsets[level];
+                else
+                    isResolved[j] = false;
+            }
+        }
+
+        for(std::size_t j = 0; j < slice.size(); ++j) {
+            if(isResolved[j] && addresses[j] == target)
+                sliceResults[i].push_back(slice[j]);
+        }
+        ++m_CompletedTasks;
+    });
+    if(m_IsCancelled)
+        return false;
+
+    std::vector<CPointerPath> results{ };
+    for(const auto& sliceResult : sliceResults) {
+        results.insert(results.end(), sliceResult.begin(), sliceResult.end());
+    }
+    m_Results = std::move(results);
+    return true;
+}
+
+void CPointerScanner::reset() {
+    m_Pointers.clear();
+    m_Pointers.shrink_to_fit();
+    m_StaticPointers.clear();
+    m_StaticPointers.shrink_to_fit();
+    m_StaticRanges.clear();
+    m_ModuleNames.clear();
+    m_Results.clear();
+    m_Results.shrink_to_fit();
+    m_ResultCount = { };
+    m_CompletedTasks = m_TotalTasks = { };
+}
+
+void CPointerScanner::cancel() {
+    m_IsCancelled = true;
+}
+
+float CPointerScanner::progress() const {
+    const std::size_t total = m_TotalTasks;
+    return total ? static_cast<float>(m_CompletedTasks) / static_cast<float>(total) : 0.f;
+}
+
+// the file is the formatted paths after a header line, so it can be read and edited by hand:
+//   memObserver pointer paths 1
+//   game.exe+1a2b0 -> 10 -> 3c8
+bool CPointerScanner::save(const std::string& path) const {
+    std::ofstream file(path, std::ios::trunc);
+    if(!file)
+        return false;
+
+    file << c_FileHeader << '\n';
+    for(const auto& result : m_Results) {
+        file << formatPath(result) << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
+bool CPointerScanner::load(const std::string& path) {
+    std::ifstream file(path);
+    std::string line{ };
+    if(!file || !std::getline(file, line) || line != c_FileHeader)
+        return false;
+
+    auto previousNames = std::move(m_ModuleNames);
+    m_ModuleNames.clear();
+    std::vector<CPointerPath> results{ };
+    auto parseHex = [](const std::string& text, std::uint64_t& value) -> bool {
+        try {
+            std::size_t parsedLength{ };
+            value = std::stoull(text, &parsedLength, 16);
+            return parsedLength == text.size();
+        } catch(const std::exception&) {
+            return false;
+        }
+    };
+
+    bool isSuccessful{ true };
+    while(isSuccessful && std::getline(file, line)) {
+        if(!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if(line.empty())
+            continue;
+
+        std::vector<std::string> parts{ };
+        for(std::size_t start = 0;;) {
+            const std::size_t separator = line.find(" -> ", start);
+            parts.push_back(line.substr(start, separator - start));
+            if(separator == std::string::npos)
+                break;
+            start = separator + 4;
+        }
+
+        // module names may contain '+', the offset follows the last one
+        const std::size_t plus = parts.front().rfind('+');
+        CPointerPath result{ };
+        std::uint64_t value{ };
+        isSuccessful = plus != std::string::npos && plus && parts.size() > 1 && parts.size() - 1 <= CPointerPath::c_MaximumDepth &&
+            parseHex(parts.front().substr(plus + 1), result.moduleOffset);
+        for(std::size_t i = 1; isSuccessful && i < parts.size(); ++i) {
+            isSuccessful = parseHex(parts[i], value) && value <= UINT32_MAX;
+            result.offsets[i - 1] = static_cast<std::uint32_t>(value);
+        }
+        if(!isSuccessful)
+            break;
+
+        result.module = moduleIndex(parts.front().substr(0, plus));
+        result.depth = static_cast<std::uint32_t>(parts.size() - 1);
+        results.push_back(result);
+    }
+
+    if(!isSuccessful || file.bad()) {
+        printf("[CPointerScanner] %s is not a valid pointer path file\n", path.c_str());
+        m_ModuleNames = std::move(previousNames);
+        return false;
+    }
+
+    m_Results = std::move(results);
+    m_CompletedTasks = m_TotalTasks = { };
+    return true;
+}
+
+std::span<const CPointerPath> CPointerScanner::results() const {
+    return m_Results;
+}
+
+const std::vector<std::string>& CPointerScanner::moduleNames() const {
+    return m_ModuleNames;
+}
+
+std::string CPointerScanner::formatPath(const CPointerPath& path) const {
+    char buffer[32]{ };
+    sprintf_s(buffer, "+%" PRIx64, path.moduleOffset);
+    std::string text = (path.module < m_ModuleNames.size() ? m_ModuleNames[path.module] : std::string("?")) + buffer;
+    for(std::uint32_t i = 0; i < path.depth; ++i) {
+        sprintf_s(buffer, " -> %" PRIx32, path.offsets[i]);
+        text += buffer;
+    }
+    return text;
+}
+
+std::optional<std::uint64_t> CPointerScanner::resolve(const CPointerPath& path, const std::vector<CModuleMemento>& modules) {
+    auto process = m_TargetProcess.lock();
+    if(!process || path.module >= m_ModuleNames.size())
+        return std::nullopt;
+
+    const auto module = std::find_if(modules.begin(), modules.end(), [&](const CModuleMemento& module) -> bool {
+        return module.name() == m_ModuleNames[path.module];
+    });
+    if(module == modules.end())
+        return std::nullopt;
+
+    std::uint64_t address = std::get<0>(module->info()) + path.moduleOffset;
+    for(std::uint32_t i = 0; i < path.depth; ++i) {
+        std::uint64_t value{ };
+        if(!process->readToBuffer(address, sizeof(value), &value))
+            return std::nullopt;
+        address = value + path.offsets[i];
+    }
+    return address;
+}
+
+bool CPointerScanner::buildPointerMap(IProcessIO* process) {
+    // ranges pointers have to point into, adjacent regions are merged
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> readable{ };
+    for(const auto& region : process->regions()) {
+        if(region.State != MEM_COMMIT || !region.Protect || region.Protect & (PAGE_NOACCESS | PAGE_GUARD))
+            continue;
+        const std::uint64_t start = reinterpret_cast<std::uint64_t>(region.BaseAddress);
+        readable.emplace_back(start, start + region.RegionSize);
+    }
+    std::sort(readable.begin(), readable.end());
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> ranges{ };
+    for(const auto& [start, end] : readable) {
+        if(!ranges.empty() && ranges.back().second >= start)
+            ranges.back().second = std::max(ranges.back().second, end);
+        else
+            ranges.emplace_back(start, end);
+    }
+    if(ranges.empty())
+        return false;
+
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> chunks{ };
+    for(const auto& [start, end] : readable) {
+        for(std::uint64_t address = start; address < end; address += c_ChunkSize) {
+            chunks.emplace_back(address, static_cast<std::uint32_t>(std::min(c_ChunkSize, end - address)));
+        }
+    }
+    m_TotalTasks = chunks.size();
+
+    const std::uint64_t lowest = ranges.front().first, highest = ranges.back().second;
+    std::vector<std::vector<CPointerEntry>> chunkPointers(chunks.size());
+    Utilities::parallelFor(chunks.size(), [&](std::size_t i) -> void {
+        if(m_IsCancelled)
+            return;
+
+        const auto [address, size] = chunks[i];
+        std::vector<std::uint8_t> buffer(size);
+        for(const auto& [offset, readSize] : process->readAvailable(address, size, buffer.data())) {
+            // readable parts are whole pages, so values are read at aligned addresses
+            for(std::size_t j = offset; j + sizeof(std::uint64_t) <= offset + readSize; j += sizeof(std::uint64_t)) {
+                std::uint64_t value{ };
+                std::memcpy(&value, buffer.data() + j, sizeof(value));
+                // most values are no pointers at all, the bounds reject them before the search
+                if(value < lowest || value >= highest)
+                    continue;
+                const auto range = std::upper_bound(ranges.begin(), ranges.end(), value, [](std::uint64_t candidate, const auto& range) -> bool {
+                    return candidate < range.first;
+                });
+                if(range == ranges.begin() || value >= std::prev(range)->second)
+                    continue;
+                chunkPointers[i].push_back({ value, address + j });
+            }
+        }
+        std::sort(chunkPointers[i].begin(), chunkPointers[i].end());
+        ++m_CompletedTasks;
+    });
+    if(m_IsCancelled)
+        return false;
+
+    // chunks are sorted on their own, they are merged pairwise in parallel rounds
+    std::vector<std::size_t> bounds{ 0 };
+    std::size_t pointerCount{ };
+    for(const auto& pointers : chunkPointers) {
+        pointerCount += pointers.size();
+    }
+    m_Pointers.reserve(pointerCount);
+    for(auto& pointers : chunkPointers) {
+        m_Pointers.insert(m_Pointers.end(), pointers.begin(), pointers.end());
+        bounds.push_back(m_Pointers.size());
+        std::vector<CPointerEntry>().swap(pointers);
+    }
+    for(std::size_t width = 1; width < chunks.size(); width *= 2) {
+        Utilities::parallelFor((chunks.size() + 2 * width - 1) / (2 * width), [&](std::size_t i) -> void {
+            const std::size_t first = i * 2 * width, middle = std::min(first + width, chunks.size()), last = std::min(first + 2 * width, chunks.size());
+            std::inplace_merge(m_Pointers.begin() + bounds[first], m_Pointers.begin() + bounds[middle], m_Pointers.begin() + bounds[last]);
+        });
+    }
+
+    for(const auto& pointer : m_Pointers) {
+        if(findStaticRange(pointer.address))
+            m_StaticPointers.push_back(pointer);
+    }
+    printf("[CPointerScanner] %zu pointers, %zu of them in modules\n", m_Pointers.size(), m_StaticPointers.size());
+    return true;
+}
+
+void CPointerScanner::setStaticRanges(const std::vector<CModuleMemento>& modules) {
+    m_StaticRanges.clear();
+    for(const auto& module : modules) {
+        const auto [base, size] = module.info();
+        m_StaticRanges.push_back({ base, base + size, moduleIndex(module.name()) });
+    }
+    std::sort(m_StaticRanges.begin(), m_StaticRanges.end(), [](const CStaticRange& a, const CStaticRange& b) -> bool {
+        return a.start < b.start;
+    });
+}
+
+const CPointerScanner::CStaticRange* CPointerScanner::findStaticRange(std::uint64_t address) const {
+    const auto range = std::upper_bound(m_StaticRanges.begin(), m_StaticRanges.end(), address, [](std::uint64_t candidate, const CStaticRange& range) -> bool {
+        return candidate < range.start;
+    });
+    if(range == m_StaticRanges.begin() || address >= std::prev(range)->end)
+        return nullptr;
+    return &*std::prev(range);
+}
+
+std::span<const CPointerScanner::CPointerEntry> CPointerScanner::pointersTo(std::uint64_t address, bool isStaticOnly) const {
+    const auto& pointers = isStaticOnly ? m_StaticPointers : m_Pointers;
+    const std::uint64_t lowest = address > m_MaxOffset ? address - m_MaxOffset : 0;
+    const auto first = std::lower_bound(pointers.begin(), pointers.end(), lowest, [](const CPointerEntry& pointer, std::uint64_t value) -> bool {
+        return pointer.value < value;
+    });
+    const auto last = std::upper_bound(first, pointers.end(), address, [](std::uint64_t value, const CPointerEntry& pointer) -> bool {
+        return value < pointer.value;
+    });
+    return { first, last };
+}
+
+template<class OnNode>
+void CPointerScanner::expand(const CSearchNode& node, std::vector<CPointerPath>& results, OnNode onNode) {
+    const std::uint32_t depth = node.depth + 1;
+    // only pointers inside modules can end a path on the last level
+    for(const auto& pointer : pointersTo(node.address, depth == m_MaxDepth)) {
+        CSearchNode next{ pointer.address, depth, node.offsets };
+        next.offsets[node.depth] = static_cast<std::uint32_t>(node.address - pointer.value);
+
+        // a path ends at the first static pointer, longer ones through it would only repeat it
+        if(const auto range = findStaticRange(pointer.address)) {
+            if(m_ResultCount++ >= m_MaxResults)
+                return;
+
+            CPointerPath path{ range->module, depth, pointer.address - range->start };
+            for(std::uint32_t i = 0; i < depth; ++i) {
+                path.offsets[i] = next.offsets[depth - 1 - i];
+            }
+            results.push_back(path);
+            continue;
+        }
+
+        if(depth < m_MaxDepth)
+            onNode(next);
+    }
+}
+
+void CPointerScanner::search(const CSearchNode& node, std::vector<CPointerPath>& results) {
+    if(m_IsCancelled || m_ResultCount >= m_MaxResults)
+        return;
+
+    expand(node, results, [&](const CSearchNode& next) -> void {
+        search(next, results);
+    });
+}
+
+std::uint32_t CPointerScanner::moduleIndex(const std::string& name) {
+    const auto found = std::find(m_ModuleNames.begin(), m_ModuleNames.end(), name);
+    if(found != m_ModuleNames.end())
+        return static_cast<std::uint32_t>(found - m_ModuleNames.begin());
+
+    m_ModuleNames.push_back(name);
+    return static_cast<std::uint32_t>(m_ModuleNames.size() - 1);
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include "process.h"
+#include <atomic>
+#include <array>
+#include <optional>
+
+// static slot of a module and the offsets which are added after each dereference, the last one lands on the target:
+// address = base of moduleName + moduleOffset, then address = *address + offsets[i] for every offset
+struct CPointerPath {
+    static constexpr std::size_t c_MaximumDepth{ 8 };
+
+    std::uint32_t module{ }; // index into CPointerScanner::moduleNames()
+    std::uint32_t depth{ }; // number of used offsets
+    std::uint64_t moduleOffset{ };
+    std::array<std::uint32_t, c_MaximumDepth> offsets{ };
+
+    friend auto operator<=>(const CPointerPath&, const CPointerPath&) = default;
+};
+
+// Finds pointer paths from static module memory to a target address of a 64-bit process. Every aligned pointer-sized
+// value of committed readable memory which points into such memory is collected into a map sorted by value on all
+// cores, then the paths are searched backward from the target: pointers to [target - maxOffset, target] become the
+// next targets until a pointer lies inside a module. Subtrees of the search run in parallel, the last level only looks
+// at pointers inside modules. Found paths can be saved, loaded and narrowed down against another instance of the process
+class CPointerScanner {
+public:
+    CPointerScanner(std::weak_ptr<IProcessIO> targetProcess);
+    ~CPointerScanner() = default;
+
+    // the paths are kept, so they can be revalidated against another instance of the process
+    void setTargetProcess(std::weak_ptr<IProcessIO> targetProcess);
+    // modules are the static ranges, copied from the CModuleList of the process by the caller since the list belongs to its thread
+    // @return Returns false when the process is gone, the depth is out of range or the scan was cancelled
+    bool scan(std::uint64_t target, std::uint32_t maxDepth, std::uint32_t maxOffset, const std::vector<CModuleMemento>& modules,
+              std::size_t maxResults = c_DefaultMaximumResults);
+    // keeps paths which still resolve to target, the process may be another instance with other module bases
+    // @return Returns false when the process is gone or the revalidation was cancelled, the paths are kept then
+    bool revalidate(std::uint64_t target, const std::vector<CModuleMemento>& modules);
+    void reset();
+
+    // both are safe to call from other threads while a scan runs
+    void cancel();
+    float progress() const;
+
+    // text file, one path per line, see save()
+    bool save(const std::string& path) const;
+    // @return Returns false when the file can not be read or is not a pointer path file, the paths are kept then
+    bool load(const std::string& path);
+
+    std::span<const CPointerPath> results() const;
+    const std::vector<std::string>& moduleNames() const;
+    // "module+offset -> offset -> ..."
+    std::string formatPath(const CPointerPath& path) const;
+    // @return Returns the address path resolves to in the process, nullopt when a pointer on the way can not be read
+    std::optional<std::uint64_t> resolve(const CPointerPath& path, const std::vector<CModuleMemento>& modules);
+
+    static constexpr std::size_t c_DefaultMaximumResults{ 100000 };
+private:
+    struct CPointerEntry {
+        std::uint64_t value{ };
+        std::uint64_t address{ };
+
+        friend auto operator<=>(const CPointerEntry&, const CPointerEntry&) = default;
+    };
+
+    // a target still to be searched, offsets are stored from the target backward
+    struct CSearchNode {
+        std::uint64_t address{ };
+        std::uint32_t depth{ };
+        std::array<std::uint32_t, CPointerPath::c_MaximumDepth> offsets{ };
+    };
+
+    struct CStaticRange {
+        std::uint64_t start{ };
+        std::uint64_t end{ };
+        std::uint32_t module{ };
+    };
+
+    static constexpr std::uint64_t c_ChunkSize{ 0x100000 };
+    // subtrees the search is split into per core, more of them balance uneven subtrees better
+    static constexpr std::size_t c_SearchTasksPerThread{ 16 };
+    // paths of one revalidation slice resolved together level by level with readScatter
+    static constexpr std::size_t c_SliceSize{ 0x4000 };
+    static constexpr char c_FileHeader[]{ "memObserver pointer paths 1" };
+
+    bool buildPointerMap(IProcessIO* process);
+    void setStaticRanges(const std::vector<CModuleMemento>& modules);
+    const CStaticRange* findStaticRange(std::uint64_t address) const;
+    // pointers to [address - maxOffset, address], only the ones inside modules when isStaticOnly
+    std::span<const CPointerEntry> pointersTo(std::uint64_t address, bool isStaticOnly) const;
+    // emits paths which end in a module and calls onNode for the deeper targets
+    template<class OnNode>
+    void expand(const CSearchNode& node, std::vector<CPointerPath>& results, OnNode onNode);
+    void search(const CSearchNode& node, std::vector<CPointerPath>& results);
+    // index into m_ModuleNames, names are added as new modules show up
+    std::uint32_t moduleIndex(const std::string& name);
+private:
+    std::weak_ptr<IProcessIO> m_TargetProcess;
+
+    std::vector<CPointerEntry> m_Pointers{ }; // sorted by value
+    std::vector<CPointerEntry> m_StaticPointers{ }; // the ones inside modules, sorted by value
+    std::vector<CStaticRange> m_StaticRanges{ }; // sorted by start
+    std::uint32_t m_MaxDepth{ };
+    std::uint32_t m_MaxOffset{ };
+    std::size_t m_MaxResults{ };
+    std::atomic<std::size_t> m_ResultCount{ };
+
+    std::vector<std::string> m_ModuleNames{ };
+    std::vector<CPointerPath> m_Results{ };
+
+    std::atomic<bool> m_IsCancelled{ };
+    std::atomic<std::size_t> m_CompletedTasks{ }, m_TotalTasks{ };
+};
@@ -0,0 +1,215 @@
+#include "pointer_scanner_window.h"
+#include "ui_pointer_scanner_window.h"
+#include "cmainwindow.h"
+#include <QFileDialog>
+
+CPointerScannerWindow::CPointerScannerWindow(QWidget *parent, CProcessSelectorWindow* processSelector)
+    : QDialog(parent)
+    , m_ProgressTimer{ new QTimer(this) }
+    , ui(new Ui::CPointerScannerWindow)
+    , m_ProcessSelector{ processSelector } {
+    ui->setupUi(this);
+
+    if(!qobject_cast<CMainWindow*>(this->parent()))
+        throw std::runtime_error("CMainWindow must be a parent of CPointerScannerWindow");
+
+    ui->maxDepthSpinBox->setRange(1, static_cast<int>(CPointerPath::c_MaximumDepth));
+    setScanning(false);
+    updateResultList();
+    connectSignals();
+}
+
+CPointerScannerWindow::~CPointerScannerWindow() {
+    stopScan();
+    delete ui;
+}
+
+void CPointerScannerWindow::connectSignals() {
+    QObject::connect(this, &CPointerScannerWindow::scanFinished, this, &CPointerScannerWindow::onScanFinished, Qt::QueuedConnection);
+    QObject::connect(m_ProgressTimer, &QTimer::timeout, this, &CPointerScannerWindow::updateScanProgress);
+
+    QObject::connect(m_ProcessSelector, &CProcessSelectorWindow::processAttached, this, &CPointerScannerWindow::onProcessAttach);
+    QObject::connect(m_ProcessSelector, &CProcessSelectorWindow::processDetached, this, &CPointerScannerWindow::onProcessDetach);
+}
+
+void CPointerScannerWindow::onProcessAttach() {
+    stopScan();
+    m_Scanner->setTargetProcess(m_ProcessSelector->selectedProcess());
+    setScanning(false);
+}
+
+void CPointerScannerWindow::onProcessDetach() {
+    stopScan();
+    m_Scanner->setTargetProcess({ });
+    setScanning(false);
+    updateScanLastLabel();
+}
+
+void CPointerScannerWindow::startScan(std::function<bool()> scan) {
+    stopScan();
+    setScanning(true);
+    m_ScanThread = std::thread([this, scan]() -> void {
+        emit scanFinished(scan());
+    });
+}
+
+void CPointerScannerWindow::stopScan() {
+    if(!m_ScanThread.joinable())
+        return;
+
+    m_Scanner->cancel();
+    m_ScanThread.join();
+}
+
+void CPointerScannerWindow::setScanning(bool isScanning) {
+    const bool isAttached = m_ProcessSelector->selectedProcess() != nullptr;
+    ui->scanButton->setEnabled(!isScanning && isAttached);
+    ui->revalidateButton->setEnabled(!isScanning && isAttached && !m_Scanner->results().empty());
+    ui->cancelScanButton->setEnabled(isScanning);
+    ui->saveButton->setEnabled(!isScanning && !m_Scanner->results().empty());
+    ui->loadButton->setEnabled(!isScanning);
+
+    ui->scanProgressBar->setValue(0);
+    if(isScanning)
+        m_ProgressTimer->start(100);
+    else
+        m_ProgressTimer->stop();
+}
+
+void CPointerScannerWindow::updateScanProgress() {
+    ui->scanProgressBar->setValue(static_cast<int>(m_Scanner->progress() * 100.f));
+}
+
+void CPointerScannerWindow::onScanFinished(bool isSuccessful) {
+    if(m_ScanThread.joinable())
+        m_ScanThread.join();
+
+    setScanning(false);
+    updateResultList();
+    updateScanLastLabel(isSuccessful ? "" : "Failed, the process is gone or the scan was cancelled");
+}
+
+bool CPointerScannerWindow::parseTarget(std::uint64_t& target) {
+    bool isValid{ };
+    target = ui->targetLine->text().trimmed().toULongLong(&isValid, 16);
+    if(!isValid || !target) {
+        updateScanLastLabel("Target must be an address in hex");
+        return false;
+    }
+    return true;
+}
+
+std::vector<CModuleMemento> CPointerScannerWindow::modules() const {
+    std::vector<CModuleMemento> modules{ };
+    const auto process = m_ProcessSelector->selectedProcess();
+    if(!process)
+        return modules;
+
+    if(const auto moduleList = process->moduleList().lock()) {
+        for(const auto& module : moduleList->data()) {
+            modules.push_back(module.memento());
+        }
+    }
+    return modules;
+}
+
+void CPointerScannerWindow::on_scanButton_clicked() {
+    std::uint64_t target{ };
+    if(!parseTarget(target))
+        return;
+
+    bool isOffsetValid{ };
+    const std::uint64_t maxOffset = ui->maxOffsetLine->text().trimmed().toULongLong(&isOffsetValid, 16);
+    if(!isOffsetValid || maxOffset > UINT32_MAX) {
+        updateScanLastLabel("Max offset must be a number in hex");
+        return;
+    }
+
+    const auto modules = this->modules();
+    if(modules.empty()) {
+        updateScanLastLabel("The module list is empty, refresh it first");
+        return;
+    }
+
+    const auto maxDepth = static_cast<std::uint32_t>(ui->maxDepthSpinBox->value());
+    CPointerScanner* scanner = m_Scanner.get();
+    startScan([=]() -> bool {
+        return scanner->scan(target, maxDepth, static_cast<std::uint32_t>(maxOffset), modules);
+    });
+}
+
+void CPointerScannerWindow::on_revalidateButton_clicked() {
+    std::uint64_t target{ };
+    if(m_Scanner->results().empty() || !parseTarget(target))
+        return;
+
+    const auto modules = this->modules();
+    CPointerScanner* scanner = m_Scanner.get();
+    startScan([=]() -> bool {
+        return scanner->revalidate(target, modules);
+    });
+}
+
+void CPointerScannerWindow::on_cancelScanButton_clicked() {
+    m_Scanner->cancel();
+}
+
+void CPointerScannerWindow::on_saveButton_clicked() {
+    const QString path = QFileDialog::getSaveFileName(this, "Save Pointer Paths", QString(Utilities::programDataDirectory().c_str()), "Pointer paths (*.ptr)");
+    if(path.isEmpty())
+        return;
+
+    updateScanLastLabel(m_Scanner->save(path.toStdString()) ? "Saved to " + path : "Can not write " + path);
+}
+
+void CPointerScannerWindow::on_loadButton_clicked() {
+    const QString path = QFileDialog::getOpenFileName(this, "Load Pointer Paths", QString(Utilities::programDataDirectory().c_str()), "Pointer paths (*.ptr);;All files (*)");
+    if(path.isEmpty())
+        return;
+
+    const bool isLoaded = m_Scanner->load(path.toStdString());
+    setScanning(false);
+    updateResultList();
+    updateScanLastLabel(isLoaded ? "" : path + " is not a pointer path file");
+}
+
+void CPointerScannerWindow::updateResultList() {
+    ui->resultList->clear();
+    const auto results = m_Scanner->results();
+    ui->scanResultsLabel->setText("Paths: " + QString::number(results.size()));
+
+    // listing millions of rows would stall the UI, revalidate them down first
+    const std::size_t listedResults = std::min<std::size_t>(results.size(), c_MaximumListedResults);
+    for(std::size_t i = 0; i < listedResults; ++i) {
+        auto item = new QListWidgetItem(QString(m_Scanner->formatPath(results[i]).c_str()));
+        item->setData(Qt::UserRole, QVariant::fromValue<qulonglong>(i));
+        ui->resultList->addItem(item);
+    }
+}
+
+void CPointerScannerWindow::updateScanLastLabel(const QString& message) {
+    ui->scanLastMessageLabel->setText(message);
+}
+
+void CPointerScannerWindow::on_resultList_itemDoubleClicked(QListWidgetItem *item) {
+    const auto results = m_Scanner->results();
+    const std::size_t index = item->data(Qt::UserRole).toULongLong();
+    if(m_ScanThread.joinable() || index >= results.size())
+        return;
+
+    // resolved now, the pointers on the way may have changed since the scan
+    const auto address = m_Scanner->resolve(results[index], modules());
+    if(!address) {
+        updateScanLastLabel("The path does not resolve in this process");
+        return;
+    }
+    goToMemoryAddress(*address);
+}
+
+void CPointerScannerWindow::goToMemoryAddress(std::uint64_t address) {
+    qobject_cast<CMainWindow*>(this->parent())->goToMemoryAddress(address);
+}
+
+void CPointerScannerWindow::on_closeButton_clicked() {
+    hide();
+}
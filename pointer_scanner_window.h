@@ -0,0 +1,61 @@
+#pragma once
+#include <QDialog>
+#include <QListWidgetItem>
+#include <QTimer>
+#include <thread>
+#include "pointer_scanner.h"
+#include "process_selector.h"
+
+namespace Ui {
+class CPointerScannerWindow;
+}
+
+class CPointerScannerWindow : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit CPointerScannerWindow(QWidget *parent, CProcessSelectorWindow* processSelector);
+    ~CPointerScannerWindow();
+signals:
+    // emitted from the scan thread
+    void scanFinished(bool isSuccessful);
+private slots:
+    void on_scanButton_clicked();
+    void on_revalidateButton_clicked();
+    void on_cancelScanButton_clicked();
+    void on_saveButton_clicked();
+    void on_loadButton_clicked();
+    void on_resultList_itemDoubleClicked(QListWidgetItem *item);
+    void on_closeButton_clicked();
+
+    void onScanFinished(bool isSuccessful);
+    void onProcessAttach();
+    void onProcessDetach();
+    void updateScanProgress();
+private:
+    void connectSignals();
+
+    // runs scan on m_ScanThread, the same way CScannerWindow runs scans
+    void startScan(std::function<bool()> scan);
+    void stopScan();
+    void setScanning(bool isScanning);
+
+    // @return Returns false and tells why when the target line is not a hex address
+    bool parseTarget(std::uint64_t& target);
+    // copied on this thread, the module list is not safe to read from the scan thread
+    std::vector<CModuleMemento> modules() const;
+    void updateResultList();
+    void updateScanLastLabel(const QString& message = "");
+    void goToMemoryAddress(std::uint64_t address);
+private:
+    static constexpr int c_MaximumListedResults{ 1000 };
+
+    // outlives attachments, paths found in one instance of a process are revalidated against the next one
+    std::unique_ptr<CPointerScanner> m_Scanner{ std::make_unique<CPointerScanner>(std::weak_ptr<IProcessIO>()) };
+    std::thread m_ScanThread{ };
+    QTimer* m_ProgressTimer;
+
+    Ui::CPointerScannerWindow *ui;
+    CProcessSelectorWindow* m_ProcessSelector;
+};
@@ -1,9 +1,15 @@
 #include "process.h"
-#include "settings.h"
+#include <map>
+#include <unordered_set>
+
+#ifdef _WIN32
 #include "ntapi.h"
 
 #include <TlHelp32.h>
 #include <Psapi.h>
+#else
+#include "process_linux.h"
+#endif
 
 CProcessMemento::CProcessMemento(const std::uint32_t id, const std::string& name)
     : m_Id{ id }
@@ -45,16 +51,82 @@ const std::string& CProcessMemento::description() const {
     return m_Description;
 }
 
-CProcessList::CProcessList() {
+CProcessList::CProcessList(TSort sortType, bool useEvents)
+    : m_SortType{ sortType } {
+#ifndef _WIN32
+    // subscribe before the first enumeration, a process which starts in between is then reported by both
+    try {
+        if(useEvents)
+            m_Events = std::make_unique<CProcessEvents>();
+    } catch(const std::runtime_error& e) {
+        printf("[CProcessList] %s, falling back to /proc rescans\n", e.what());
+    }
+#endif
     refresh();
 }
 
-void CProcessList::refresh() {
-    cleanup();
+CProcessList::~CProcessList() = default;
+
+CListChanges CProcessList::refresh() {
+    std::vector<CProcessMemento> processes{ };
+#ifndef _WIN32
+    if(m_Events && m_Events->isBroken()) {
+        printf("[CProcessList] Process events stopped, falling back to /proc rescans\n");
+        m_Events.reset();
+    }
+    if(m_Events && !m_Processes.empty())
+        processes = applyEvents(m_Processes, m_Events->take());
+    else
+        processes = enumerate();
+#else
+    processes = enumerate();
+#endif
+
+    std::unique_ptr<ISortStrategy<CProcessMemento>> sortStrategy{ std::make_unique<CNoSort<CProcessMemento>>() };
+    switch(m_SortType) {
+        case TSort::None: break;
+        case TSort::ID:
+            sortStrategy = std::make_unique<CSortProcessesByID>();
+            break;
+        case TSort::Name:
+            sortStrategy = std::make_unique<CSortProcessesByName>();
+            break;
+        default:
+            throw std::out_of_range("CProcessList::refresh -> sortType is out of range");
+    }
+    sortStrategy->sort(processes);
+
+    const auto processKeys = [](const std::vector<CProcessMemento>& processes) -> std::vector<std::tuple<std::uint32_t, std::string>> {
+        std::vector<std::tuple<std::uint32_t, std::string>> keys{ };
+        for(const auto& process : processes) {
+            keys.emplace_back(process.id(), process.name());
+        }
+        return keys;
+    };
+    const CListChanges changes = CListChanges::compare(processKeys(m_Processes), processKeys(processes));
+
+    m_Processes = std::move(processes);
+    return changes;
+}
+
+void CProcessList::setSortType(TSort sortType) {
+    m_SortType = sortType;
+}
 
+bool CProcessList::isEventDriven() const {
+#ifndef _WIN32
+    return m_Events != std::nullptr_t();
+#else
+    return false;
+#endif
+}
+
+std::vector<CProcessMemento> CProcessList::enumerate() {
+    std::vector<CProcessMemento> processes{ };
+#ifdef _WIN32
     HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
     if(!Utilities::isHandleValid(snapshot))
-        return;
+        return { };
 
     PROCESSENTRY32 entry{ };
     entry.dwSize = sizeof(PROCESSENTRY32);
@@ -62,25 +134,65 @@ void CProcessList::refresh() {
     if(Process32First(snapshot, &entry)) {
         do {
             std::wstring wName{ entry.szExeFile };
-            m_Processes.emplace_back(static_cast<std::uint32_t>(entry.th32ProcessID), std::string(wName.begin(), wName.end()));
+            processes.emplace_back(static_cast<std::uint32_t>(entry.th32ProcessID), std::string(wName.begin(), wName.end()));
         } while(Process32Next(snapshot, &entry));
     }
+    CloseHandle(snapshot);
+#else
+    std::error_code error{ };
+    for(const auto& entry : std::filesystem::directory_iterator("/proc", error)) {
+        const std::string fileName{ entry.path().filename().string() };
+        if(fileName.empty() || !std::all_of(fileName.begin(), fileName.end(), [](char c) { return c >= '0' && c <= '9'; }))
+            continue;
 
-    std::unique_ptr<ISortStrategy<CProcessMemento>> sortStrategy{ std::make_unique<CNoSort<CProcessMemento>>() };
-    switch(CSettingsManager::settings()->processListSortType()) {
-        case CSettings::TSort::None: break;
-        case CSettings::TSort::ID:
-            sortStrategy = std::make_unique<CSortProcessesByID>();
-            break;
-        case CSettings::TSort::Name:
-            sortStrategy = std::make_unique<CSortProcessesByName>();
-            break;
-        default:
-            throw std::out_of_range("CProcessList::refresh -> sortType is out of range");
+        const auto id = static_cast<std::uint32_t>(std::stoul(fileName));
+        std::string name{ CProcessLinuxIO::processName(id) };
+        if(name.empty()) // exited between readdir and open
+            continue;
+
+        processes.emplace_back(id, name);
     }
-    sortStrategy->sort(m_Processes);
+#endif
+    return processes;
 }
 
+#ifndef _WIN32
+std::vector<CProcessMemento> CProcessList::applyEvents(const std::vector<CProcessMemento>& processes, const CProcessEventBatch& batch) {
+    if(batch.isOverrun) {
+        printf("[CProcessList] Process events were lost, rescanning /proc\n");
+        return enumerate();
+    }
+
+    // started also covers exec, the name of a known process is read again and updated in place
+    const std::unordered_set<std::uint32_t> exitedIds{ batch.exited.begin(), batch.exited.end() };
+    std::unordered_set<std::uint32_t> startedIds{ batch.started.begin(), batch.started.end() };
+
+    std::vector<CProcessMemento> result{ };
+    result.reserve(processes.size() + batch.started.size());
+    for(const auto& process : processes) {
+        if(exitedIds.contains(process.id()))
+            continue;
+        if(!startedIds.erase(process.id())) {
+            result.push_back(process);
+            continue;
+        }
+
+        std::string name{ CProcessLinuxIO::processName(process.id()) };
+        if(!name.empty())
+            result.emplace_back(process.id(), name);
+    }
+    for(auto id : batch.started) {
+        if(!startedIds.contains(id))
+            continue;
+
+        std::string name{ CProcessLinuxIO::processName(id) };
+        if(!name.empty()) // already exited, its exit event comes with the next batch
+            result.emplace_back(id, name);
+    }
+    return result;
+}
+#endif
+
 const std::vector<CProcessMemento>& CProcessList::data() const {
     return m_Processes;
 }
@@ -95,7 +207,8 @@ void CSortProcessesByID::sort(std::vector<CProcessMemento>& v) {
 
 void CSortProcessesByName::sort(std::vector<CProcessMemento>& v) {
     std::sort(v.begin(), v.end(), [](const CProcessMemento& p1, const CProcessMemento& p2) -> bool {
-        return p1.name() < p2.name();
+        // ties are broken by id, so kept processes never change their order between refreshes
+        return p1.name() != p2.name() ? p1.name() < p2.name() : p1.id() < p2.id();
     });
 }
 
@@ -110,12 +223,58 @@ const CProcessMemento& IProcessIO::memento() const {
     return m_Memento;
 }
 
-bool IProcessIO::readPages(std::uint64_t startAddress, std::uint32_t size, std::uint8_t* buffer, CBytesProtectionMask* mask) {
+std::size_t IProcessIO::readScatter(std::span<CReadRequest> requests) {
+    std::size_t successfulRequests{ };
+    for(auto& request : requests) {
+        request.isSuccessful = readToBuffer(request.address, request.size, request.buffer);
+        successfulRequests += request.isSuccessful;
+    }
+    return successfulRequests;
+}
+
+std::vector<MBIEx> IProcessIO::regions() {
+    std::vector<MBIEx> result{ };
+    std::uint64_t address{ };
+    while(address < c_MaximumUserAddress) {
+        MBIEx mbi{ query(address) };
+        const std::uint64_t nextAddress = reinterpret_cast<std::uint64_t>(mbi.BaseAddress) + mbi.RegionSize;
+        if(!mbi.RegionSize || nextAddress <= address)
+            break;
+
+        result.push_back(mbi);
+        address = nextAddress;
+    }
+    return result;
+}
+
+std::unique_ptr<IRetrieveModuleListStrategy> IProcessIO::moduleListStrategy() {
+    return { };
+}
+
+MBIEx IProcessIO::queryCached(std::uint64_t address) {
+    return m_RegionMap->query(address);
+}
+
+CRegionMap& IProcessIO::regionMap() {
+    return *m_RegionMap;
+}
+
+bool IProcessIO::readCached(std::uint64_t address, std::uint32_t size, void* buffer) {
+    return m_PageCache->read(address, size, buffer);
+}
+
+CPageCache& IProcessIO::pageCache() {
+    return *m_PageCache;
+}
+
+bool IProcessIO::readPages(std::uint64_t startAddress, std::uint32_t size, std::uint8_t* buffer, CBytesProtectionMask* mask, bool useCache) {
+    CMetricScope metric{ TMetric::ReadPages, size };
+    std::vector<CReadRequest> requests{ }; // readable parts of every region, read in one batch at the end
     std::uint32_t remainingSize{ size }, offset{ 0 };
     int p{ }; // protect against deadloop
     while(remainingSize && ++p < 100) {
         std::uint64_t currentAddress = startAddress + offset;
-        MBIEx mbi{ query(currentAddress) };
+        MBIEx mbi{ queryCached(currentAddress) };
         if(!mbi.BaseAddress && !mbi.AllocationBase) {
             if(mask) mask->setAllProtection(PAGE_NOACCESS);
             return false;
@@ -126,9 +285,8 @@ bool IProcessIO::readPages(std::uint64_t startAddress, std::uint32_t size, std::
         if(toReadSize > remainingSize)
             toReadSize = remainingSize;
 
-        for(std::size_t i = offset; i < offset + toReadSize && mask; ++i) {
-            mask->setProtection(i, mbi.Protect);
-        }
+        if(mask)
+            mask->setProtection(offset, toReadSize, mbi.Protect);
 
         bool canRead = !(mbi.Protect & PAGE_GUARD && mbi.Protect & PAGE_NOACCESS);
         if(!canRead) {
@@ -137,12 +295,45 @@ bool IProcessIO::readPages(std::uint64_t startAddress, std::uint32_t size, std::
             continue;
         }
 
-        readToBuffer(currentAddress, toReadSize, buffer + offset);
+        requests.push_back({ currentAddress, toReadSize, buffer + offset });
 
         remainingSize -= toReadSize;
         offset += toReadSize;
     }
-    return true;
+
+    if(useCache)
+        m_PageCache->readScatter(requests);
+    else
+        readScatter(requests);
+    return metric.succeeded();
+}
+
+std::vector<std::pair<std::size_t, std::size_t>> IProcessIO::readAvailable(std::uint64_t address, std::uint32_t size, void* buffer) {
+    if(readToBuffer(address, size, buffer))
+        return { { 0, size } };
+
+    std::uint8_t* bytes = static_cast<std::uint8_t*>(buffer);
+    std::vector<CReadRequest> requests{ };
+    for(std::uint64_t pageAddress = address; pageAddress < address + size; ) {
+        const std::uint64_t pageEnd = std::min<std::uint64_t>((pageAddress & ~0xfffull) + 0x1000, address + size);
+        requests.push_back({ pageAddress, static_cast<std::uint32_t>(pageEnd - pageAddress), bytes + (pageAddress - address) });
+        pageAddress = pageEnd;
+    }
+    memset(buffer, 0, size);
+    readScatter(requests);
+
+    std::vector<std::pair<std::size_t, std::size_t>> ranges{ };
+    for(const auto& request : requests) {
+        if(!request.isSuccessful)
+            continue;
+
+        const std::size_t offset = request.address - address;
+        if(!ranges.empty() && ranges.back().first + ranges.back().second == offset)
+            ranges.back().second += request.size;
+        else
+            ranges.push_back({ offset, request.size });
+    }
+    return ranges;
 }
 
 std::weak_ptr<CModuleList> IProcessIO::moduleList() const {
@@ -153,10 +344,13 @@ CModuleList::CModuleList(IProcessIO* process)
     : m_ThisProcess{ process } {
     if(!m_ThisProcess)
         throw std::runtime_error("m_ThisProcess can not be nullptr");
+}
 
-    refresh();
+CModuleList::~CModuleList() {
+    stopPrefetch();
 }
 
+#ifdef _WIN32
 std::vector<CModule> CRetrieveModuleListSnapshot::retrieve() const {
     printf("[%s] Retrieving via CreateToolhelp32Snapshot\n", __FUNCTION__);
     if(!m_ThisProcess)
@@ -282,17 +476,35 @@ std::vector<CModule> CRetrieveModuleListPEB::retrieve() const {
     if(!pebLdrData.InLoadOrderModuleList.Flink)
         return { };
 
+    // InLoadOrderLinks is the first member of LDR_DATA_TABLE_ENTRY, so one read per entry yields both the entry and the next link
+    const std::uint64_t listHead{ peb.Ldr + offsetof(PEB_LDR_DATA, InLoadOrderModuleList) };
     std::uint64_t firstLoadedModule{ reinterpret_cast<std::uint64_t>(pebLdrData.InLoadOrderModuleList.Flink) }, loadedModule{ firstLoadedModule };
+    LDR_DATA_TABLE_ENTRY currentEntry{ m_ThisProcess->read<LDR_DATA_TABLE_ENTRY>(firstLoadedModule) };
+    std::vector<LDR_DATA_TABLE_ENTRY> entries{ };
     for(std::size_t i = 0; i < 1000; ++i) {
-        loadedModule = m_ThisProcess->read<std::uint64_t>(loadedModule); // Flink [0x0]
-        if(loadedModule == firstLoadedModule || !loadedModule)
+        loadedModule = reinterpret_cast<std::uint64_t>(currentEntry.InLoadOrderLinks.Flink);
+        if(loadedModule == firstLoadedModule || loadedModule == listHead || !loadedModule)
+            break;
+
+        if(!m_ThisProcess->readToBuffer(loadedModule, sizeof(LDR_DATA_TABLE_ENTRY), &currentEntry))
             break;
+        entries.push_back(currentEntry);
+    }
 
-        LDR_DATA_TABLE_ENTRY entry{ m_ThisProcess->read<LDR_DATA_TABLE_ENTRY>(loadedModule) };
-        std::wstring dllNameW(MAX_PATH, '\00');
-        if(!m_ThisProcess->readToBuffer(reinterpret_cast<std::uint64_t>(entry.BaseDllName.Buffer), 256, dllNameW.data()))
+    // all names in one batch
+    std::vector<std::wstring> dllNames(entries.size(), std::wstring(MAX_PATH, '\00'));
+    std::vector<CReadRequest> nameRequests(entries.size());
+    for(std::size_t i = 0; i < entries.size(); ++i) {
+        nameRequests[i] = { reinterpret_cast<std::uint64_t>(entries[i].BaseDllName.Buffer), 256, dllNames[i].data() };
+    }
+    m_ThisProcess->readScatter(nameRequests);
+
+    for(std::size_t i = 0; i < entries.size(); ++i) {
+        if(!nameRequests[i].isSuccessful)
             continue;
 
+        const auto& entry = entries[i];
+        const std::wstring dllNameW{ dllNames[i].c_str() };
         modules.emplace_back(CModuleMemento(
             reinterpret_cast<std::uint64_t>(entry.DllBase),
             static_cast<std::uint32_t>(entry.SizeOfImage),
@@ -305,62 +517,120 @@ std::vector<CModule> CRetrieveModuleListPEB::retrieve() const {
 
     return modules;
 }
+#endif
 
-void CModuleList::refresh() {
-    cleanup();
-
+CListChanges CModuleList::refresh() {
+    CMetricScope metric{ TMetric::ModuleListRefresh };
+#ifdef _WIN32
     std::unique_ptr<IRetrieveModuleListStrategy> retrieveStrategy{ std::make_unique<CRetrieveModuleListSnapshot>(m_ThisProcess) };
-    switch(CSettingsManager::settings()->moduleListRetrieveMethod()) {
-    case CSettings::TRetrieveMethod::None:
-    case CSettings::TRetrieveMethod::Snapshot: break;
-    case CSettings::TRetrieveMethod::PEB:
+    switch(m_RetrieveMethod) {
+    case TRetrieveMethod::None:
+    case TRetrieveMethod::Snapshot: break;
+    case TRetrieveMethod::PEB:
         retrieveStrategy = std::make_unique<CRetrieveModuleListPEB>(m_ThisProcess);
         break;
     default:
         throw std::out_of_range("CModuleList::refresh -> retrieveMethod is out of range");
     }
-
-    m_Modules = retrieveStrategy->retrieve();
+#else
+    // /proc/<pid>/maps is the only source of loaded images on Linux, the retrieve method does not apply
+    std::unique_ptr<IRetrieveModuleListStrategy> retrieveStrategy{ std::make_unique<CRetrieveModuleListProcMaps>(m_ThisProcess) };
+#endif
+    if(auto processStrategy = m_ThisProcess->moduleListStrategy())
+        retrieveStrategy = std::move(processStrategy);
+
+    std::vector<CModule> modules = retrieveStrategy->retrieve(); // headers are not read here, see prefetchSections()
+
+    // modules are matched by base address and size, a matched one is replaced by the previous object which shares its parsed headers
+    const auto moduleKeys = [](const std::vector<CModule>& modules) -> std::vector<std::tuple<std::uint64_t, std::uint32_t>> {
+        std::vector<std::tuple<std::uint64_t, std::uint32_t>> keys{ };
+        for(const auto& module : modules) {
+            keys.push_back(module.memento().info());
+        }
+        return keys;
+    };
+    const auto previousKeys = moduleKeys(m_Modules);
+    std::map<std::tuple<std::uint64_t, std::uint32_t>, std::size_t> previousRows{ };
+    for(std::size_t i = 0; i < previousKeys.size(); ++i) {
+        previousRows.emplace(previousKeys[i], i);
+    }
+    for(auto& module : modules) {
+        const auto previous = previousRows.find(module.memento().info());
+        if(previous != previousRows.end())
+            module = m_Modules[previous->second];
+    }
 
     std::unique_ptr<ISortStrategy<CModule>> sortStrategy{ std::make_unique<CNoSort<CModule>>() };
-    switch(CSettingsManager::settings()->moduleListSortType()) {
-        case CSettings::TSort::None: break;
-        case CSettings::TSort::ID:
+    switch(m_SortType) {
+        case TSort::None: break;
+        case TSort::ID:
             sortStrategy = std::make_unique<CSortModulesByAddress>();
             break;
-        case CSettings::TSort::Name:
+        case TSort::Name:
             sortStrategy = std::make_unique<CSortModulesByName>();
             break;
         default:
             throw std::out_of_range("CModuleList::refresh -> sortType is out of range");
     }
-    sortStrategy->sort(m_Modules);
+    sortStrategy->sort(modules);
+
+    swapMainModule(modules);
 
-    swapMainModule();
+    const CListChanges changes = CListChanges::compare(previousKeys, moduleKeys(modules));
+    m_Modules = std::move(modules);
+    metric.succeeded();
+    return changes;
+}
+
+void CModuleList::setSortType(TSort sortType) {
+    m_SortType = sortType;
+}
+
+void CModuleList::setRetrieveMethod(TRetrieveMethod retrieveMethod) {
+    m_RetrieveMethod = retrieveMethod;
 }
 
 const std::vector<CModule>& CModuleList::data() const {
     return m_Modules;
 }
 
+bool CListChanges::isEmpty() const {
+    return removedRows.empty() && addedRows.empty() && !isReordered;
+}
+
+void CModuleList::prefetchSections() {
+    stopPrefetch();
+
+    // the thread parses copies of the modules, they share the parsed headers with m_Modules
+    m_PrefetchThread = std::thread([modules = m_Modules]() -> void {
+        CModule::prefetchSections(modules);
+    });
+}
+
+void CModuleList::stopPrefetch() {
+    if(m_PrefetchThread.joinable())
+        m_PrefetchThread.join();
+}
+
 void CModuleList::cleanup() {
+    stopPrefetch();
     m_Modules.clear();
 }
 
-void CModuleList::swapMainModule() {
+void CModuleList::swapMainModule(std::vector<CModule>& modules) {
     const auto& processName = m_ThisProcess->memento().name();
     if(processName.empty())
         return;
 
-    const auto mainModuleIterator = std::find_if(m_Modules.begin(), m_Modules.end(), [&processName](const CModule& module) -> bool {
+    const auto mainModuleIterator = std::find_if(modules.begin(), modules.end(), [&processName](const CModule& module) -> bool {
         if(module.memento().name() == processName)
             return true;
         return false;
     });
-    if(mainModuleIterator == m_Modules.end())
+    if(mainModuleIterator == modules.end())
         return;
 
-    std::swap(*m_Modules.begin(), *mainModuleIterator);
+    std::swap(*modules.begin(), *mainModuleIterator);
 }
 
 void CSortModulesByAddress::sort(std::vector<CModule>& v) {
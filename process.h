@@ -1,9 +1,18 @@
 #pragma once
 #include "utilities.h"
 #include "module.h"
-#include <Windows.h>
+#include "region_map.h"
+#include "page_cache.h"
+#include "metrics.h"
+#include "platform.h"
 #include <vector>
+#include <span>
+#include <set>
+#include <thread>
 #include <QObject>
+#ifndef _WIN32
+#include "process_events.h"
+#endif
 
 class CProcessMemento final : public IFormattable {
 public:
@@ -38,21 +47,89 @@ public:
     void sort(std::vector<CProcessMemento>& v) override;
 };
 
+// rows changed by a refresh of CProcessList or CModuleList, removing removedRows and then inserting addedRows turns the
+// previous rows into the new ones
+struct CListChanges {
+    std::vector<std::size_t> removedRows{ }; // rows of the previous list, descending
+    std::vector<std::size_t> addedRows{ }; // rows of the new list, ascending
+    // entries which were kept changed their order (the sort type changed for example), all rows have to be rebuilt
+    bool isReordered{ };
+
+    bool isEmpty() const;
+
+    // keys identify entries and must be unique within each list
+    template<typename K>
+    static CListChanges compare(const std::vector<K>& previous, const std::vector<K>& current) {
+        const std::set<K> previousKeys(previous.begin(), previous.end()), currentKeys(current.begin(), current.end());
+
+        CListChanges changes{ };
+        std::vector<K> keptBefore{ }, keptAfter{ };
+        for(std::size_t i = 0; i < previous.size(); ++i) {
+            if(!currentKeys.contains(previous[i]))
+                changes.removedRows.push_back(i);
+            else
+                keptBefore.push_back(previous[i]);
+        }
+        for(std::size_t i = 0; i < current.size(); ++i) {
+            if(!previousKeys.contains(current[i]))
+                changes.addedRows.push_back(i);
+            else
+                keptAfter.push_back(current[i]);
+        }
+        std::reverse(changes.removedRows.begin(), changes.removedRows.end());
+        changes.isReordered = keptBefore != keptAfter;
+        return changes;
+    }
+};
+
 class CProcessList final {
 public:
-    CProcessList();
-    ~CProcessList() = default;
+    // useEvents: subscribe to process events where they are available, one-shot listings skip the subscription
+    explicit CProcessList(TSort sortType = TSort::Name, bool useEvents = true);
+    ~CProcessList();
 
     // copy/move later
 public:
-    void refresh();
+    // with process events only the processes which started or exited since the previous refresh are looked at, otherwise
+    // (and after events were lost) all processes are enumerated again. Kept processes keep their order either way
+    CListChanges refresh();
+    // @return Returns true when refresh() is driven by process events
+    bool isEventDriven() const;
+    // takes effect on the next refresh()
+    void setSortType(TSort sortType);
     const std::vector<CProcessMemento>& data() const;
     void cleanup();
+#ifndef _WIN32
+    // @return Returns processes with batch applied, all processes are enumerated again when events were lost
+    static std::vector<CProcessMemento> applyEvents(const std::vector<CProcessMemento>& processes, const CProcessEventBatch& batch);
+#endif
 private:
+    static std::vector<CProcessMemento> enumerate();
+
     std::vector<CProcessMemento> m_Processes{ };
+    TSort m_SortType{ };
+#ifndef _WIN32
+    std::unique_ptr<CProcessEvents> m_Events{ };
+#endif
 };
 
 class CModuleList;
+class IRetrieveModuleListStrategy;
+
+// how CModuleList enumerates modules on Windows, Linux always parses /proc/<pid>/maps
+enum class TRetrieveMethod {
+    None,
+    Snapshot,
+    PEB,
+};
+
+// one range of a scatter read, isSuccessful is filled by IProcessIO::readScatter
+struct CReadRequest {
+    std::uint64_t address{ };
+    std::uint32_t size{ };
+    void* buffer{ };
+    bool isSuccessful{ };
+};
 
 class IProcessIO : public QObject {
     Q_OBJECT
@@ -68,9 +145,30 @@ public:
     virtual MBIEx query(std::uint64_t address) = 0;
     // @return Returns true and oldProtect on success, false and 0 otherwise
     virtual std::tuple<bool, std::uint32_t> protect(std::uint64_t address, std::uint32_t size, std::uint32_t flags) = 0;
+    // Reads every request into its buffer, a failed request does not stop the others. The default implementation
+    // loops over readToBuffer, backends with a vectored read primitive override it to serve many ranges per syscall
+    // @return Returns the number of successful requests
+    virtual std::size_t readScatter(std::span<CReadRequest> requests);
+    // All regions up to the end of the user space, free ones included. The default implementation walks query(),
+    // backends which can enumerate the address space at once override it
+    virtual std::vector<MBIEx> regions();
+    // Strategy CModuleList::refresh uses for this process, nullptr (the default) lets it pick the platform one by its retrieve method
+    virtual std::unique_ptr<IRetrieveModuleListStrategy> moduleListStrategy();
+
+    // query() served from the region map, no syscall while the snapshot is fresh
+    MBIEx queryCached(std::uint64_t address);
+    CRegionMap& regionMap();
 
     // invalidMask: 0 - regular byte, 1 - invalid (page protection or something else), 2 - guarded byte
-    bool readPages(std::uint64_t startAddress, std::uint32_t size, std::uint8_t* buffer, CBytesProtectionMask* mask = std::nullptr_t());
+    // useCache: serve pages from the page cache, for views which re-read the same window repeatedly
+    bool readPages(std::uint64_t startAddress, std::uint32_t size, std::uint8_t* buffer, CBytesProtectionMask* mask = std::nullptr_t(), bool useCache = false);
+    // Reads whatever is readable in [address, address + size), bytes of pages which failed are zeroed.
+    // One readToBuffer when everything is readable, otherwise one readScatter over the pages
+    // @return Returns the readable parts as (offset, size) pairs relative to address, ascending
+    std::vector<std::pair<std::size_t, std::size_t>> readAvailable(std::uint64_t address, std::uint32_t size, void* buffer);
+    // readToBuffer served from the page cache
+    bool readCached(std::uint64_t address, std::uint32_t size, void* buffer);
+    CPageCache& pageCache();
 
     template<typename R>
     inline R read(std::uint64_t address) {
@@ -85,8 +183,12 @@ public:
     }
 
     std::weak_ptr<CModuleList> moduleList() const;
+protected:
+    static constexpr std::uint64_t c_MaximumUserAddress{ 0x7fffffffffff };
 private:
     CProcessMemento m_Memento;
+    std::unique_ptr<CRegionMap> m_RegionMap{ std::make_unique<CRegionMap>(this) };
+    std::unique_ptr<CPageCache> m_PageCache{ std::make_unique<CPageCache>(this) };
 protected:
     std::shared_ptr<CModuleList> m_ModuleList;
 signals:
@@ -114,6 +216,7 @@ protected:
     IProcessIO* m_ThisProcess{ std::nullptr_t() }; // required for CModule
 };
 
+#ifdef _WIN32
 class CRetrieveModuleListEnumerate : public IRetrieveModuleListStrategy {
 public:
     CRetrieveModuleListEnumerate(IProcessIO* thisProcess, HANDLE hProcess)
@@ -139,19 +242,33 @@ public:
 
     virtual std::vector<CModule> retrieve() const override;
 };
+#endif
 
 // must be instantiated in IProcessIO context
 class CModuleList final {
 public:
     CModuleList(IProcessIO* process);
-    ~CModuleList() = default;
+    ~CModuleList();
 public:
-    void refresh();
+    // only enumerates modules, their headers are read when sections are first needed. Modules with the same base address
+    // and size as before are kept with their parsed sections. The list is empty until the first refresh
+    CListChanges refresh();
+    // both take effect on the next refresh()
+    void setSortType(TSort sortType);
+    void setRetrieveMethod(TRetrieveMethod retrieveMethod);
+    // reads headers of all modules in one batch on a background thread, sections() of a module which is
+    // requested before the batch completes are still parsed on demand
+    void prefetchSections();
     const std::vector<CModule>& data() const;
+    // also waits for the prefetch, the owning IProcessIO calls it before it closes its access to the process
     void cleanup();
 private:
-    void swapMainModule();
+    void swapMainModule(std::vector<CModule>& modules);
+    void stopPrefetch();
 
     IProcessIO* m_ThisProcess{ };
     std::vector<CModule> m_Modules{ };
+    TSort m_SortType{ TSort::Name };
+    TRetrieveMethod m_RetrieveMethod{ TRetrieveMethod::Snapshot };
+    std::thread m_PrefetchThread{ };
 };
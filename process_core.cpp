@@ -0,0 +1,269 @@
+#include "process_core.h"
+
+#include <elf.h>
+#include <sys/procfs.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <numeric>
+
+namespace {
+std::uint64_t alignNote(std::uint64_t size) {
+    return (size + 3) & ~3ull;
+}
+}
+
+CCoreFile::CCoreFile(const std::string& path) {
+    const int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat fileStat{ };
+    if(file == -1 || fstat(file, &fileStat) == -1) {
+        if(file != -1)
+            ::close(file);
+        throw std::runtime_error("Can not open core " + path);
+    }
+
+    m_Size = static_cast<std::uint64_t>(fileStat.st_size);
+    void* view = m_Size ? mmap(std::nullptr_t(), m_Size, PROT_READ, MAP_PRIVATE, file, 0) : MAP_FAILED;
+    ::close(file);
+    if(view == MAP_FAILED)
+        throw std::runtime_error("Can not map core " + path);
+    m_View = static_cast<const std::uint8_t*>(view);
+
+    const auto* elfHeader = reinterpret_cast<const Elf64_Ehdr*>(m_View);
+    const bool isCore =
+        m_Size >= sizeof(Elf64_Ehdr) &&
+        !memcmp(elfHeader->e_ident, ELFMAG, SELFMAG) &&
+        elfHeader->e_ident[EI_CLASS] == ELFCLASS64 &&
+        elfHeader->e_type == ET_CORE &&
+        elfHeader->e_phentsize == sizeof(Elf64_Phdr);
+    if(!isCore) {
+        close();
+        throw std::runtime_error("Not a 64-bit ELF core: " + path);
+    }
+
+    // with more than PN_XNUM segments the real count is kept in the first section header
+    std::uint64_t segmentCount = elfHeader->e_phnum;
+    if(segmentCount == PN_XNUM && elfHeader->e_shoff && elfHeader->e_shoff + sizeof(Elf64_Shdr) <= m_Size)
+        segmentCount = reinterpret_cast<const Elf64_Shdr*>(m_View + elfHeader->e_shoff)->sh_info;
+    if(elfHeader->e_phoff + segmentCount * sizeof(Elf64_Phdr) > m_Size) {
+        close();
+        throw std::runtime_error("Truncated core: " + path);
+    }
+    const std::span<const Elf64_Phdr> segments{ reinterpret_cast<const Elf64_Phdr*>(m_View + elfHeader->e_phoff), segmentCount };
+
+    std::vector<CFileMapping> fileMappings{ };
+    std::uint32_t processId{ };
+    std::string processName{ std::filesystem::path(path).filename().string() };
+    for(const auto& segment : segments) {
+        if(segment.p_type == PT_NOTE && segment.p_offset + segment.p_filesz <= m_Size)
+            parseNotes({ m_View + segment.p_offset, segment.p_filesz }, fileMappings, processId, processName);
+    }
+    m_Memento = CProcessMemento(processId, processName);
+
+    std::sort(fileMappings.begin(), fileMappings.end(), [](const CFileMapping& a, const CFileMapping& b) -> bool { return a.start < b.start; });
+    for(const auto& segment : segments) {
+        if(segment.p_type != PT_LOAD || !segment.p_memsz)
+            continue;
+
+        CProcMapsEntry entry{ };
+        entry.start = segment.p_vaddr;
+        entry.end = segment.p_vaddr + segment.p_memsz;
+        entry.protection = CProcessLinuxIO::protectionFromPermissions(segment.p_flags & PF_R, segment.p_flags & PF_W, segment.p_flags & PF_X);
+
+        // NT_FILE lists file-backed mappings, each of them is one PT_LOAD segment
+        const auto fileMapping = std::lower_bound(fileMappings.begin(), fileMappings.end(), entry.start, [](const CFileMapping& mapping, std::uint64_t start) -> bool {
+            return mapping.start < start;
+        });
+        if(fileMapping != fileMappings.end() && fileMapping->start == entry.start) {
+            entry.path = fileMapping->path;
+            entry.offset = fileMapping->offset;
+        }
+
+        // the kernel leaves p_filesz at 0 for segments it did not dump (filtered out by coredump_filter or unreadable)
+        const std::uint64_t dumpedSize = segment.p_offset < m_Size ? std::min({ segment.p_filesz, segment.p_memsz, m_Size - segment.p_offset }) : 0;
+        if(dumpedSize == segment.p_memsz) {
+            m_Maps.push_back(entry);
+            m_Data.push_back(m_View + segment.p_offset);
+            continue;
+        }
+
+        if(dumpedSize) {
+            CProcMapsEntry dumpedEntry{ entry };
+            dumpedEntry.end = entry.start + dumpedSize;
+            m_Maps.push_back(dumpedEntry);
+            m_Data.push_back(m_View + segment.p_offset);
+        }
+        entry.start += dumpedSize;
+        entry.protection = PAGE_NOACCESS;
+        m_Maps.push_back(entry);
+        m_Data.push_back(std::nullptr_t());
+    }
+
+    // segments are sorted by the kernel, this only guards against hand-made cores
+    std::vector<std::size_t> order(m_Maps.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) -> bool { return m_Maps[a].start < m_Maps[b].start; });
+    std::vector<CProcMapsEntry> maps{ };
+    std::vector<const std::uint8_t*> data{ };
+    for(auto i : order) {
+        maps.push_back(std::move(m_Maps[i]));
+        data.push_back(m_Data[i]);
+    }
+    m_Maps = std::move(maps);
+    m_Data = std::move(data);
+}
+
+CCoreFile::~CCoreFile() {
+    close();
+}
+
+void CCoreFile::close() {
+    if(m_View)
+        munmap(const_cast<std::uint8_t*>(m_View), m_Size);
+    m_View = { };
+}
+
+void CCoreFile::parseNotes(std::span<const std::uint8_t> notes, std::vector<CFileMapping>& fileMappings, std::uint32_t& processId, std::string& processName) const {
+    std::string fileName{ };
+    for(std::uint64_t offset = 0; offset + sizeof(Elf64_Nhdr) <= notes.size(); ) {
+        const auto* note = reinterpret_cast<const Elf64_Nhdr*>(notes.data() + offset);
+        const std::uint64_t descriptorOffset = offset + sizeof(Elf64_Nhdr) + alignNote(note->n_namesz);
+        const std::uint64_t nextOffset = descriptorOffset + alignNote(note->n_descsz);
+        if(nextOffset > notes.size())
+            break;
+
+        const auto descriptor = notes.subspan(descriptorOffset, note->n_descsz);
+        if(note->n_type == NT_PRPSINFO && descriptor.size() >= sizeof(elf_prpsinfo)) {
+            const auto* processInfo = reinterpret_cast<const elf_prpsinfo*>(descriptor.data());
+            processId = static_cast<std::uint32_t>(processInfo->pr_pid);
+            fileName.assign(processInfo->pr_fname, strnlen(processInfo->pr_fname, sizeof(processInfo->pr_fname)));
+        }
+        else if(note->n_type == NT_FILE && descriptor.size() >= 2 * sizeof(std::uint64_t)) {
+            // count, page size, count * (start, end, page offset), count NUL-terminated paths
+            const auto* header = reinterpret_cast<const std::uint64_t*>(descriptor.data());
+            const std::uint64_t count = header[0], pageSize = header[1];
+            if(count <= descriptor.size() / (3 * sizeof(std::uint64_t)) && (2 + count * 3) * sizeof(std::uint64_t) <= descriptor.size()) {
+                const char* path = reinterpret_cast<const char*>(header + 2 + count * 3);
+                const char* pathsEnd = reinterpret_cast<const char*>(descriptor.data() + descriptor.size());
+                for(std::uint64_t i = 0; i < count && path < pathsEnd; ++i) {
+                    const std::size_t pathSize = strnlen(path, pathsEnd - path);
+                    fileMappings.push_back({ header[2 + i * 3], header[3 + i * 3], header[4 + i * 3] * pageSize, std::string(path, pathSize) });
+                    path += pathSize + 1;
+                }
+            }
+        }
+        offset = nextOffset;
+    }
+
+    // pr_fname is cut to 15 characters, the mapped executable has the full name (CModuleList puts the module with it first)
+    if(fileName.empty())
+        return;
+    processName = fileName;
+    for(const auto& fileMapping : fileMappings) {
+        const std::string mappedName = std::filesystem::path(fileMapping.path).filename().string();
+        if(mappedName.starts_with(fileName)) {
+            processName = mappedName;
+            break;
+        }
+    }
+}
+
+const CProcessMemento& CCoreFile::memento() const {
+    return m_Memento;
+}
+
+const std::vector<CProcMapsEntry>& CCoreFile::maps() const {
+    return m_Maps;
+}
+
+std::span<const std::uint8_t> CCoreFile::view(std::uint64_t address, std::uint64_t size) const {
+    const auto entry = std::upper_bound(m_Maps.begin(), m_Maps.end(), address, [](std::uint64_t a, const CProcMapsEntry& e) -> bool {
+        return a < e.end;
+    });
+    if(entry == m_Maps.end() || entry->start > address || size > entry->end - address)
+        return { };
+
+    const std::uint8_t* data = m_Data[entry - m_Maps.begin()];
+    if(!data)
+        return { };
+
+    return { data + (address - entry->start), size };
+}
+
+CProcessCoreIO::CProcessCoreIO(const std::string& path)
+    : CProcessCoreIO(std::make_unique<CCoreFile>(path)) { }
+
+CProcessCoreIO::CProcessCoreIO(std::unique_ptr<CCoreFile> core)
+    : IProcessIO{ core->memento() }, m_Core{ std::move(core) } {
+    printf("[CProcessCoreIO] Opening core of: %s\n", memento().name().c_str());
+
+    m_ModuleList = std::make_unique<CModuleList>(this);
+}
+
+CProcessCoreIO::~CProcessCoreIO() {
+    m_ModuleList->cleanup();
+    printf("[~CProcessCoreIO] Closing core of: %s\n", memento().name().c_str());
+}
+
+bool CProcessCoreIO::readToBuffer(std::uint64_t address, std::uint32_t size, void* buffer) {
+    CMetricScope metric{ TMetric::ReadToBuffer, size };
+    // a read may span neighbouring segments, each one is a separate part of the file. The entries are looked up once
+    // and walked in order instead of a query() per segment
+    const auto& maps = m_Core->maps();
+    auto entry = std::upper_bound(maps.begin(), maps.end(), address, [](std::uint64_t a, const CProcMapsEntry& e) -> bool {
+        return a < e.end;
+    });
+    auto* out = static_cast<std::uint8_t*>(buffer);
+    for(; size; ++entry) {
+        if(entry == maps.end() || entry->start > address) // unmapped gap
+            return false;
+
+        const std::uint32_t toCopy = static_cast<std::uint32_t>(std::min<std::uint64_t>(size, entry->end - address));
+        const auto data = m_Core->view(address, toCopy);
+        if(data.empty())
+            return false;
+
+        memcpy(out, data.data(), toCopy);
+        out += toCopy;
+        address += toCopy;
+        size -= toCopy;
+    }
+    return metric.succeeded();
+}
+
+bool CProcessCoreIO::writeFromBuffer(std::uint64_t, std::uint32_t size, void*) {
+    const CMetricScope metric{ TMetric::WriteFromBuffer, size };
+    return false;
+}
+
+MBIEx CProcessCoreIO::query(std::uint64_t address) {
+    CMetricScope metric{ TMetric::Query };
+    metric.succeeded();
+    return CProcessLinuxIO::regionFromMaps(m_Core->maps(), address);
+}
+
+std::tuple<bool, std::uint32_t> CProcessCoreIO::protect(std::uint64_t, std::uint32_t, std::uint32_t) {
+    const CMetricScope metric{ TMetric::Protect };
+    return { };
+}
+
+std::vector<MBIEx> CProcessCoreIO::regions() {
+    return CProcessLinuxIO::regionsFromMaps(m_Core->maps());
+}
+
+std::unique_ptr<IRetrieveModuleListStrategy> CProcessCoreIO::moduleListStrategy() {
+    return std::make_unique<CRetrieveModuleListCore>(this, m_Core.get());
+}
+
+std::span<const std::uint8_t> CProcessCoreIO::view(std::uint64_t address, std::uint64_t size) const {
+    return m_Core->view(address, size);
+}
+
+std::vector<CModule> CRetrieveModuleListCore::retrieve() const {
+    printf("[%s] Retrieving via NT_FILE notes\n", __FUNCTION__);
+    if(!m_ThisProcess || !m_Core)
+        return { };
+
+    return CRetrieveModuleListProcMaps::modulesFromMaps(m_ThisProcess, m_Core->maps());
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include "process_linux.h"
+
+// Read-only mapping of a 64-bit ELF core dump. PT_LOAD segments become /proc/<pid>/maps like entries, NT_FILE notes
+// give them their paths, NT_PRPSINFO gives the process id and name
+class CCoreFile {
+public:
+    // throws std::runtime_error when the file can not be mapped or is not a 64-bit ELF core
+    CCoreFile(const std::string& path);
+    ~CCoreFile();
+
+    CCoreFile(const CCoreFile&) = delete;
+    CCoreFile& operator=(const CCoreFile&) = delete;
+
+    const CProcessMemento& memento() const;
+    // sorted by start, the parts of segments which were not written to the core are separate PAGE_NOACCESS entries
+    const std::vector<CProcMapsEntry>& maps() const;
+    // @return Returns the bytes of the core backing [address, address + size) inside a single entry, empty when they are not in the core
+    std::span<const std::uint8_t> view(std::uint64_t address, std::uint64_t size) const;
+private:
+    struct CFileMapping {
+        std::uint64_t start{ }, end{ }, offset{ };
+        std::string path{ };
+    };
+
+    void parseNotes(std::span<const std::uint8_t> notes, std::vector<CFileMapping>& fileMappings, std::uint32_t& processId, std::string& processName) const;
+    void close();
+
+    const std::uint8_t* m_View{ };
+    std::uint64_t m_Size{ };
+
+    CProcessMemento m_Memento{ 0, "" };
+    std::vector<CProcMapsEntry> m_Maps{ };
+    std::vector<const std::uint8_t*> m_Data{ }; // one per entry of m_Maps, nullptr when the entry is not in the core
+};
+
+// IProcessIO over a core dump, nothing is read until it is touched and reads are a memcpy out of the mapping.
+// Captured memory is never modified, so writes and protection changes always fail
+class CProcessCoreIO : public IProcessIO {
+public:
+    // throws std::runtime_error the same way CCoreFile does
+    CProcessCoreIO(const std::string& path);
+    virtual ~CProcessCoreIO();
+
+    virtual bool readToBuffer(std::uint64_t address, std::uint32_t size, void* buffer) override;
+    virtual bool writeFromBuffer(std::uint64_t address, std::uint32_t size, void* buffer) override;
+    virtual MBIEx query(std::uint64_t address) override;
+    virtual std::tuple<bool, std::uint32_t> protect(std::uint64_t address, std::uint32_t size, std::uint32_t flags) override;
+    virtual std::vector<MBIEx> regions() override;
+    virtual std::unique_ptr<IRetrieveModuleListStrategy> moduleListStrategy() override;
+
+    // zero-copy access to the captured bytes, see CCoreFile::view
+    std::span<const std::uint8_t> view(std::uint64_t address, std::uint64_t size) const;
+private:
+    CProcessCoreIO(std::unique_ptr<CCoreFile> core);
+
+    std::unique_ptr<CCoreFile> m_Core;
+};
+
+class CRetrieveModuleListCore : public IRetrieveModuleListStrategy {
+public:
+    CRetrieveModuleListCore(IProcessIO* thisProcess, const CCoreFile* core)
+        : IRetrieveModuleListStrategy(thisProcess), m_Core{ core } { }
+
+    virtual std::vector<CModule> retrieve() const override;
+private:
+    const CCoreFile* m_Core{ };
+};
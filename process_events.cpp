@@ -0,0 +1,164 @@
+#include "process_events.h"
+
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+CProcessEvents::CProcessEvents() {
+    m_Socket = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    m_StopEvent = eventfd(0, EFD_CLOEXEC);
+    if(m_Socket == -1 || m_StopEvent == -1) {
+        close();
+        throw std::runtime_error("Can not create a netlink connector socket");
+    }
+
+    // best effort, a larger buffer only makes overruns rarer
+    const int receiveBufferSize{ c_ReceiveBufferSize };
+    if(setsockopt(m_Socket, SOL_SOCKET, SO_RCVBUFFORCE, &receiveBufferSize, sizeof(receiveBufferSize)) == -1)
+        setsockopt(m_Socket, SOL_SOCKET, SO_RCVBUF, &receiveBufferSize, sizeof(receiveBufferSize));
+
+    sockaddr_nl address{ };
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = CN_IDX_PROC;
+    if(bind(m_Socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1) {
+        close();
+        throw std::runtime_error("Can not bind to the proc connector (" + std::string(strerror(errno)) + ")");
+    }
+
+    const proc_cn_mcast_op operation{ PROC_CN_MCAST_LISTEN };
+    alignas(nlmsghdr) std::uint8_t request[NLMSG_SPACE(sizeof(cn_msg) + sizeof(operation))]{ };
+    auto* header = reinterpret_cast<nlmsghdr*>(request);
+    header->nlmsg_len = NLMSG_LENGTH(sizeof(cn_msg) + sizeof(operation));
+    header->nlmsg_type = NLMSG_DONE;
+    header->nlmsg_pid = static_cast<std::uint32_t>(getpid());
+    auto* message = static_cast<cn_msg*>(NLMSG_DATA(header));
+    message->id = { CN_IDX_PROC, CN_VAL_PROC };
+    message->len = sizeof(operation);
+    memcpy(message->data, &operation, sizeof(operation));
+    if(send(m_Socket, request, header->nlmsg_len, 0) != static_cast<ssize_t>(header->nlmsg_len)) {
+        close();
+        throw std::runtime_error("Can not subscribe to process events (" + std::string(strerror(errno)) + ")");
+    }
+
+    m_ReaderThread = std::thread(&CProcessEvents::readEvents, this);
+}
+
+CProcessEvents::~CProcessEvents() {
+    const std::uint64_t stop{ 1 };
+    if(write(m_StopEvent, &stop, sizeof(stop)) != sizeof(stop))
+        printf("[~CProcessEvents] Can not wake the reader thread up (%d)\n", errno);
+
+    if(m_ReaderThread.joinable())
+        m_ReaderThread.join();
+    close();
+}
+
+void CProcessEvents::close() {
+    if(m_Socket != -1)
+        ::close(m_Socket);
+    if(m_StopEvent != -1)
+        ::close(m_StopEvent);
+    m_Socket = m_StopEvent = -1;
+}
+
+CProcessEventBatch CProcessEvents::take() {
+    std::unordered_map<std::uint32_t, bool> pending{ };
+    bool isOverrun{ };
+    {
+        std::scoped_lock lock{ m_Mutex };
+        std::swap(pending, m_Pending);
+        isOverrun = m_IsOverrun;
+        m_IsOverrun = false;
+    }
+
+    auto batch = toBatch(pending);
+    batch.isOverrun = isOverrun;
+    return batch;
+}
+
+CProcessEventBatch CProcessEvents::toBatch(const std::unordered_map<std::uint32_t, bool>& pending) {
+    CProcessEventBatch batch{ };
+    for(const auto& [id, isAlive] : pending) {
+        (isAlive ? batch.started : batch.exited).push_back(id);
+    }
+    return batch;
+}
+
+bool CProcessEvents::isBroken() {
+    std::scoped_lock lock{ m_Mutex };
+    return m_IsBroken;
+}
+
+void CProcessEvents::readEvents() {
+    std::vector<std::uint8_t> buffer(0x2000);
+    pollfd descriptors[2]{ { m_Socket, POLLIN, 0 }, { m_StopEvent, POLLIN, 0 } };
+    for(;;) {
+        if(poll(descriptors, 2, -1) == -1) {
+            if(errno == EINTR)
+                continue;
+            std::scoped_lock lock{ m_Mutex };
+            m_IsOverrun = m_IsBroken = true;
+            break;
+        }
+        if(descriptors[1].revents)
+            break;
+
+        const ssize_t received = recv(m_Socket, buffer.data(), buffer.size(), MSG_DONTWAIT);
+        if(received == -1 && errno == ENOBUFS) {
+            std::scoped_lock lock{ m_Mutex };
+            m_IsOverrun = true;
+            continue;
+        }
+        if(received == -1 && (errno == EAGAIN || errno == EINTR))
+            continue;
+        if(received <= 0) {
+            printf("[CProcessEvents] Reading the proc connector failed (%d)\n", errno);
+            std::scoped_lock lock{ m_Mutex };
+            m_IsOverrun = m_IsBroken = true; // nothing arrives from now on, the owner goes back to rescans
+            break;
+        }
+
+        std::scoped_lock lock{ m_Mutex };
+        parseMessage(buffer.data(), static_cast<std::size_t>(received), m_Pending);
+    }
+}
+
+void CProcessEvents::parseMessage(const std::uint8_t* data, std::size_t size, std::unordered_map<std::uint32_t, bool>& pending) {
+    int remaining = static_cast<int>(size);
+    for(auto* header = reinterpret_cast<const nlmsghdr*>(data); NLMSG_OK(header, remaining); header = NLMSG_NEXT(header, remaining)) {
+        if(header->nlmsg_type == NLMSG_NOOP || header->nlmsg_type == NLMSG_ERROR)
+            continue;
+        if(header->nlmsg_len < NLMSG_LENGTH(sizeof(cn_msg) + sizeof(proc_event)))
+            continue;
+
+        const auto* message = static_cast<const cn_msg*>(NLMSG_DATA(header));
+        if(message->id.idx != CN_IDX_PROC || message->id.val != CN_VAL_PROC)
+            continue;
+
+        // threads produce the same events, only the ones of thread group leaders describe processes
+        const auto* event = reinterpret_cast<const proc_event*>(message->data);
+        switch(event->what) {
+        case proc_event::PROC_EVENT_FORK:
+            if(event->event_data.fork.child_pid == event->event_data.fork.child_tgid)
+                pending[static_cast<std::uint32_t>(event->event_data.fork.child_tgid)] = true;
+            break;
+        case proc_event::PROC_EVENT_EXEC:
+            pending[static_cast<std::uint32_t>(event->event_data.exec.process_tgid)] = true;
+            break;
+        case proc_event::PROC_EVENT_EXIT:
+            if(event->event_data.exit.process_pid == event->event_data.exit.process_tgid)
+                pending[static_cast<std::uint32_t>(event->event_data.exit.process_tgid)] = false;
+            break;
+        default:
+            break;
+        }
+    }
+}
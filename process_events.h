@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <thread>
+
+// process ids which started (forked or exec'd) or exited since the previous CProcessEvents::take()
+struct CProcessEventBatch {
+    std::vector<std::uint32_t> started{ }, exited{ };
+    // the socket overflowed and events were lost, the whole process list has to be enumerated again
+    bool isOverrun{ };
+};
+
+// Process start and exit notifications from the netlink proc connector. A thread reads the socket and coalesces the
+// events per process id, so a burst of short-lived processes costs one map entry each and no /proc access
+class CProcessEvents final {
+public:
+    // throws std::runtime_error when the connector is unavailable (no CAP_NET_ADMIN or a kernel without CONFIG_PROC_EVENTS)
+    CProcessEvents();
+    ~CProcessEvents();
+
+    CProcessEvents(const CProcessEvents&) = delete;
+    CProcessEvents& operator=(const CProcessEvents&) = delete;
+
+    CProcessEventBatch take();
+    // the reader thread stopped after a socket error, no events arrive anymore and take() never clears it
+    bool isBroken();
+
+    // coalesces the events of one datagram into pending, id -> is alive after its last event
+    static void parseMessage(const std::uint8_t* data, std::size_t size, std::unordered_map<std::uint32_t, bool>& pending);
+    static CProcessEventBatch toBatch(const std::unordered_map<std::uint32_t, bool>& pending);
+private:
+    static constexpr int c_ReceiveBufferSize{ 0x400000 };
+
+    void readEvents();
+    void close();
+
+    int m_Socket{ -1 };
+    int m_StopEvent{ -1 }; // eventfd which wakes readEvents() up on destruction
+
+    std::mutex m_Mutex{ };
+    std::unordered_map<std::uint32_t, bool> m_Pending{ }; // id -> is alive after its last event
+    bool m_IsOverrun{ };
+    bool m_IsBroken{ };
+
+    std::thread m_ReaderThread{ };
+};
@@ -0,0 +1,319 @@
+#include "process_linux.h"
+
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <cerrno>
+#include <cinttypes>
+
+CProcessLinuxIO::CProcessLinuxIO(const CProcessMemento& process)
+    : IProcessIO{ process } {
+    tryAttach();
+    printf("[CProcessLinuxIO] Attaching: %s\n", memento().name().c_str());
+
+    m_ModuleList = std::make_unique<CModuleList>(this);
+}
+
+CProcessLinuxIO::CProcessLinuxIO(std::uint32_t id)
+    : IProcessIO{ id } { }
+
+CProcessLinuxIO::~CProcessLinuxIO() {
+    if(m_ModuleList) // the id constructor does not create one
+        m_ModuleList->cleanup();
+    detach();
+    printf("[~CProcessLinuxIO] Detaching: %s\n", memento().name().c_str());
+}
+
+bool CProcessLinuxIO::isAttached() {
+    if(m_IsWatched)
+        return m_IsAlive.load(std::memory_order_relaxed);
+    if(m_MemoryFd == -1)
+        return false;
+
+    // without a pidfd every access checks, EPERM still means the process exists
+    if(!kill(static_cast<pid_t>(memento().id()), 0) || errno == EPERM)
+        return true;
+
+    onProcessExit();
+    return false;
+}
+
+void CProcessLinuxIO::onProcessExit() {
+    if(m_IsAlive.exchange(false))
+        emit IProcessIO::invalidProcessSignal();
+}
+
+std::uint32_t CProcessLinuxIO::exitCode() const {
+    return m_ExitCode;
+}
+
+bool CProcessLinuxIO::tryAttach() {
+    if(static_cast<std::uint32_t>(getpid()) == memento().id())
+        return false;
+
+    // opening /proc/<pid>/mem performs the same PTRACE_MODE_ATTACH check as process_vm_readv, so it doubles as an access test
+    const std::string memPath{ "/proc/" + std::to_string(memento().id()) + "/mem" };
+    m_MemoryFd = open(memPath.c_str(), O_RDWR | O_CLOEXEC);
+    if(m_MemoryFd == -1)
+        m_MemoryFd = open(memPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if(m_MemoryFd == -1)
+        return false;
+
+    m_IsAlive = true;
+    m_Watcher = std::make_unique<CProcessWatcher>(memento().id(), [this]() -> void { onProcessExit(); });
+    m_IsWatched = m_Watcher->isWatching();
+    return isAttached();
+}
+
+void CProcessLinuxIO::detach() {
+    // no exit notification may arrive while the object is destroyed
+    m_Watcher.reset();
+    m_IsWatched = false;
+    m_IsAlive = false;
+    if(m_MemoryFd == -1)
+        return;
+
+    close(m_MemoryFd);
+    m_MemoryFd = -1;
+}
+
+bool CProcessLinuxIO::readToBuffer(std::uint64_t address, std::uint32_t size, void* buffer) {
+    CMetricScope metric{ TMetric::ReadToBuffer, size };
+    if(!isAttached())
+        return { };
+
+    iovec local{ buffer, size };
+    iovec remote{ reinterpret_cast<void*>(address), size };
+    // partial reads are failures, same as ReadProcessMemory
+    return metric.succeeded(process_vm_readv(static_cast<pid_t>(memento().id()), &local, 1, &remote, 1, 0) == static_cast<ssize_t>(size));
+}
+
+bool CProcessLinuxIO::writeFromBuffer(std::uint64_t address, std::uint32_t size, void* buffer) {
+    CMetricScope metric{ TMetric::WriteFromBuffer, size };
+    if(!isAttached())
+        return { };
+
+    pageCache().invalidate(address, size);
+
+    iovec local{ buffer, size };
+    iovec remote{ reinterpret_cast<void*>(address), size };
+    if(process_vm_writev(static_cast<pid_t>(memento().id()), &local, 1, &remote, 1, 0) == static_cast<ssize_t>(size))
+        return metric.succeeded();
+
+    // /proc/<pid>/mem writes go through FOLL_FORCE and ignore page protection, like WriteProcessMemory does
+    return metric.succeeded(pwrite(m_MemoryFd, buffer, size, static_cast<off_t>(address)) == static_cast<ssize_t>(size));
+}
+
+std::size_t CProcessLinuxIO::readScatter(std::span<CReadRequest> requests) {
+    for(auto& request : requests) {
+        request.isSuccessful = false;
+    }
+    if(!isAttached())
+        return { };
+
+    std::vector<iovec> localVectors{ }, remoteVectors{ };
+    localVectors.reserve(std::min<std::size_t>(requests.size(), IOV_MAX));
+    remoteVectors.reserve(localVectors.capacity());
+
+    std::size_t successfulRequests{ }, nextRequest{ };
+    while(nextRequest < requests.size()) {
+        const std::size_t batchEnd = std::min<std::size_t>(requests.size(), nextRequest + IOV_MAX);
+        localVectors.clear();
+        remoteVectors.clear();
+        for(std::size_t i = nextRequest; i < batchEnd; ++i) {
+            localVectors.push_back({ requests[i].buffer, requests[i].size });
+            remoteVectors.push_back({ reinterpret_cast<void*>(requests[i].address), requests[i].size });
+        }
+
+        ssize_t transferred = process_vm_readv(static_cast<pid_t>(memento().id()),
+                                               localVectors.data(), localVectors.size(),
+                                               remoteVectors.data(), remoteVectors.size(), 0);
+        if(transferred < 0) {
+            if(errno != EFAULT) // the process is gone or inaccessible, the rest would fail too
+                break;
+            transferred = 0; // the first remote range is invalid
+        }
+
+        // the kernel stops at the first invalid remote range, everything before it was transferred completely
+        std::size_t i = nextRequest;
+        for(; i < batchEnd && static_cast<std::size_t>(transferred) >= requests[i].size; ++i) {
+            transferred -= requests[i].size;
+            requests[i].isSuccessful = true;
+            ++successfulRequests;
+        }
+        nextRequest = i < batchEnd ? i + 1 : i; // skip the range the transfer stopped at
+    }
+    return successfulRequests;
+}
+
+MBIEx CProcessLinuxIO::query(std::uint64_t address) {
+    CMetricScope metric{ TMetric::Query };
+    if(!isAttached())
+        return { };
+
+    const auto entries = readMaps(memento().id());
+    if(entries.empty()) {
+        printf("Critical: reading /proc/%u/maps failed (%d)\n", memento().id(), errno);
+        return { };
+    }
+    metric.succeeded();
+    return regionFromMaps(entries, address);
+}
+
+std::vector<MBIEx> CProcessLinuxIO::regions() {
+    if(!isAttached())
+        return { };
+
+    return regionsFromMaps(readMaps(memento().id()));
+}
+
+std::tuple<bool, std::uint32_t> CProcessLinuxIO::protect(std::uint64_t, std::uint32_t, std::uint32_t) {
+    const CMetricScope metric{ TMetric::Protect };
+    return { };
+}
+
+std::string CProcessLinuxIO::processName(std::uint32_t id) {
+    const std::string procPath{ "/proc/" + std::to_string(id) };
+
+    char exePath[MAX_PATH]{ };
+    const ssize_t exePathSize = readlink((procPath + "/exe").c_str(), exePath, sizeof(exePath) - 1);
+    if(exePathSize > 0)
+        return std::filesystem::path(std::string(exePath, exePathSize)).filename().string();
+
+    std::ifstream commFile(procPath + "/comm");
+    std::string name{ };
+    std::getline(commFile, name);
+    return name;
+}
+
+std::vector<CProcMapsEntry> CProcessLinuxIO::readMaps(std::uint32_t id) {
+    std::ifstream mapsFile("/proc/" + std::to_string(id) + "/maps");
+    if(!mapsFile)
+        return { };
+
+    std::vector<CProcMapsEntry> entries{ };
+    std::string line{ };
+    while(std::getline(mapsFile, line)) {
+        CProcMapsEntry entry{ };
+        char permissions[5]{ };
+        int pathOffset{ };
+        if(sscanf(line.c_str(), "%" SCNx64 "-%" SCNx64 " %4s %" SCNx64 " %*s %" SCNu64 " %n",
+                  &entry.start, &entry.end, permissions, &entry.offset, &entry.inode, &pathOffset) < 5)
+            continue;
+
+        if(pathOffset > 0 && static_cast<std::size_t>(pathOffset) < line.size())
+            entry.path = line.substr(pathOffset);
+
+        entry.isShared = permissions[3] == 's';
+        entry.protection = protectionFromPermissions(permissions[0] == 'r', permissions[1] == 'w', permissions[2] == 'x');
+
+        entries.push_back(std::move(entry));
+    }
+    return entries;
+}
+
+std::vector<MBIEx> CProcessLinuxIO::regionsFromMaps(const std::vector<CProcMapsEntry>& entries) {
+    std::vector<MBIEx> result{ };
+    result.reserve(entries.size() * 2);
+
+    // gaps are reported as MEM_FREE regions, the same way the query() walk on Windows sees them
+    std::uint64_t address{ };
+    for(const auto& entry : entries) {
+        if(entry.start >= c_MaximumUserAddress) // [vsyscall]
+            break;
+        if(entry.start > address)
+            result.push_back(regionFromMaps(entries, address));
+        result.push_back(regionFromMaps(entries, entry.start));
+        address = entry.end;
+    }
+    return result;
+}
+
+std::uint32_t CProcessLinuxIO::protectionFromPermissions(bool isReadable, bool isWritable, bool isExecutable) {
+    if(isExecutable)
+        return isReadable ? (isWritable ? PAGE_EXECUTE_READWRITE : PAGE_EXECUTE_READ) : PAGE_EXECUTE;
+    if(isReadable || isWritable)
+        return isWritable ? PAGE_READWRITE : PAGE_READONLY;
+    return PAGE_NOACCESS;
+}
+
+MBIEx CProcessLinuxIO::regionFromMaps(const std::vector<CProcMapsEntry>& entries, std::uint64_t address) {
+    MEMORY_BASIC_INFORMATION mbi{ };
+
+    // first entry which ends after the address
+    const auto entryIterator = std::upper_bound(entries.begin(), entries.end(), address, [](std::uint64_t a, const CProcMapsEntry& e) -> bool {
+        return a < e.end;
+    });
+
+    if(entryIterator == entries.end() || entryIterator->start > address) {
+        // unmapped gap, described the way VirtualQueryEx describes MEM_FREE regions
+        const std::uint64_t gapStart = entryIterator == entries.begin() ? 0 : std::prev(entryIterator)->end;
+        const std::uint64_t gapEnd = entryIterator == entries.end() ? ~0xfffull : entryIterator->start;
+        mbi.BaseAddress = reinterpret_cast<PVOID>(gapStart);
+        mbi.RegionSize = gapEnd - gapStart;
+        mbi.State = MEM_FREE;
+        mbi.Protect = PAGE_NOACCESS;
+        return MBIEx{ mbi };
+    }
+
+    // contiguous mappings of the same file form one allocation (an ELF image is usually split into 4-5 of them)
+    auto allocationIterator = entryIterator;
+    while(!entryIterator->path.empty() && allocationIterator != entries.begin()) {
+        const auto previous = std::prev(allocationIterator);
+        if(previous->path != entryIterator->path || previous->end != allocationIterator->start)
+            break;
+        allocationIterator = previous;
+    }
+
+    mbi.BaseAddress = reinterpret_cast<PVOID>(entryIterator->start);
+    mbi.AllocationBase = reinterpret_cast<PVOID>(allocationIterator->start);
+    mbi.AllocationProtect = allocationIterator->protection;
+    mbi.RegionSize = entryIterator->end - entryIterator->start;
+    mbi.State = MEM_COMMIT;
+    mbi.Protect = entryIterator->protection;
+    if(entryIterator->path.starts_with('/'))
+        mbi.Type = MEM_IMAGE;
+    else
+        mbi.Type = entryIterator->isShared ? MEM_MAPPED : MEM_PRIVATE;
+    return MBIEx{ mbi };
+}
+
+std::vector<CModule> CRetrieveModuleListProcMaps::retrieve() const {
+    printf("[%s] Retrieving via /proc/pid/maps\n", __FUNCTION__);
+    if(!m_ThisProcess)
+        return { };
+
+    return modulesFromMaps(m_ThisProcess, CProcessLinuxIO::readMaps(m_ThisProcess->memento().id()));
+}
+
+std::vector<CModule> CRetrieveModuleListProcMaps::modulesFromMaps(IProcessIO* thisProcess, const std::vector<CProcMapsEntry>& entries) {
+    std::vector<std::tuple<std::string, std::uint64_t, std::uint64_t>> images{ };
+    std::unordered_map<std::string, std::size_t> imageIndices{ };
+    for(const auto& entry : entries) {
+        if(!entry.path.starts_with('/') || entry.path.starts_with("/dev/"))
+            continue;
+
+        const auto [imageIterator, isInserted] = imageIndices.try_emplace(entry.path, images.size());
+        if(isInserted) {
+            images.emplace_back(entry.path, entry.start, entry.end);
+            continue;
+        }
+
+        auto& [path, start, end] = images[imageIterator->second];
+        start = std::min(start, entry.start);
+        end = std::max(end, entry.end);
+    }
+
+    std::vector<CModule> modules{ };
+    for(const auto& [path, start, end] : images) {
+        modules.emplace_back(CModuleMemento(
+            start,
+            static_cast<std::uint32_t>(std::min<std::uint64_t>(end - start, UINT_MAX)),
+            std::filesystem::path(path).filename().string()),
+            thisProcess
+        );
+    }
+
+    return modules;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "process.h"
+#include "process_watcher.h"
+#include <atomic>
+
+// one line of /proc/<pid>/maps
+struct CProcMapsEntry {
+    std::uint64_t start{ }, end{ }, offset{ }, inode{ };
+    std::uint32_t protection{ PAGE_NOACCESS }; // translated to PAGE_* so the rest of the tree stays platform agnostic
+    bool isShared{ };
+    std::string path{ };
+};
+
+class CProcessLinuxIO : public IProcessIO {
+public:
+    CProcessLinuxIO(const CProcessMemento& process);
+    CProcessLinuxIO(std::uint32_t id);
+    virtual ~CProcessLinuxIO();
+
+    // one atomic load while the process is watched, it turns false once the process exits
+    bool isAttached();
+
+    virtual bool readToBuffer(std::uint64_t address, std::uint32_t size, void* buffer) override;
+    virtual bool writeFromBuffer(std::uint64_t address, std::uint32_t size, void* buffer) override;
+    virtual MBIEx query(std::uint64_t address) override;
+    // Linux has no cross-process mprotect (it would require injecting a syscall through ptrace), always fails
+    virtual std::tuple<bool, std::uint32_t> protect(std::uint64_t address, std::uint32_t size, std::uint32_t flags) override;
+    // up to IOV_MAX requests per process_vm_readv call
+    virtual std::size_t readScatter(std::span<CReadRequest> requests) override;
+    // one pass over /proc/<pid>/maps instead of one per region
+    virtual std::vector<MBIEx> regions() override;
+
+    // exit codes are only available to the parent process, so this stays UINT_MAX
+    std::uint32_t exitCode() const;
+
+    // @return Returns basename of /proc/<id>/exe, falls back to /proc/<id>/comm when the link is not readable, empty string if the process is gone
+    static std::string processName(std::uint32_t id);
+    // @return Returns entries sorted by start address, empty vector on failure
+    static std::vector<CProcMapsEntry> readMaps(std::uint32_t id);
+    static MBIEx regionFromMaps(const std::vector<CProcMapsEntry>& entries, std::uint64_t address);
+    // entries as regions, gaps between them included as MEM_FREE ones
+    static std::vector<MBIEx> regionsFromMaps(const std::vector<CProcMapsEntry>& entries);
+    static std::uint32_t protectionFromPermissions(bool isReadable, bool isWritable, bool isExecutable);
+private:
+    bool tryAttach();
+    void detach();
+    // called once, from the watcher thread or from isAttached() when the process is not watched
+    void onProcessExit();
+
+    int m_MemoryFd{ -1 }; // /proc/<pid>/mem, used for writes into read-only pages (process_vm_writev respects page protection)
+    std::uint32_t m_ExitCode{ UINT_MAX };
+
+    std::unique_ptr<CProcessWatcher> m_Watcher{ };
+    std::atomic<bool> m_IsAlive{ };
+    bool m_IsWatched{ };
+};
+
+class CRetrieveModuleListProcMaps : public IRetrieveModuleListStrategy {
+public:
+    CRetrieveModuleListProcMaps(IProcessIO* thisProcess)
+        : IRetrieveModuleListStrategy(thisProcess) { }
+
+    virtual std::vector<CModule> retrieve() const override;
+
+    // every file-backed path is one module spanning from its lowest to its highest mapping, in the order of first appearance
+    static std::vector<CModule> modulesFromMaps(IProcessIO* thisProcess, const std::vector<CProcMapsEntry>& entries);
+};
@@ -2,26 +2,42 @@
 #include "ui_process_selector.h"
 
 #include "cmainwindow.h"
+#include <QFileDialog>
+#ifdef _WIN32
 #include "process_win32.h"
+using CProcessNativeIO = CProcessWinIO;
+#else
+#include "process_linux.h"
+#include "process_core.h"
+using CProcessNativeIO = CProcessLinuxIO;
+#endif
 
 CProcessSelectorWindow::CProcessSelectorWindow(QWidget *parent, CSettingsWindow* settings)
     : QDialog(parent)
     , ui(new Ui::CProcessSelector)
-    , m_Settings{ settings } {
+    , m_Settings{ settings }
+    , m_ProcessEventsTimer{ new QTimer(this) } {
 
     if(!qobject_cast<CMainWindow*>(this->parent())) // im not sure how qobject_cast works (if it works like dynamic_cast then it's ok)
         throw std::runtime_error("CMainWindow must be a parent of CProcessSelector");
 
     ui->setupUi(this);
+#ifdef _WIN32
+    ui->openCoreButton->hide(); // ELF core dumps are read with the Linux backend helpers
+#endif
 
     connectSignals();
 
     updateProcessesCombo();
     updateCurrentProcessLabel();
+
+    if(m_ProcessList->isEventDriven())
+        m_ProcessEventsTimer->start(c_ProcessEventsInterval);
 }
 
 void CProcessSelectorWindow::connectSignals() {
     QObject::connect(m_Settings, &CSettingsWindow::processListSortTypeChanged, this, &CProcessSelectorWindow::on_processRefreshButton_clicked);
+    QObject::connect(m_ProcessEventsTimer, &QTimer::timeout, this, &CProcessSelectorWindow::on_processRefreshButton_clicked);
 }
 
 CProcessSelectorWindow::~CProcessSelectorWindow() {
@@ -40,8 +56,13 @@ const std::vector<CProcessMemento>& CProcessSelectorWindow::processes() const {
 }
 
 void CProcessSelectorWindow::on_processRefreshButton_clicked() {
-    m_ProcessList->refresh();
-    updateProcessesCombo();
+    m_ProcessList->setSortType(m_Settings->processListSortType());
+    const auto previousProcesses = m_ProcessList->data();
+    updateProcessesCombo(m_ProcessList->refresh(), previousProcesses);
+
+    // the list went back to full /proc rescans, those stay on the refresh button instead of running every interval
+    if(!m_ProcessList->isEventDriven())
+        m_ProcessEventsTimer->stop();
 }
 
 void CProcessSelectorWindow::updateProcessesCombo() {
@@ -55,6 +76,25 @@ void CProcessSelectorWindow::updateProcessesCombo() {
     updateProcessLastLabel(QString("Total Processes: ") + QString::number(processes.size()));
 }
 
+void CProcessSelectorWindow::updateProcessesCombo(const CListChanges& changes, const std::vector<CProcessMemento>& previousProcesses) {
+    if(changes.isReordered) {
+        updateProcessesCombo();
+        return;
+    }
+    if(changes.isEmpty())
+        return;
+
+    const auto& processes = m_ProcessList->data();
+    for(auto row : changes.removedRows) {
+        ui->processComboBox->removeItem(static_cast<int>(row));
+        emit processExited(previousProcesses[row]);
+    }
+    for(auto row : changes.addedRows) {
+        ui->processComboBox->insertItem(static_cast<int>(row), QString(processes[row].format().c_str()));
+        emit processStarted(processes[row]);
+    }
+}
+
 void CProcessSelectorWindow::updateProcessLastLabel(const QString& message) {
     ui->processLastMessage->setText(message);
 }
@@ -69,7 +109,7 @@ void CProcessSelectorWindow::on_processComboBox_activated(int index) {
         throw std::out_of_range("Out of bounds: m_ProcessList");
 
     onProcessDetach();
-    auto selectedProcess = std::make_shared<CProcessWinIO>(m_ProcessList->data()[index]);
+    auto selectedProcess = std::make_shared<CProcessNativeIO>(m_ProcessList->data()[index]);
     if(!selectedProcess->isAttached()) {
         updateProcessLastLabel(QString("Failed to attach"));
         return;
@@ -79,7 +119,30 @@ void CProcessSelectorWindow::on_processComboBox_activated(int index) {
     onProcessAttach();
 }
 
+void CProcessSelectorWindow::on_openCoreButton_clicked() {
+#ifndef _WIN32
+    const QString path = QFileDialog::getOpenFileName(this, "Open Core Dump");
+    if(path.isEmpty())
+        return;
+
+    onProcessDetach();
+    try {
+        m_SelectedProcess = std::make_shared<CProcessCoreIO>(path.toStdString());
+    } catch(const std::runtime_error& e) {
+        updateProcessLastLabel(e.what());
+        return;
+    }
+
+    onProcessAttach();
+#endif
+}
+
 void CProcessSelectorWindow::onProcessAttach() {
+    const auto moduleList = m_SelectedProcess->moduleList().lock();
+    moduleList->setSortType(m_Settings->moduleListSortType());
+    moduleList->setRetrieveMethod(m_Settings->moduleListRetrieveMethod());
+    moduleList->refresh();
+
     updateMainWindowStatusBar(QString("Attached to ") + QString(m_SelectedProcess->memento().name().c_str()) + QString(" successfully"));
 
     updateProcessLastLabel(QString("Attached successfully"));
@@ -101,11 +164,12 @@ void CProcessSelectorWindow::invalidProcessSlot() {
     if(!m_SelectedProcess)
         return;
 
-    CProcessWinIO* winProcess = dynamic_cast<CProcessWinIO*>(m_SelectedProcess.get());
-    if(winProcess) {
+    CProcessNativeIO* nativeProcess = dynamic_cast<CProcessNativeIO*>(m_SelectedProcess.get());
+    if(nativeProcess) {
         updateProcessLastLabel(
-            QString("The process exited with code ") +
-            QString::number(winProcess->exitCode(), 16)
+            nativeProcess->exitCode() == UINT_MAX ?
+                QString("The process exited") :
+                QString("The process exited with code ") + QString::number(nativeProcess->exitCode(), 16)
             );
 
         updateMainWindowStatusBar(QString("Detached"));
@@ -1,5 +1,6 @@
 #pragma once
 #include <QDialog>
+#include <QTimer>
 #include "process.h"
 #include "settings.h"
 
@@ -20,6 +21,7 @@ public:
 private slots:
     void on_processRefreshButton_clicked();
     void on_processComboBox_activated(int index);
+    void on_openCoreButton_clicked();
 
     void on_closeButton_clicked();
 
@@ -27,6 +29,9 @@ private slots:
 signals:
     void processAttached();
     void processDetached();
+    // the process list gained or lost an entry, an exec which changed the name of a process emits both
+    void processStarted(const CProcessMemento& process);
+    void processExited(const CProcessMemento& process);
 private:
     void connectSignals();
 
@@ -34,14 +39,20 @@ private:
     void onProcessDetach();
 
     void updateProcessesCombo();
+    // applies only the changed rows, emits processStarted and processExited for them
+    void updateProcessesCombo(const CListChanges& changes, const std::vector<CProcessMemento>& previousProcesses);
     void updateProcessLastLabel(const QString& message);
     void updateCurrentProcessLabel(const CProcessMemento& process = CProcessMemento(0, "none"));
 
     void updateMainWindowStatusBar(const QString& message = "");
 private:
+    // only drains coalesced process events, nothing is enumerated while the list does not change
+    static constexpr int c_ProcessEventsInterval{ 1000 };
+
     Ui::CProcessSelector *ui;
     CSettingsWindow* m_Settings;
 
-    std::unique_ptr<CProcessList> m_ProcessList{ std::make_unique<CProcessList>() };
+    std::unique_ptr<CProcessList> m_ProcessList{ std::make_unique<CProcessList>(m_Settings->processListSortType()) };
     std::shared_ptr<IProcessIO> m_SelectedProcess{ };
+    QTimer* m_ProcessEventsTimer;
 };
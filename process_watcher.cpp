@@ -0,0 +1,93 @@
+#include "process_watcher.h"
+
+#ifndef _WIN32
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+
+// older libc headers do not know the syscall, the number is the same on every architecture
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+#endif
+
+#ifdef _WIN32
+CProcessWatcher::CProcessWatcher(HANDLE process, std::function<void()> onExit)
+    : m_OnExit{ std::move(onExit) } {
+    if(!RegisterWaitForSingleObject(&m_Wait, process, &CProcessWatcher::onProcessSignaled, this, INFINITE, WT_EXECUTEONLYONCE)) {
+        printf("[CProcessWatcher] Can not wait on the process handle (%d)\n", GetLastError());
+        m_Wait = { };
+    }
+}
+
+CProcessWatcher::~CProcessWatcher() {
+    // INVALID_HANDLE_VALUE makes it wait for a callback which already started
+    if(m_Wait)
+        UnregisterWaitEx(m_Wait, INVALID_HANDLE_VALUE);
+}
+
+bool CProcessWatcher::isWatching() const {
+    return m_Wait;
+}
+
+void CALLBACK CProcessWatcher::onProcessSignaled(PVOID context, BOOLEAN isTimeout) {
+    static_cast<CProcessWatcher*>(context)->m_OnExit();
+}
+#else
+CProcessWatcher::CProcessWatcher(std::uint32_t id, std::function<void()> onExit)
+    : m_OnExit{ std::move(onExit) } {
+    m_ProcessFd = static_cast<int>(syscall(SYS_pidfd_open, static_cast<pid_t>(id), 0));
+    if(m_ProcessFd == -1) {
+        printf("[CProcessWatcher] pidfd_open failed (%d), liveness is checked on every access\n", errno);
+        return;
+    }
+
+    m_StopEvent = eventfd(0, EFD_CLOEXEC);
+    if(m_StopEvent == -1) {
+        close(m_ProcessFd);
+        m_ProcessFd = -1;
+        return;
+    }
+    m_WaitThread = std::thread(&CProcessWatcher::waitForExit, this);
+}
+
+CProcessWatcher::~CProcessWatcher() {
+    if(m_WaitThread.joinable()) {
+        const std::uint64_t stop{ 1 };
+        if(write(m_StopEvent, &stop, sizeof(stop)) != sizeof(stop))
+            printf("[~CProcessWatcher] Can not wake the wait thread up (%d)\n", errno);
+        m_WaitThread.join();
+    }
+
+    if(m_ProcessFd != -1)
+        close(m_ProcessFd);
+    if(m_StopEvent != -1)
+        close(m_StopEvent);
+}
+
+bool CProcessWatcher::isWatching() const {
+    return m_ProcessFd != -1;
+}
+
+void CProcessWatcher::waitForExit() {
+    // a pidfd becomes readable once the process exits
+    pollfd descriptors[2]{ { m_ProcessFd, POLLIN, 0 }, { m_StopEvent, POLLIN, 0 } };
+    for(;;) {
+        if(poll(descriptors, 2, -1) == -1) {
+            if(errno == EINTR)
+                continue;
+            printf("[CProcessWatcher] poll failed (%d)\n", errno);
+            return;
+        }
+        if(descriptors[1].revents)
+            return;
+        if(descriptors[0].revents) {
+            m_OnExit();
+            return;
+        }
+    }
+}
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+#include "platform.h"
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+// Waits for a process to exit and calls onExit once, from another thread. On Linux a thread polls a pidfd, on Windows
+// the process handle is waited on by the thread pool. Nothing runs per read: backends only test the flag onExit clears
+class CProcessWatcher final {
+public:
+#ifdef _WIN32
+    // the handle needs SYNCHRONIZE access and has to stay open while the watcher exists
+    CProcessWatcher(HANDLE process, std::function<void()> onExit);
+#else
+    CProcessWatcher(std::uint32_t id, std::function<void()> onExit);
+#endif
+    // waits for a running onExit, it is not called afterwards
+    ~CProcessWatcher();
+
+    CProcessWatcher(const CProcessWatcher&) = delete;
+    CProcessWatcher& operator=(const CProcessWatcher&) = delete;
+
+    // false when the platform can not watch the process (Linux before 5.3 has no pidfd_open) or it was already gone,
+    // in which case onExit is never called and the owner has to check liveness itself
+    bool isWatching() const;
+private:
+    std::function<void()> m_OnExit;
+#ifdef _WIN32
+    static void CALLBACK onProcessSignaled(PVOID context, BOOLEAN isTimeout);
+
+    HANDLE m_Wait{ };
+#else
+    void waitForExit();
+
+    int m_ProcessFd{ -1 };
+    int m_StopEvent{ -1 }; // eventfd which wakes waitForExit() up on destruction
+    std::thread m_WaitThread{ };
+#endif
+};
@@ -12,23 +12,33 @@ CProcessWinIO::CProcessWinIO(std::uint32_t id)
     : IProcessIO{ id } { }
 
 CProcessWinIO::~CProcessWinIO() {
+    if(m_ModuleList) // the id constructor does not create one
+        m_ModuleList->cleanup();
     detach();
     printf("[~CProcessWinIO] Detaching: %s\n", memento().name().c_str());
 }
 
 bool CProcessWinIO::isAttached() {
+    if(m_IsWatched)
+        return m_IsAlive.load(std::memory_order_relaxed);
     if(!Utilities::isHandleValid(handle()))
         return false;
 
+    // without a registered wait every access checks
     const auto exitCode = Utilities::processExitCode(handle());
     if(Utilities::isProcessActive(exitCode))
         return true;
 
-    m_ExitCode = exitCode;
-    emit IProcessIO::invalidProcessSignal();
+    onProcessExit(exitCode);
     return false;
 }
 
+void CProcessWinIO::onProcessExit(std::uint32_t exitCode) {
+    m_ExitCode = exitCode;
+    if(m_IsAlive.exchange(false))
+        emit IProcessIO::invalidProcessSignal();
+}
+
 std::uint32_t CProcessWinIO::exitCode() const {
     return m_ExitCode;
 }
@@ -38,16 +48,26 @@ bool CProcessWinIO::tryAttach() {
         return false;
 
     m_Handle = OpenProcess(PROCESS_ALL_ACCESS, FALSE, memento().id());
-    if(!isAttached())
+    if(!Utilities::isHandleValid(m_Handle))
         return false;
 
-    return true;
+    m_IsAlive = true;
+    m_Watcher = std::make_unique<CProcessWatcher>(m_Handle, [this]() -> void {
+        onProcessExit(Utilities::processExitCode(m_Handle));
+    });
+    m_IsWatched = m_Watcher->isWatching();
+    return isAttached();
 }
 
 void CProcessWinIO::detach() {
-    if(!isAttached())
+    // no exit notification may arrive while the object is destroyed
+    m_Watcher.reset();
+    m_IsWatched = false;
+    m_IsAlive = false;
+    if(!Utilities::isHandleValid(m_Handle))
         return;
 
+    // closed even when the process already exited, only a live process used to release its handle
     CloseHandle(m_Handle);
     m_Handle = INVALID_HANDLE_VALUE;
 }
@@ -57,20 +77,24 @@ HANDLE CProcessWinIO::handle() const {
 }
 
 bool CProcessWinIO::readToBuffer(std::uint64_t address, std::uint32_t size, void* buffer) {
+    CMetricScope metric{ TMetric::ReadToBuffer, size };
     if(!isAttached())
         return { };
 
-    return ReadProcessMemory(handle(), reinterpret_cast<LPCVOID>(address), buffer, size, std::nullptr_t());
+    return metric.succeeded(ReadProcessMemory(handle(), reinterpret_cast<LPCVOID>(address), buffer, size, std::nullptr_t()));
 }
 
 bool CProcessWinIO::writeFromBuffer(std::uint64_t address, std::uint32_t size, void* buffer) {
+    CMetricScope metric{ TMetric::WriteFromBuffer, size };
     if(!isAttached())
         return { };
 
-    return WriteProcessMemory(handle(), reinterpret_cast<LPVOID>(address), buffer, size, std::nullptr_t());
+    pageCache().invalidate(address, size);
+    return metric.succeeded(WriteProcessMemory(handle(), reinterpret_cast<LPVOID>(address), buffer, size, std::nullptr_t()));
 }
 
 MBIEx CProcessWinIO::query(std::uint64_t address) {
+    CMetricScope metric{ TMetric::Query };
     if(!isAttached())
         return { };
 
@@ -79,14 +103,19 @@ MBIEx CProcessWinIO::query(std::uint64_t address) {
         printf("Critical: VirtualQueryEx failed (%d)\n", GetLastError());
         return { };
     }
+    metric.succeeded();
     return MBIEx{ mbi };
 }
 
 std::tuple<bool, std::uint32_t> CProcessWinIO::protect(std::uint64_t address, std::uint32_t size, std::uint32_t flags) {
+    CMetricScope metric{ TMetric::Protect, size };
     if(!isAttached())
         return { };
 
     std::uint32_t oldProtect{ };
     VirtualProtectEx(handle(), reinterpret_cast<LPVOID>(address), size, flags, reinterpret_cast<PDWORD>(&oldProtect));
+    regionMap().invalidate(); // protection change splits or merges regions
+    pageCache().invalidate(address, size); // pages which were unreadable may be readable now
+    metric.succeeded();
     return { true, oldProtect };
 }
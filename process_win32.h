@@ -1,5 +1,7 @@
 #pragma once
 #include "process.h"
+#include "process_watcher.h"
+#include <atomic>
 
 class CProcessWinIO : public IProcessIO {
 public:
@@ -7,6 +9,7 @@ public:
     CProcessWinIO(std::uint32_t id);
     virtual ~CProcessWinIO();
 
+    // one atomic load while the process is watched, it turns false once the process exits
     bool isAttached();
     HANDLE handle() const;
 
@@ -19,9 +22,15 @@ public:
 private:
     bool tryAttach();
     void detach();
+    // called once, from the thread pool wait or from isAttached() when the process is not watched
+    void onProcessExit(std::uint32_t exitCode);
 
     HANDLE m_Handle{ INVALID_HANDLE_VALUE };
-    std::uint32_t m_ExitCode{ UINT_MAX };
+    std::atomic<std::uint32_t> m_ExitCode{ UINT_MAX };
+
+    std::unique_ptr<CProcessWatcher> m_Watcher{ };
+    std::atomic<bool> m_IsAlive{ };
+    bool m_IsWatched{ };
 
     //std::uint64_t allocate(std::uint32_t size, std::uint32_t flags, std::uint32_t flags2); // Wrappers around VirtualAllocEx, VirtualFreeEx
     //bool free(std::uint64_t address, std::uint32_t flags);
@@ -0,0 +1,84 @@
+#include "refresh_scheduler.h"
+#include <algorithm>
+
+CRefreshScheduler::CRefreshScheduler(QObject* parent, std::function<void()> refresh)
+    : QObject(parent), m_Refresh{ std::move(refresh) }, m_Timer{ new QTimer(this) } {
+    m_Timer->setSingleShot(true);
+    QObject::connect(m_Timer, &QTimer::timeout, this, &CRefreshScheduler::refresh);
+}
+
+void CRefreshScheduler::setInterval(int milliseconds) {
+    m_Interval = std::max(1, milliseconds);
+    // a shorter interval applies now rather than after the pending period
+    if(m_IsActive && !m_IsRefreshing && m_Timer->remainingTime() > interval())
+        schedule(interval());
+}
+
+void CRefreshScheduler::setActive(bool isActive) {
+    if(m_IsActive == isActive)
+        return;
+
+    m_IsActive = isActive;
+    m_IsRequested = false;
+    if(!isActive) {
+        m_Timer->stop();
+        return;
+    }
+
+    // whatever is shown is stale after a pause
+    if(!m_IsRefreshing)
+        schedule(0);
+}
+
+bool CRefreshScheduler::isActive() const {
+    return m_IsActive;
+}
+
+void CRefreshScheduler::requestRefresh() {
+    if(!m_IsActive)
+        return;
+
+    if(m_IsRefreshing) {
+        m_IsRequested = true;
+        return;
+    }
+    schedule(0);
+}
+
+void CRefreshScheduler::addCost(std::chrono::microseconds cost) {
+    m_AddedCost += cost;
+}
+
+int CRefreshScheduler::interval() const {
+    const auto costBound = std::chrono::duration_cast<std::chrono::milliseconds>(m_AverageCost * c_CostFactor).count();
+    return static_cast<int>(std::clamp<std::int64_t>(costBound, m_Interval, std::max(m_Interval, c_MaximumInterval)));
+}
+
+void CRefreshScheduler::refresh() {
+    if(!m_IsActive)
+        return;
+
+    m_IsRefreshing = true;
+    const auto start = std::chrono::steady_clock::now();
+    m_Refresh();
+    const auto cost = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start) + m_AddedCost;
+    m_AddedCost = { };
+    m_IsRefreshing = false;
+
+    m_AverageCost = m_AverageCost.count() ? (m_AverageCost * (100 - c_CostSmoothing) + cost * c_CostSmoothing) / 100 : cost;
+
+    // the refresh itself may have paused the scheduler, e.g. the process died
+    if(!m_IsActive)
+        return;
+
+    schedule(m_IsRequested ? 0 : interval());
+    m_IsRequested = false;
+}
+
+void CRefreshScheduler::schedule(int milliseconds) {
+    // an earlier pending refresh already covers this one
+    if(m_Timer->isActive() && m_Timer->remainingTime() <= milliseconds)
+        return;
+
+    m_Timer->start(milliseconds);
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <QObject>
+#include <QTimer>
+#include <chrono>
+#include <functional>
+
+// Periodic refreshes on the owner's thread from one single-shot timer which is only re-armed after a refresh returns,
+// so refreshes never overlap or queue up. Requests made while one is pending or running collapse into one refresh.
+// The period stretches to c_CostFactor times the measured cost of a refresh, so a slow target is polled less often
+class CRefreshScheduler : public QObject {
+    Q_OBJECT
+public:
+    CRefreshScheduler(QObject* parent, std::function<void()> refresh);
+
+    // the shortest period, used while refreshes are cheap
+    void setInterval(int milliseconds);
+    // an inactive scheduler has no timer running at all
+    void setActive(bool isActive);
+    bool isActive() const;
+    // refreshes on the next event loop iteration, ahead of the period
+    void requestRefresh();
+    // work a refresh started elsewhere, e.g. a read on another thread, counted into the cost of the next refresh
+    void addCost(std::chrono::microseconds cost);
+
+    // @return Returns the current period, the configured interval or longer
+    int interval() const;
+private:
+    // a refresh may take up to 1/c_CostFactor of the owner's thread
+    static constexpr int c_CostFactor{ 4 };
+    static constexpr int c_MaximumInterval{ 10000 };
+    // weight of the newest measurement in the moving average of the cost, in percent
+    static constexpr int c_CostSmoothing{ 25 };
+
+    void refresh();
+    void schedule(int milliseconds);
+
+    std::function<void()> m_Refresh;
+    QTimer* m_Timer;
+    int m_Interval{ 500 };
+    std::chrono::microseconds m_AverageCost{ };
+    std::chrono::microseconds m_AddedCost{ };
+    bool m_IsActive{ };
+    bool m_IsRefreshing{ };
+    bool m_IsRequested{ }; // requested while refreshing, refresh again right after
+};
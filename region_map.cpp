@@ -0,0 +1,92 @@
+#include "region_map.h"
+#include "process.h"
+
+CRegionMap::CRegionMap(IProcessIO* process)
+    : m_ThisProcess{ process } {
+    if(!m_ThisProcess)
+        throw std::runtime_error("m_ThisProcess can not be nullptr");
+}
+
+MBIEx CRegionMap::query(std::uint64_t address) {
+    {
+        std::shared_lock lock(m_Mutex);
+        if(isValid()) {
+            if(const MBIEx* region = find(address)) {
+                ++m_Hits;
+                return *region;
+            }
+        }
+    }
+
+    ++m_Misses;
+    {
+        std::unique_lock lock(m_Mutex);
+        if(!isValid())
+            rebuild();
+        if(const MBIEx* region = find(address))
+            return *region;
+    }
+
+    // not covered by the snapshot (above the user space or the enumeration failed), ask the backend directly
+    return m_ThisProcess->query(address);
+}
+
+std::vector<MBIEx> CRegionMap::regions() {
+    std::unique_lock lock(m_Mutex);
+    if(!isValid())
+        rebuild();
+    return m_Regions;
+}
+
+void CRegionMap::refresh() {
+    std::unique_lock lock(m_Mutex);
+    rebuild();
+}
+
+void CRegionMap::invalidate() {
+    ++m_Generation;
+}
+
+void CRegionMap::setTimeToLive(std::chrono::milliseconds timeToLive) {
+    m_TimeToLive = timeToLive.count();
+}
+
+std::uint64_t CRegionMap::hits() const {
+    return m_Hits;
+}
+
+std::uint64_t CRegionMap::misses() const {
+    return m_Misses;
+}
+
+bool CRegionMap::isValid() const {
+    if(m_SnapshotGeneration != m_Generation)
+        return false;
+
+    return std::chrono::steady_clock::now() - m_SnapshotTime < std::chrono::milliseconds(m_TimeToLive);
+}
+
+void CRegionMap::rebuild() {
+    // read the generation first, an invalidate() racing with the enumeration then leaves the snapshot stale instead of lost
+    m_SnapshotGeneration = m_Generation;
+    m_Regions = m_ThisProcess->regions();
+    std::sort(m_Regions.begin(), m_Regions.end(), [](const MBIEx& r1, const MBIEx& r2) -> bool {
+        return reinterpret_cast<std::uint64_t>(r1.BaseAddress) < reinterpret_cast<std::uint64_t>(r2.BaseAddress);
+    });
+    m_SnapshotTime = std::chrono::steady_clock::now();
+}
+
+const MBIEx* CRegionMap::find(std::uint64_t address) const {
+    // last region starting at or below the address
+    auto regionIterator = std::upper_bound(m_Regions.begin(), m_Regions.end(), address, [](std::uint64_t a, const MBIEx& r) -> bool {
+        return a < reinterpret_cast<std::uint64_t>(r.BaseAddress);
+    });
+    if(regionIterator == m_Regions.begin())
+        return std::nullptr_t();
+
+    --regionIterator;
+    if(address - reinterpret_cast<std::uint64_t>(regionIterator->BaseAddress) >= regionIterator->RegionSize)
+        return std::nullptr_t();
+
+    return &*regionIterator;
+}
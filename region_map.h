@@ -0,0 +1,47 @@
+#pragma once
+#include "utilities.h"
+
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <shared_mutex>
+
+class IProcessIO;
+
+// Sorted snapshot of all regions of a process, answers query() with a binary search instead of a syscall.
+// The snapshot is rebuilt on the next lookup after invalidate() bumps the generation, after refresh() or when it is older than the time to live
+class CRegionMap final {
+public:
+    CRegionMap(IProcessIO* process);
+    ~CRegionMap() = default;
+
+    CRegionMap(const CRegionMap&) = delete;
+    CRegionMap& operator=(const CRegionMap&) = delete;
+public:
+    MBIEx query(std::uint64_t address);
+    // copy of the current snapshot, rebuilt first if it is stale
+    std::vector<MBIEx> regions();
+
+    void refresh();
+    void invalidate();
+    void setTimeToLive(std::chrono::milliseconds timeToLive);
+
+    std::uint64_t hits() const;
+    std::uint64_t misses() const;
+private:
+    bool isValid() const;
+    void rebuild();
+    const MBIEx* find(std::uint64_t address) const;
+
+    IProcessIO* m_ThisProcess{ };
+    std::vector<MBIEx> m_Regions{ };
+
+    mutable std::shared_mutex m_Mutex{ };
+    std::atomic<std::uint64_t> m_Generation{ 1 };
+    std::uint64_t m_SnapshotGeneration{ };
+    std::chrono::steady_clock::time_point m_SnapshotTime{ };
+    std::atomic<std::chrono::milliseconds::rep> m_TimeToLive{ 1000 };
+
+    std::atomic<std::uint64_t> m_Hits{ }, m_Misses{ };
+};
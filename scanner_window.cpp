@@ -0,0 +1,199 @@
+#include "scanner_window.h"
+#include "ui_scanner_window.h"
+#include "cmainwindow.h"
+
+CScannerWindow::CScannerWindow(QWidget *parent, CProcessSelectorWindow* processSelector)
+    : QDialog(parent)
+    , m_ProgressTimer{ new QTimer(this) }
+    , ui(new Ui::CScannerWindow)
+    , m_ProcessSelector{ processSelector } {
+    ui->setupUi(this);
+
+    if(!qobject_cast<CMainWindow*>(this->parent()))
+        throw std::runtime_error("CMainWindow must be a parent of CScannerWindow");
+
+    const std::pair<const char*, TScanValueType> valueTypes[]{
+        { "Int8", TScanValueType::Int8 }, { "Int16", TScanValueType::Int16 },
+        { "Int32", TScanValueType::Int32 }, { "Int64", TScanValueType::Int64 },
+        { "Float", TScanValueType::Float }, { "Double", TScanValueType::Double },
+        { "String", TScanValueType::String },
+    };
+    for(const auto& [name, type] : valueTypes) {
+        ui->valueTypeComboBox->addItem(name, static_cast<int>(type));
+    }
+    ui->valueTypeComboBox->setCurrentIndex(2);
+
+    updateCompareComboBox();
+    setScanning(false);
+    connectSignals();
+}
+
+CScannerWindow::~CScannerWindow() {
+    stopScan();
+    delete ui;
+}
+
+void CScannerWindow::connectSignals() {
+    QObject::connect(this, &CScannerWindow::scanFinished, this, &CScannerWindow::onScanFinished, Qt::QueuedConnection);
+    QObject::connect(m_ProgressTimer, &QTimer::timeout, this, &CScannerWindow::updateScanProgress);
+    QObject::connect(ui->valueTypeComboBox, qOverload<int>(&QComboBox::currentIndexChanged), this, &CScannerWindow::updateCompareComboBox);
+
+    QObject::connect(m_ProcessSelector, &CProcessSelectorWindow::processAttached, this, &CScannerWindow::onProcessAttach);
+    QObject::connect(m_ProcessSelector, &CProcessSelectorWindow::processDetached, this, &CScannerWindow::onProcessDetach);
+}
+
+void CScannerWindow::onProcessAttach() {
+    m_Scanner = std::make_unique<CValueScanner>(m_ProcessSelector->selectedProcess());
+    updateCompareComboBox();
+    updateResultList();
+}
+
+void CScannerWindow::onProcessDetach() {
+    stopScan();
+    m_Scanner.reset();
+    updateCompareComboBox();
+    updateResultList();
+    updateScanLastLabel();
+}
+
+void CScannerWindow::startScan(std::function<bool()> scan) {
+    stopScan();
+    setScanning(true);
+    m_ScanThread = std::thread([this, scan]() -> void {
+        emit scanFinished(scan());
+    });
+}
+
+void CScannerWindow::stopScan() {
+    if(!m_ScanThread.joinable())
+        return;
+
+    if(m_Scanner)
+        m_Scanner->cancel();
+    m_ScanThread.join();
+}
+
+void CScannerWindow::setScanning(bool isScanning) {
+    ui->firstScanButton->setEnabled(!isScanning);
+    ui->nextScanButton->setEnabled(!isScanning && m_Scanner && m_Scanner->hasResults());
+    ui->cancelScanButton->setEnabled(isScanning);
+    ui->valueTypeComboBox->setEnabled(!isScanning && !(m_Scanner && m_Scanner->hasResults()));
+    ui->compareComboBox->setEnabled(!isScanning);
+
+    ui->scanProgressBar->setValue(0);
+    if(isScanning)
+        m_ProgressTimer->start(100);
+    else
+        m_ProgressTimer->stop();
+}
+
+void CScannerWindow::updateScanProgress() {
+    if(m_Scanner)
+        ui->scanProgressBar->setValue(static_cast<int>(m_Scanner->progress() * 100.f));
+}
+
+void CScannerWindow::onScanFinished(bool isSuccessful) {
+    if(m_ScanThread.joinable())
+        m_ScanThread.join();
+
+    setScanning(false);
+    updateCompareComboBox();
+    updateResultList();
+    updateScanLastLabel(isSuccessful ? "" : "Scan failed, check the value or the process");
+}
+
+void CScannerWindow::on_firstScanButton_clicked() {
+    if(!m_Scanner) {
+        updateScanLastLabel("You must select a process first");
+        return;
+    }
+
+    // the button starts over when there already are results
+    if(m_Scanner->hasResults()) {
+        stopScan();
+        m_Scanner->reset();
+        setScanning(false);
+        updateCompareComboBox();
+        updateResultList();
+        return;
+    }
+
+    const auto valueType = static_cast<TScanValueType>(ui->valueTypeComboBox->currentData().toInt());
+    const auto compare = static_cast<TScanCompare>(ui->compareComboBox->currentData().toInt());
+    const std::string value{ ui->valueLine->text().trimmed().toStdString() }, upperValue{ ui->upperValueLine->text().trimmed().toStdString() };
+    CValueScanner* scanner = m_Scanner.get();
+    startScan([=]() -> bool {
+        return scanner->firstScan(valueType, compare, value, upperValue);
+    });
+}
+
+void CScannerWindow::on_nextScanButton_clicked() {
+    if(!m_Scanner || !m_Scanner->hasResults())
+        return;
+
+    const auto compare = static_cast<TScanCompare>(ui->compareComboBox->currentData().toInt());
+    const std::string value{ ui->valueLine->text().trimmed().toStdString() }, upperValue{ ui->upperValueLine->text().trimmed().toStdString() };
+    CValueScanner* scanner = m_Scanner.get();
+    startScan([=]() -> bool {
+        return scanner->nextScan(compare, value, upperValue);
+    });
+}
+
+void CScannerWindow::on_cancelScanButton_clicked() {
+    if(m_Scanner)
+        m_Scanner->cancel();
+}
+
+void CScannerWindow::updateCompareComboBox() {
+    const bool isNextScan = m_Scanner && m_Scanner->hasResults();
+    ui->firstScanButton->setText(isNextScan ? "New Scan" : "First Scan");
+
+    const std::pair<const char*, TScanCompare> compares[]{
+        { "Exact Value", TScanCompare::Exact }, { "Value Between", TScanCompare::Range }, { "Unknown Initial Value", TScanCompare::Unknown },
+        { "Changed Value", TScanCompare::Changed }, { "Unchanged Value", TScanCompare::Unchanged },
+        { "Increased Value", TScanCompare::Increased }, { "Decreased Value", TScanCompare::Decreased },
+    };
+
+    // next scans keep the value type of the first one, the combo box is locked meanwhile
+    const auto valueType = isNextScan ? m_Scanner->valueType() : static_cast<TScanValueType>(ui->valueTypeComboBox->currentData().toInt());
+    ui->compareComboBox->clear();
+    for(const auto& [name, compare] : compares) {
+        if(CValueScanner::isCompareSupported(valueType, compare, !isNextScan))
+            ui->compareComboBox->addItem(name, static_cast<int>(compare));
+    }
+}
+
+void CScannerWindow::updateResultList() {
+    ui->resultList->clear();
+    if(!m_Scanner || !m_Scanner->hasResults()) {
+        ui->scanResultsLabel->setText("Results: 0");
+        return;
+    }
+
+    ui->scanResultsLabel->setText("Results: " + QString::number(m_Scanner->resultCount()));
+
+    // listing millions of rows would stall the UI, narrow them down first
+    const auto results = m_Scanner->results();
+    const std::size_t listedResults = std::min<std::size_t>(results.size(), c_MaximumListedResults);
+    for(std::size_t i = 0; i < listedResults; ++i) {
+        auto item = new QListWidgetItem(QString::number(results[i].address, 16) + "    " + QString(m_Scanner->formatValue(results[i]).c_str()));
+        item->setData(Qt::UserRole, QVariant::fromValue<qulonglong>(results[i].address));
+        ui->resultList->addItem(item);
+    }
+}
+
+void CScannerWindow::updateScanLastLabel(const QString& message) {
+    ui->scanLastMessageLabel->setText(message);
+}
+
+void CScannerWindow::on_resultList_itemDoubleClicked(QListWidgetItem *item) {
+    goToMemoryAddress(item->data(Qt::UserRole).toULongLong());
+}
+
+void CScannerWindow::goToMemoryAddress(std::uint64_t address) {
+    qobject_cast<CMainWindow*>(this->parent())->goToMemoryAddress(address);
+}
+
+void CScannerWindow::on_closeButton_clicked() {
+    hide();
+}
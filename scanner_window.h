@@ -0,0 +1,55 @@
+#pragma once
+#include <QDialog>
+#include <QListWidgetItem>
+#include <QTimer>
+#include <thread>
+#include "value_scanner.h"
+#include "process_selector.h"
+
+namespace Ui {
+class CScannerWindow;
+}
+
+class CScannerWindow : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit CScannerWindow(QWidget *parent, CProcessSelectorWindow* processSelector);
+    ~CScannerWindow();
+signals:
+    // emitted from the scan thread
+    void scanFinished(bool isSuccessful);
+private slots:
+    void on_firstScanButton_clicked();
+    void on_nextScanButton_clicked();
+    void on_cancelScanButton_clicked();
+    void on_resultList_itemDoubleClicked(QListWidgetItem *item);
+    void on_closeButton_clicked();
+
+    void onScanFinished(bool isSuccessful);
+    void onProcessAttach();
+    void onProcessDetach();
+    void updateScanProgress();
+private:
+    void connectSignals();
+
+    // runs scan on m_ScanThread, the window stays responsive and the progress bar is polled
+    void startScan(std::function<bool()> scan);
+    void stopScan();
+    void setScanning(bool isScanning);
+
+    void updateCompareComboBox();
+    void updateResultList();
+    void updateScanLastLabel(const QString& message = "");
+    void goToMemoryAddress(std::uint64_t address);
+private:
+    static constexpr int c_MaximumListedResults{ 1000 };
+
+    std::unique_ptr<CValueScanner> m_Scanner{ };
+    std::thread m_ScanThread{ };
+    QTimer* m_ProgressTimer;
+
+    Ui::CScannerWindow *ui;
+    CProcessSelectorWindow* m_ProcessSelector;
+};
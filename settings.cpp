@@ -6,8 +6,6 @@ CSettingsWindow::CSettingsWindow(QWidget *parent)
     , ui(new Ui::CSettings) {
     ui->setupUi(this);
     connectSignals();
-
-    CSettingsManager::settings(this); // initialize CSettingsManager
 }
 
 CSettingsWindow::~CSettingsWindow() {
@@ -106,10 +104,12 @@ void CSettingsWindow::on_settingsCloseButton_clicked() {
 void CSettingsWindow::on_memoryRealTimeUpdateCheckbox_stateChanged(int arg1) {
     bool isEnabled = arg1 == 2;
     MemoryView::m_AutoUpdateEnabled= isEnabled;
+    emit memoryViewAutoUpdateChanged();
 }
 
 void CSettingsWindow::on_memoryUpdateIntervalSlider_valueChanged(int value) {
     MemoryView::m_AutoUpdateInterval = value;
+    emit memoryViewAutoUpdateChanged();
 }
 
 void CSettingsWindow::on_memoryOffsetAbsoluteButton_clicked() {
@@ -1,5 +1,6 @@
 #pragma once
 #include <QDialog>
+#include "process.h"
 
 
 
@@ -9,16 +10,9 @@ class CSettings;
 
 class CSettings {
 public:
-    enum class TRetrieveMethod {
-        None,
-        Snapshot,
-        PEB,
-    };
-    enum class TSort { // ik its not the best idea to put it here
-        None,
-        ID, // not an ID for modules
-        Name,
-    };
+    // the enums live in the core, the lists are configured with them by the windows
+    using TRetrieveMethod = ::TRetrieveMethod;
+    using TSort = ::TSort;
 
     TSort processListSortType() const;
     TSort moduleListSortType() const;
@@ -49,17 +43,6 @@ protected:
     };
 };
 
-// This class is made for places in code where you can not directly access actual CSettings instance like in process.cpp
-class CSettingsManager {
-public:
-    static CSettings* settings(CSettings* inst = nullptr) {
-        static CSettings* instance = inst;
-        if(!instance)
-            throw std::runtime_error("Before calling CSettingsManager::settings you must set an instance of CSettings");
-        return instance;
-    }
-};
-
 class CSettingsWindow : public QDialog, public CSettings {
     Q_OBJECT
 public:
@@ -82,6 +65,7 @@ private slots:
 signals:
     void moduleInfoFormatChanged();
     void memoryViewFormatChanged();
+    void memoryViewAutoUpdateChanged();
     void processListSortTypeChanged();
     void moduleListSortTypeChanged();
     void moduleListRetrieveMethodChanged();
@@ -0,0 +1,232 @@
+#include "signature_scanner.h"
+#include <algorithm>
+#include <bit>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SIGNATURE_SCANNER_SSE2
+#endif
+
+namespace {
+// rough rank of how common a byte is in x86-64 code and data, anchors avoid the common ones
+int byteCommonness(std::uint8_t byte) {
+    switch(byte) {
+    case 0x00: case 0xff: case 0xcc: case 0x90:
+        return 3;
+    case 0x48: case 0x8b: case 0x89: case 0x0f: case 0x4c: case 0x8d: case 0xe8: case 0x24: case 0x44: case 0x85: case 0xc0: case 0x01:
+        return 2;
+    default:
+        return byte < 0x10 ? 1 : 0;
+    }
+}
+}
+
+CSignature::CSignature(const std::string& pattern) {
+    for(std::size_t i = 0; i < pattern.size(); ) {
+        if(pattern[i] == ' ') {
+            ++i;
+            continue;
+        }
+
+        if(pattern[i] == '?') {
+            m_Bytes.push_back(0);
+            m_Mask.push_back(0);
+            i += i + 1 < pattern.size() && pattern[i + 1] == '?' ? 2 : 1;
+            continue;
+        }
+
+        if(i + 1 >= pattern.size() || !std::isxdigit(static_cast<unsigned char>(pattern[i])) || !std::isxdigit(static_cast<unsigned char>(pattern[i + 1])))
+            throw std::invalid_argument("Signature bytes must be two hex digits or ??");
+
+        m_Bytes.push_back(static_cast<std::uint8_t>(std::stoul(pattern.substr(i, 2), nullptr, 16)));
+        m_Mask.push_back(0xff);
+        i += 2;
+    }
+
+    // trailing wildcards never change the outcome but would cost a read past the match
+    while(!m_Mask.empty() && !m_Mask.back()) {
+        m_Mask.pop_back();
+        m_Bytes.pop_back();
+    }
+    if(m_Bytes.empty())
+        throw std::invalid_argument("Signature must contain at least one fixed byte");
+
+    // the rarest fixed byte filters, the last fixed byte (the last byte after trimming) confirms
+    m_SecondAnchor = m_Bytes.size() - 1;
+    m_FirstAnchor = m_SecondAnchor;
+    for(std::size_t i = 0; i < m_Bytes.size(); ++i) {
+        if(m_Mask[i] && byteCommonness(m_Bytes[i]) < byteCommonness(m_Bytes[m_FirstAnchor]))
+            m_FirstAnchor = i;
+    }
+
+    // a wildcard matches any byte, so no shift may jump over it
+    std::size_t lastWildcard{ };
+    bool hasWildcard{ };
+    for(std::size_t i = 0; i + 1 < m_Bytes.size(); ++i) {
+        if(!m_Mask[i]) {
+            lastWildcard = i;
+            hasWildcard = true;
+        }
+    }
+    const std::size_t defaultShift = hasWildcard ? m_Bytes.size() - 1 - lastWildcard : m_Bytes.size();
+    m_Shifts.fill(defaultShift);
+    for(std::size_t i = hasWildcard ? lastWildcard + 1 : 0; i + 1 < m_Bytes.size(); ++i) {
+        m_Shifts[m_Bytes[i]] = m_Bytes.size() - 1 - i;
+    }
+}
+
+std::size_t CSignature::size() const {
+    return m_Bytes.size();
+}
+
+bool CSignature::matches(const std::uint8_t* data) const {
+    for(std::size_t i = 0; i < m_Bytes.size(); ++i) {
+        if((data[i] & m_Mask[i]) != m_Bytes[i])
+            return false;
+    }
+    return true;
+}
+
+std::vector<std::size_t> CSignature::find(std::span<const std::uint8_t> data, bool isFirstOnly) const {
+    if(data.size() < m_Bytes.size())
+        return { };
+
+#ifdef SIGNATURE_SCANNER_SSE2
+    return findAnchored(data, isFirstOnly);
+#else
+    return findHorspool(data, isFirstOnly);
+#endif
+}
+
+std::vector<std::size_t> CSignature::findHorspool(std::span<const std::uint8_t> data, bool isFirstOnly) const {
+    std::vector<std::size_t> offsets{ };
+    const std::size_t last = m_Bytes.size() - 1;
+    for(std::size_t position = 0; position + last < data.size(); position += m_Shifts[data[position + last]]) {
+        if(!matches(data.data() + position))
+            continue;
+
+        offsets.push_back(position);
+        if(isFirstOnly)
+            break;
+    }
+    return offsets;
+}
+
+std::vector<std::size_t> CSignature::findAnchored(std::span<const std::uint8_t> data, bool isFirstOnly) const {
+    std::vector<std::size_t> offsets{ };
+    std::size_t position{ };
+
+#ifdef SIGNATURE_SCANNER_SSE2
+    // compares both anchors at 16 positions at once, only positions where both hit are verified byte by byte
+    const __m128i firstAnchor = _mm_set1_epi8(static_cast<char>(m_Bytes[m_FirstAnchor]));
+    const __m128i secondAnchor = _mm_set1_epi8(static_cast<char>(m_Bytes[m_SecondAnchor]));
+    const std::size_t last = m_Bytes.size() - 1;
+    for(; position + last + 16 <= data.size(); position += 16) {
+        const __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data.data() + position + m_FirstAnchor));
+        const __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data.data() + position + m_SecondAnchor));
+        unsigned candidates = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, firstAnchor), _mm_cmpeq_epi8(second, secondAnchor))));
+        while(candidates) {
+            const unsigned bit = static_cast<unsigned>(std::countr_zero(candidates));
+            candidates &= candidates - 1;
+            if(!matches(data.data() + position + bit))
+                continue;
+
+            offsets.push_back(position + bit);
+            if(isFirstOnly)
+                return offsets;
+        }
+    }
+#endif
+
+    // the tail shorter than a vector
+    for(auto offset : findHorspool(data.subspan(position), isFirstOnly)) {
+        offsets.push_back(position + offset);
+    }
+    return offsets;
+}
+
+CSignatureScanner::CSignatureScanner(std::weak_ptr<IProcessIO> targetProcess)
+    : m_TargetProcess{ targetProcess } { }
+
+std::vector<std::uint64_t> CSignatureScanner::scanModule(const CModule& module, const CSignature& signature, bool isFirstOnly) {
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> ranges{ };
+    for(const auto& section : module.sections()) {
+        const auto [baseAddress, size] = section.info();
+        ranges.push_back({ baseAddress, size });
+    }
+    if(ranges.empty()) {
+        const auto [baseAddress, size] = module.memento().info();
+        ranges.push_back({ baseAddress, size });
+    }
+    return scanRanges(ranges, signature, isFirstOnly);
+}
+
+std::vector<std::uint64_t> CSignatureScanner::scanExecutableRegions(const CSignature& signature, bool isFirstOnly) {
+    auto process = m_TargetProcess.lock();
+    if(!process)
+        return { };
+
+    constexpr std::uint32_t executableProtections{ PAGE_EXECUTE | PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY };
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> ranges{ };
+    for(const auto& region : process->regions()) {
+        if(region.State != MEM_COMMIT || !(region.Protect & executableProtections) || region.Protect & PAGE_GUARD)
+            continue;
+
+        const std::uint64_t baseAddress = reinterpret_cast<std::uint64_t>(region.BaseAddress);
+        if(!ranges.empty() && ranges.back().first + ranges.back().second == baseAddress)
+            ranges.back().second += region.RegionSize; // neighbouring regions are scanned as one so matches may cross them
+        else
+            ranges.push_back({ baseAddress, region.RegionSize });
+    }
+    return scanRanges(ranges, signature, isFirstOnly);
+}
+
+std::vector<std::uint64_t> CSignatureScanner::scanRanges(const std::vector<std::pair<std::uint64_t, std::uint64_t>>& ranges, const CSignature& signature, bool isFirstOnly) {
+    auto process = m_TargetProcess.lock();
+    if(!process)
+        return { };
+
+    struct CChunk {
+        std::uint64_t address{ }, size{ };
+    };
+    std::vector<CChunk> chunks{ };
+    for(const auto& [baseAddress, size] : ranges) {
+        for(std::uint64_t offset = 0; offset < size; offset += c_ChunkSize) {
+            // the overlap lets a match start in this chunk and end in the next one
+            chunks.push_back({ baseAddress + offset, std::min(c_ChunkSize + signature.size() - 1, size - offset) });
+        }
+    }
+    std::sort(chunks.begin(), chunks.end(), [](const CChunk& a, const CChunk& b) -> bool { return a.address < b.address; });
+
+    // with isFirstOnly chunks past the best match so far are skipped, chunks are handed out in ascending order
+    std::atomic<std::uint64_t> firstMatch{ UINT64_MAX };
+    std::vector<std::vector<std::uint64_t>> chunkMatches(chunks.size());
+    Utilities::parallelFor(chunks.size(), [&](std::size_t i) -> void {
+        const auto& chunk = chunks[i];
+        if(isFirstOnly && chunk.address >= firstMatch)
+            return;
+
+        std::vector<std::uint8_t> buffer(chunk.size);
+        for(const auto& [offset, size] : process->readAvailable(chunk.address, static_cast<std::uint32_t>(chunk.size), buffer.data())) {
+            for(auto match : signature.find(std::span<const std::uint8_t>(buffer).subspan(offset, size), isFirstOnly)) {
+                const std::uint64_t address = chunk.address + offset + match;
+                chunkMatches[i].push_back(address);
+
+                std::uint64_t best = firstMatch;
+                while(address < best && !firstMatch.compare_exchange_weak(best, address)) { }
+            }
+            if(isFirstOnly && !chunkMatches[i].empty())
+                break;
+        }
+    });
+
+    std::vector<std::uint64_t> matches{ };
+    for(const auto& chunkMatch : chunkMatches) {
+        matches.insert(matches.end(), chunkMatch.begin(), chunkMatch.end());
+    }
+    // the overlap of two chunks can report the same match twice
+    std::sort(matches.begin(), matches.end());
+    matches.erase(std::unique(matches.begin(), matches.end()), matches.end());
+    if(isFirstOnly && matches.size() > 1)
+        matches.resize(1);
+    return matches;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "process.h"
+#include <atomic>
+
+// byte pattern with wildcards, written like "48 8B ?? ?? 89" ("?" works as a wildcard too)
+class CSignature {
+public:
+    // throws std::invalid_argument on malformed patterns and patterns without a single fixed byte
+    CSignature(const std::string& pattern);
+public:
+    std::size_t size() const;
+    bool matches(const std::uint8_t* data) const;
+    // @return Returns offsets of matches inside data, ascending, at most one when isFirstOnly
+    std::vector<std::size_t> find(std::span<const std::uint8_t> data, bool isFirstOnly = false) const;
+private:
+    std::vector<std::size_t> findHorspool(std::span<const std::uint8_t> data, bool isFirstOnly) const;
+    std::vector<std::size_t> findAnchored(std::span<const std::uint8_t> data, bool isFirstOnly) const;
+
+    std::vector<std::uint8_t> m_Bytes{ };
+    std::vector<std::uint8_t> m_Mask{ }; // 0xff for fixed bytes, 0 for wildcards
+    // fixed bytes the SIMD filter compares at every position, the first one is picked to be rare in code
+    std::size_t m_FirstAnchor{ }, m_SecondAnchor{ };
+    std::array<std::size_t, 256> m_Shifts{ }; // Horspool shifts by the byte under the last pattern position
+};
+
+// Finds signatures in module sections or executable regions. Ranges are split into chunks which are read and searched
+// on all cores, chunks overlap by the signature size - 1 so matches on the boundaries are not lost
+class CSignatureScanner {
+public:
+    CSignatureScanner(std::weak_ptr<IProcessIO> targetProcess);
+    ~CSignatureScanner() = default;
+
+    // sections of the module, the whole module when it has none (not a PE image)
+    // @return Returns addresses of matches, ascending, at most one when isFirstOnly
+    std::vector<std::uint64_t> scanModule(const CModule& module, const CSignature& signature, bool isFirstOnly = false);
+    std::vector<std::uint64_t> scanExecutableRegions(const CSignature& signature, bool isFirstOnly = false);
+    std::vector<std::uint64_t> scanRanges(const std::vector<std::pair<std::uint64_t, std::uint64_t>>& ranges, const CSignature& signature, bool isFirstOnly = false);
+private:
+    static constexpr std::uint64_t c_ChunkSize{ 0x400000 };
+
+    std::weak_ptr<IProcessIO> m_TargetProcess;
+};
@@ -0,0 +1,291 @@
+#include "snapshot.h"
+#include <fstream>
+#include <thread>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+std::uint64_t alignUp(std::uint64_t value, std::uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+}
+
+CSnapshotDumper::CSnapshotDumper(std::weak_ptr<IProcessIO> targetProcess, std::uint64_t bytesPerSecond)
+    : IDumper(targetProcess), m_BytesPerSecond{ bytesPerSecond } { }
+
+const std::vector<std::uint8_t>& CSnapshotDumper::dump() {
+    CMetricScope metric{ TMetric::Dump };
+    auto process = m_TargetProcess.lock();
+    if(!process)
+        return m_Data = { };
+
+    CSnapshotHeader header{ };
+    std::vector<CSnapshotRegion> regions{ };
+    if(!buildLayout(*process, header, regions))
+        return m_Data = { };
+
+    m_Data = std::vector<std::uint8_t>(header.fileSize, 0);
+    const bool isCaptured = capture(*process, header, regions, [this](std::uint64_t offset, const void* data, std::size_t size) -> bool {
+        memcpy(m_Data.data() + offset, data, size);
+        return true;
+    });
+    if(!isCaptured)
+        return m_Data = { };
+
+    metric.setBytes(m_Data.size());
+    metric.succeeded();
+    return m_Data;
+}
+
+bool CSnapshotDumper::dumpToFile(const std::string& path) {
+    CMetricScope metric{ TMetric::Dump };
+    auto process = m_TargetProcess.lock();
+    if(!process)
+        return false;
+
+    CSnapshotHeader header{ };
+    std::vector<CSnapshotRegion> regions{ };
+    if(!buildLayout(*process, header, regions))
+        return false;
+
+    std::ofstream file(path, std::ios::trunc | std::ios::binary);
+    if(!file)
+        return false;
+
+    metric.setBytes(header.fileSize);
+    // reads run in parallel, the writes are serialized and land wherever their chunk belongs
+    std::mutex fileMutex{ };
+    return metric.succeeded(capture(*process, header, regions, [&file, &fileMutex](std::uint64_t offset, const void* data, std::size_t size) -> bool {
+        std::lock_guard lock(fileMutex);
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+        return static_cast<bool>(file);
+    }) && file.flush());
+}
+
+bool CSnapshotDumper::buildLayout(IProcessIO& process, CSnapshotHeader& header, std::vector<CSnapshotRegion>& regions) const {
+    for(const auto& region : process.regions()) {
+        if(region.State == MEM_FREE)
+            continue;
+
+        CSnapshotRegion snapshotRegion{ };
+        snapshotRegion.baseAddress = reinterpret_cast<std::uint64_t>(region.BaseAddress);
+        snapshotRegion.size = region.RegionSize;
+        snapshotRegion.protect = region.Protect;
+        snapshotRegion.state = region.State;
+        snapshotRegion.type = region.Type;
+        if(region.State == MEM_COMMIT && region.Protect && !(region.Protect & (PAGE_NOACCESS | PAGE_GUARD)))
+            snapshotRegion.flags = SnapshotRegionCaptured;
+        regions.push_back(snapshotRegion);
+    }
+    if(regions.empty())
+        return false;
+
+    header.version = c_Version;
+    header.pageSize = c_PageSize;
+    header.processId = process.memento().id();
+    strncpy(header.processName, process.memento().name().c_str(), sizeof(header.processName) - 1);
+    header.timestamp = static_cast<std::uint64_t>(time(NULL));
+    header.regionCount = regions.size();
+    header.indexOffset = sizeof(CSnapshotHeader);
+
+    std::uint64_t offset = alignUp(header.indexOffset + regions.size() * sizeof(CSnapshotRegion), c_PageSize);
+    for(auto& region : regions) {
+        if(!(region.flags & SnapshotRegionCaptured))
+            continue;
+
+        region.fileOffset = offset;
+        offset = alignUp(offset + region.size, c_PageSize);
+        header.capturedSize += region.size;
+    }
+    header.fileSize = offset;
+    return true;
+}
+
+bool CSnapshotDumper::capture(IProcessIO& process, CSnapshotHeader& header, std::vector<CSnapshotRegion>& regions, const TWriter& writer) {
+    struct CChunk {
+        std::size_t region{ };
+        std::uint64_t offset{ }; // from the region start
+        std::uint64_t size{ };
+    };
+    std::vector<CChunk> chunks{ };
+    for(std::size_t i = 0; i < regions.size(); ++i) {
+        if(!(regions[i].flags & SnapshotRegionCaptured))
+            continue;
+
+        for(std::uint64_t offset = 0; offset < regions[i].size; offset += c_ChunkSize) {
+            chunks.push_back({ i, offset, std::min(c_ChunkSize, regions[i].size - offset) });
+        }
+    }
+
+    // chunks of one region may be read by different threads at once
+    std::unique_ptr<std::atomic<std::uint32_t>[]> partialRegions{ new std::atomic<std::uint32_t>[regions.size()]{ } };
+    std::atomic<std::uint64_t> bytesRead{ };
+    std::atomic<bool> isFailed{ };
+    const auto start = std::chrono::steady_clock::now();
+    Utilities::parallelFor(chunks.size(), [&](std::size_t i) -> void {
+        if(isCancelled() || isFailed)
+            return;
+
+        const auto& chunk = chunks[i];
+        const auto& region = regions[chunk.region];
+        std::vector<std::uint8_t> buffer(chunk.size);
+        std::uint64_t readableSize{ };
+        for(const auto& [offset, size] : process.readAvailable(region.baseAddress + chunk.offset, static_cast<std::uint32_t>(chunk.size), buffer.data())) {
+            readableSize += size;
+        }
+        if(readableSize != chunk.size)
+            partialRegions[chunk.region] = SnapshotRegionPartial;
+
+        if(!writer(region.fileOffset + chunk.offset, buffer.data(), buffer.size()))
+            isFailed = true;
+
+        const std::uint64_t totalRead = bytesRead += chunk.size;
+        m_Progress = static_cast<float>(totalRead) / static_cast<float>(header.capturedSize);
+        throttle(totalRead, start);
+    });
+    if(isCancelled() || isFailed)
+        return false;
+
+    for(std::size_t i = 0; i < regions.size(); ++i) {
+        regions[i].flags |= partialRegions[i];
+    }
+
+    // the file size is padded up to the last page so every captured region can be mapped in whole pages
+    static constexpr std::uint8_t zero{ };
+    if(!writer(header.fileSize - 1, &zero, 1))
+        return false;
+
+    if(!writer(header.indexOffset, regions.data(), regions.size() * sizeof(CSnapshotRegion)))
+        return false;
+
+    memcpy(header.magic, c_Magic, sizeof(header.magic));
+    if(!writer(0, &header, sizeof(header)))
+        return false;
+
+    m_Progress = 1.f;
+    return true;
+}
+
+void CSnapshotDumper::throttle(std::uint64_t bytesRead, std::chrono::steady_clock::time_point start) const {
+    if(!m_BytesPerSecond)
+        return;
+
+    // sleeps until the average rate since the start drops to the limit
+    const auto due = start + std::chrono::microseconds(bytesRead * 1000000 / m_BytesPerSecond);
+    if(due > std::chrono::steady_clock::now())
+        std::this_thread::sleep_until(due);
+}
+
+CSnapshotFile::CSnapshotFile(const std::string& path) {
+#ifdef _WIN32
+    m_File = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    LARGE_INTEGER size{ };
+    if(m_File == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_File, &size)) {
+        close();
+        throw std::runtime_error("Can not open snapshot " + path);
+    }
+
+    m_Size = static_cast<std::uint64_t>(size.QuadPart);
+    m_Mapping = m_Size ? CreateFileMappingA(m_File, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+    m_View = m_Mapping ? static_cast<const std::uint8_t*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0)) : std::nullptr_t();
+#else
+    const int file = open(path.c_str(), O_RDONLY);
+    struct stat fileStat{ };
+    if(file == -1 || fstat(file, &fileStat) == -1) {
+        if(file != -1)
+            ::close(file);
+        throw std::runtime_error("Can not open snapshot " + path);
+    }
+
+    m_Size = static_cast<std::uint64_t>(fileStat.st_size);
+    void* view = m_Size ? mmap(std::nullptr_t(), m_Size, PROT_READ, MAP_PRIVATE, file, 0) : MAP_FAILED;
+    ::close(file);
+    m_View = view == MAP_FAILED ? std::nullptr_t() : static_cast<const std::uint8_t*>(view);
+#endif
+
+    const bool isValid =
+        m_View &&
+        m_Size >= sizeof(CSnapshotHeader) &&
+        !memcmp(header().magic, CSnapshotDumper::c_Magic, sizeof(CSnapshotDumper::c_Magic)) &&
+        header().version == CSnapshotDumper::c_Version &&
+        header().fileSize == m_Size &&
+        header().indexOffset + header().regionCount * sizeof(CSnapshotRegion) <= m_Size;
+    if(!isValid) {
+        close();
+        throw std::runtime_error("Not a snapshot or an unfinished one: " + path);
+    }
+}
+
+CSnapshotFile::~CSnapshotFile() {
+    close();
+}
+
+void CSnapshotFile::close() {
+#ifdef _WIN32
+    if(m_View)
+        UnmapViewOfFile(m_View);
+    if(m_Mapping)
+        CloseHandle(m_Mapping);
+    if(m_File != INVALID_HANDLE_VALUE)
+        CloseHandle(m_File);
+    m_Mapping = { };
+    m_File = INVALID_HANDLE_VALUE;
+#else
+    if(m_View)
+        munmap(const_cast<std::uint8_t*>(m_View), m_Size);
+#endif
+    m_View = { };
+}
+
+const CSnapshotHeader& CSnapshotFile::header() const {
+    return *reinterpret_cast<const CSnapshotHeader*>(m_View);
+}
+
+std::span<const CSnapshotRegion> CSnapshotFile::regions() const {
+    return { reinterpret_cast<const CSnapshotRegion*>(m_View + header().indexOffset), header().regionCount };
+}
+
+const CSnapshotRegion* CSnapshotFile::find(std::uint64_t address) const {
+    const auto all = regions();
+    auto region = std::upper_bound(all.begin(), all.end(), address, [](std::uint64_t address, const CSnapshotRegion& region) -> bool {
+        return address < region.baseAddress;
+    });
+    if(region == all.begin())
+        return std::nullptr_t();
+
+    --region;
+    return address < region->baseAddress + region->size ? &*region : std::nullptr_t();
+}
+
+std::span<const std::uint8_t> CSnapshotFile::data(const CSnapshotRegion& region) const {
+    if(!(region.flags & SnapshotRegionCaptured) || region.fileOffset + region.size > m_Size)
+        return { };
+
+    return { m_View + region.fileOffset, region.size };
+}
+
+bool CSnapshotFile::read(std::uint64_t address, std::uint32_t size, void* buffer) const {
+    auto* out = static_cast<std::uint8_t*>(buffer);
+    while(size) {
+        const CSnapshotRegion* region = find(address);
+        if(!region)
+            return false;
+
+        const auto regionData = data(*region);
+        if(regionData.empty())
+            return false;
+
+        const std::uint64_t offset = address - region->baseAddress;
+        const std::uint32_t toCopy = static_cast<std::uint32_t>(std::min<std::uint64_t>(size, region->size - offset));
+        memcpy(out, regionData.data() + offset, toCopy);
+        out += toCopy;
+        address += toCopy;
+        size -= toCopy;
+    }
+    return true;
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include "dumper.h"
+#include <mutex>
+#include <chrono>
+
+// Snapshot file layout, all integers are little-endian:
+//   CSnapshotHeader
+//   CSnapshotRegion[regionCount] at indexOffset, sorted by baseAddress
+//   data of captured regions, each one starting at a multiple of pageSize so it can be mapped on its own
+// The header is written last, a file without the magic is an unfinished capture
+#pragma pack(push, 1)
+struct CSnapshotHeader {
+    char magic[8]{ };
+    std::uint32_t version{ };
+    std::uint32_t pageSize{ };
+    std::uint64_t processId{ };
+    char processName[64]{ };
+    std::uint64_t timestamp{ }; // unix time of the capture start
+    std::uint64_t regionCount{ };
+    std::uint64_t indexOffset{ };
+    std::uint64_t capturedSize{ }; // bytes of region data, padding excluded
+    std::uint64_t fileSize{ };
+};
+
+enum TSnapshotRegionFlags : std::uint32_t {
+    SnapshotRegionCaptured = 1,
+    SnapshotRegionPartial = 2, // some pages could not be read and are zero-filled
+};
+
+struct CSnapshotRegion {
+    std::uint64_t baseAddress{ };
+    std::uint64_t size{ };
+    std::uint64_t fileOffset{ }; // 0 when the region was not captured
+    std::uint32_t protect{ };
+    std::uint32_t state{ };
+    std::uint32_t type{ };
+    std::uint32_t flags{ }; // TSnapshotRegionFlags
+};
+#pragma pack(pop)
+static_assert(sizeof(CSnapshotHeader) == 128 && sizeof(CSnapshotRegion) == 40, "Snapshot structures are a file format");
+
+// Captures every committed readable region of a process into one snapshot file. Regions are split into chunks
+// which are read on all cores, bytesPerSecond (0 - unlimited) throttles the reads of all of them together
+class CSnapshotDumper : public IDumper {
+public:
+    CSnapshotDumper(std::weak_ptr<IProcessIO> targetProcess, std::uint64_t bytesPerSecond = 0);
+    ~CSnapshotDumper() = default;
+
+    // the whole snapshot file in memory, prefer dumpToFile
+    virtual const std::vector<std::uint8_t>& dump() override;
+    // memory use is bounded by the chunk size per core
+    virtual bool dumpToFile(const std::string& path) override;
+
+    static constexpr char c_Magic[8]{ 'M', 'O', 'S', 'N', 'A', 'P', '\0', '\1' };
+    static constexpr std::uint32_t c_Version{ 1 };
+    static constexpr std::uint32_t c_PageSize{ 0x1000 };
+private:
+    static constexpr std::uint64_t c_ChunkSize{ 0x400000 };
+
+    // writes size bytes at offset of the output, called from many threads with disjoint ranges
+    using TWriter = std::function<bool(std::uint64_t offset, const void* data, std::size_t size)>;
+
+    // fills the header (without the magic) and the index, captured regions get their file offsets
+    bool buildLayout(IProcessIO& process, CSnapshotHeader& header, std::vector<CSnapshotRegion>& regions) const;
+    bool capture(IProcessIO& process, CSnapshotHeader& header, std::vector<CSnapshotRegion>& regions, const TWriter& writer);
+    void throttle(std::uint64_t bytesRead, std::chrono::steady_clock::time_point start) const;
+
+    std::uint64_t m_BytesPerSecond{ };
+};
+
+// Read-only view of a snapshot file, the file is memory-mapped so nothing is loaded until it is touched
+class CSnapshotFile {
+public:
+    // throws std::runtime_error when the file can not be mapped or is not a finished snapshot
+    CSnapshotFile(const std::string& path);
+    ~CSnapshotFile();
+
+    CSnapshotFile(const CSnapshotFile&) = delete;
+    CSnapshotFile& operator=(const CSnapshotFile&) = delete;
+
+    const CSnapshotHeader& header() const;
+    std::span<const CSnapshotRegion> regions() const;
+    // @return Returns the region containing address or nullptr
+    const CSnapshotRegion* find(std::uint64_t address) const;
+    // @return Returns captured bytes of region, empty when it was not captured
+    std::span<const std::uint8_t> data(const CSnapshotRegion& region) const;
+    // @return Returns false when any byte of the range was not captured
+    bool read(std::uint64_t address, std::uint32_t size, void* buffer) const;
+private:
+    void close();
+
+    const std::uint8_t* m_View{ };
+    std::uint64_t m_Size{ };
+#ifdef _WIN32
+    HANDLE m_File{ INVALID_HANDLE_VALUE }, m_Mapping{ };
+#endif
+};
@@ -0,0 +1,189 @@
+#pragma once
+#include "process.h"
+#include <map>
+#include <set>
+#include <atomic>
+
+// IProcessIO over regions kept in this process at made-up addresses, for the parts of the core which only need
+// reads and region queries. Nothing is attached, so the tests behave the same on every platform
+class CFakeProcessIO : public IProcessIO {
+public:
+    CFakeProcessIO()
+        : IProcessIO(CProcessMemento(1, "fake")) { }
+
+    // @return Returns the bytes of the region, zero-filled
+    std::uint8_t* addRegion(std::uint64_t address, std::size_t size, std::uint32_t protect = PAGE_READWRITE) {
+        auto& region = m_Regions[address];
+        region.data.assign(size, 0);
+        region.protect = protect;
+        regionMap().invalidate();
+        return region.data.data();
+    }
+
+    void removeRegion(std::uint64_t address) {
+        m_Regions.erase(address);
+        regionMap().invalidate();
+    }
+
+    // reads of the page fail while the region stays committed and readable, like a page swapped out of a core dump
+    void setPageReadable(std::uint64_t pageAddress, bool isReadable) {
+        if(isReadable)
+            m_UnreadablePages.erase(pageAddress);
+        else
+            m_UnreadablePages.insert(pageAddress);
+    }
+
+    struct CFakeSection {
+        std::string name{ };
+        std::uint32_t virtualAddress{ };
+        std::uint32_t virtualSize{ };
+        std::uint32_t rawSize{ };
+    };
+
+    // region of sizeOfImage bytes starting with PE32+ headers which describe the sections, everything else is zeroed
+    // @return Returns the bytes of the image
+    std::uint8_t* addImage(std::uint64_t address, std::uint32_t sizeOfImage, std::uint32_t sizeOfHeaders, const std::vector<CFakeSection>& sections) {
+        std::uint8_t* image = addRegion(address, sizeOfImage, PAGE_READONLY);
+        PIMAGE_DOS_HEADER dosHeader{ reinterpret_cast<PIMAGE_DOS_HEADER>(image) };
+        dosHeader->e_magic = 0x5a4d;
+        dosHeader->e_lfanew = 0x80;
+
+        PIMAGE_NT_HEADERS64 ntHeaders{ reinterpret_cast<PIMAGE_NT_HEADERS64>(image + dosHeader->e_lfanew) };
+        ntHeaders->Signature = 0x4550;
+        ntHeaders->FileHeader.NumberOfSections = static_cast<WORD>(sections.size());
+        ntHeaders->FileHeader.SizeOfOptionalHeader = sizeof(IMAGE_OPTIONAL_HEADER64);
+        ntHeaders->OptionalHeader.ImageBase = address;
+        ntHeaders->OptionalHeader.SizeOfImage = sizeOfImage;
+        ntHeaders->OptionalHeader.SizeOfHeaders = sizeOfHeaders;
+
+        PIMAGE_SECTION_HEADER sectionHeaders{ IMAGE_FIRST_SECTION(ntHeaders) };
+        DWORD pointerToRawData{ 0x400 };
+        for(std::size_t i = 0; i < sections.size(); ++i) {
+            memcpy(sectionHeaders[i].Name, sections[i].name.data(), std::min<std::size_t>(sections[i].name.size(), IMAGE_SIZEOF_SHORT_NAME));
+            sectionHeaders[i].Misc.VirtualSize = sections[i].virtualSize;
+            sectionHeaders[i].VirtualAddress = sections[i].virtualAddress;
+            sectionHeaders[i].SizeOfRawData = sections[i].rawSize;
+            sectionHeaders[i].PointerToRawData = pointerToRawData;
+            pointerToRawData += sections[i].rawSize;
+        }
+        return image;
+    }
+
+    // what the next module list refresh retrieves
+    void setModules(const std::vector<CModuleMemento>& modules) {
+        m_Modules = modules;
+    }
+
+    // single reads, each request of a scatter read counts as one
+    std::size_t reads() const {
+        return m_Reads;
+    }
+
+    std::size_t scatterReads() const {
+        return m_ScatterReads;
+    }
+
+    template<typename T>
+    void put(std::uint64_t address, T value) {
+        memcpy(bytes(address, sizeof(T)), &value, sizeof(T));
+    }
+
+    virtual bool readToBuffer(std::uint64_t address, std::uint32_t size, void* buffer) override {
+        ++m_Reads;
+        const std::uint8_t* source = bytes(address, size);
+        if(!source)
+            return false;
+
+        memcpy(buffer, source, size);
+        return true;
+    }
+
+    virtual std::size_t readScatter(std::span<CReadRequest> requests) override {
+        ++m_ScatterReads;
+        return IProcessIO::readScatter(requests);
+    }
+
+    virtual bool writeFromBuffer(std::uint64_t address, std::uint32_t size, void* buffer) override {
+        std::uint8_t* destination = bytes(address, size);
+        if(!destination)
+            return false;
+
+        memcpy(destination, buffer, size);
+        return true;
+    }
+
+    virtual MBIEx query(std::uint64_t address) override {
+        MEMORY_BASIC_INFORMATION mbi{ };
+        auto region = m_Regions.upper_bound(address);
+        if(region != m_Regions.begin() && address < std::prev(region)->first + std::prev(region)->second.data.size()) {
+            --region;
+            mbi.BaseAddress = mbi.AllocationBase = reinterpret_cast<PVOID>(region->first);
+            mbi.RegionSize = region->second.data.size();
+            mbi.State = MEM_COMMIT;
+            mbi.Protect = mbi.AllocationProtect = region->second.protect;
+            mbi.Type = MEM_PRIVATE;
+            return MBIEx{ mbi };
+        }
+
+        const std::uint64_t gapStart = region == m_Regions.begin() ? 0 : std::prev(region)->first + std::prev(region)->second.data.size();
+        const std::uint64_t gapEnd = region == m_Regions.end() ? c_MaximumUserAddress : region->first;
+        mbi.BaseAddress = reinterpret_cast<PVOID>(gapStart);
+        mbi.RegionSize = gapEnd - gapStart;
+        mbi.State = MEM_FREE;
+        mbi.Protect = PAGE_NOACCESS;
+        return MBIEx{ mbi };
+    }
+
+    virtual std::unique_ptr<IRetrieveModuleListStrategy> moduleListStrategy() override {
+        return std::make_unique<CRetrieveModuleListFake>(this, m_Modules);
+    }
+
+    virtual std::tuple<bool, std::uint32_t> protect(std::uint64_t, std::uint32_t, std::uint32_t) override {
+        return { };
+    }
+private:
+    class CRetrieveModuleListFake : public IRetrieveModuleListStrategy {
+    public:
+        CRetrieveModuleListFake(IProcessIO* thisProcess, const std::vector<CModuleMemento>& modules)
+            : IRetrieveModuleListStrategy(thisProcess), m_Modules{ modules } { }
+
+        virtual std::vector<CModule> retrieve() const override {
+            std::vector<CModule> modules{ };
+            for(const auto& module : m_Modules) {
+                modules.emplace_back(module, m_ThisProcess);
+            }
+            return modules;
+        }
+    private:
+        std::vector<CModuleMemento> m_Modules{ };
+    };
+
+    struct CRegion {
+        std::vector<std::uint8_t> data{ };
+        std::uint32_t protect{ };
+    };
+
+    // @return Returns nullptr unless the range lies inside one readable region and touches no unreadable page
+    std::uint8_t* bytes(std::uint64_t address, std::size_t size) {
+        auto region = m_Regions.upper_bound(address);
+        if(region == m_Regions.begin())
+            return std::nullptr_t();
+        --region;
+
+        auto& data = region->second.data;
+        if(address - region->first > data.size() || size > data.size() - (address - region->first))
+            return std::nullptr_t();
+        if(region->second.protect & (PAGE_NOACCESS | PAGE_GUARD))
+            return std::nullptr_t();
+        for(std::uint64_t page = address & ~0xfffull; page < address + size; page += 0x1000) {
+            if(m_UnreadablePages.contains(page))
+                return std::nullptr_t();
+        }
+        return data.data() + (address - region->first);
+    }
+
+    std::map<std::uint64_t, CRegion> m_Regions{ };
+    std::set<std::uint64_t> m_UnreadablePages{ };
+    std::vector<CModuleMemento> m_Modules{ };
+    std::atomic<std::size_t> m_Reads{ }, m_ScatterReads{ };
+};
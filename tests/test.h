@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdio>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Minimal test registry shared by the test executables, each executable is one ctest test. CHECK records a failure
+// and continues, REQUIRE ends the test case
+namespace Test {
+struct CCase {
+    const char* name{ };
+    std::function<void()> body{ };
+};
+
+// thrown by REQUIRE, caught by run()
+struct CRequireFailed { };
+
+inline std::vector<CCase>& cases() {
+    static std::vector<CCase> cases{ };
+    return cases;
+}
+
+inline int& failures() {
+    static int failures{ };
+    return failures;
+}
+
+inline bool check(bool condition, const char* expression, const char* file, int line) {
+    if(!condition) {
+        fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+        ++failures();
+    }
+    return condition;
+}
+
+struct CRegistrar {
+    CRegistrar(const char* name, std::function<void()> body) {
+        cases().push_back({ name, std::move(body) });
+    }
+};
+
+// @return Returns the exit code of the test executable
+inline int run() {
+    int failedCases{ };
+    for(const auto& testCase : cases()) {
+        const int failuresBefore = failures();
+        try {
+            testCase.body();
+        } catch(const CRequireFailed&) {
+        } catch(const std::exception& e) {
+            fprintf(stderr, "%s: unexpected exception: %s\n", testCase.name, e.what());
+            ++failures();
+        }
+
+        const bool isPassed = failures() == failuresBefore;
+        failedCases += !isPassed;
+        fprintf(stderr, "[%s] %s\n", isPassed ? "pass" : "FAIL", testCase.name);
+    }
+    fprintf(stderr, "%zu cases, %d failed\n", cases().size(), failedCases);
+    return failedCases ? 1 : 0;
+}
+}
+
+#define TEST_CASE(name) \
+    static void name(); \
+    static const Test::CRegistrar name##Registrar{ #name, name }; \
+    static void name()
+
+#define CHECK(condition) Test::check(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
+#define REQUIRE(condition) do { if(!CHECK(condition)) throw Test::CRequireFailed{ }; } while(false)
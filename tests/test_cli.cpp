@@ -0,0 +1,82 @@
+#include "test.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <string>
+#include <vector>
+
+// memobserver-cli argument validation, the executable runs with its stdout captured and its stderr discarded
+namespace {
+constexpr int c_ExitUsage{ 1 }, c_ExitTargetFailed{ 2 };
+
+struct CRunResult {
+    int exitCode{ -1 };
+    std::string output{ };
+};
+
+CRunResult run(const std::vector<std::string>& arguments) {
+    int output[2]{ };
+    if(pipe(output) == -1)
+        return { };
+
+    const pid_t child = fork();
+    if(child == 0) {
+        dup2(output[1], STDOUT_FILENO);
+        const int null = open("/dev/null", O_WRONLY);
+        dup2(null, STDERR_FILENO);
+        close(output[0]);
+
+        std::vector<char*> argv{ const_cast<char*>(MEMOBSERVER_CLI) };
+        for(const auto& argument : arguments) {
+            argv.push_back(const_cast<char*>(argument.c_str()));
+        }
+        argv.push_back(std::nullptr_t());
+        execv(MEMOBSERVER_CLI, argv.data());
+        _exit(127);
+    }
+    close(output[1]);
+
+    CRunResult result{ };
+    char buffer[0x400];
+    for(ssize_t received{ }; (received = read(output[0], buffer, sizeof(buffer))) > 0;) {
+        result.output.append(buffer, static_cast<std::size_t>(received));
+    }
+    close(output[0]);
+
+    int status{ };
+    if(child > 0 && waitpid(child, &status, 0) == child && WIFEXITED(status))
+        result.exitCode = WEXITSTATUS(status);
+    return result;
+}
+}
+
+TEST_CASE(rejectsMissingOrUnknownCommands) {
+    CHECK(run({ }).exitCode == c_ExitUsage);
+    CHECK(run({ "attach", "1" }).exitCode == c_ExitUsage);
+    CHECK(run({ "read", "1", "1000" }).exitCode == c_ExitUsage);
+}
+
+TEST_CASE(rejectsInvalidArgumentsBeforeOpeningTargets) {
+    CHECK(run({ "read", "1", "zz", "10" }).exitCode == c_ExitUsage);
+    CHECK(run({ "read", "1", "1000", "0" }).exitCode == c_ExitUsage);
+    CHECK(run({ "read", "1", "1000", "100000000" }).exitCode == c_ExitUsage);
+    CHECK(run({ "snapshot", "1", "/tmp", "fast" }).exitCode == c_ExitUsage);
+    CHECK(run({ "snapshot", "1", "/tmp", "18446744073709551615" }).exitCode == c_ExitUsage);
+    CHECK(run({ "find", "1", "u8", "3" }).exitCode == c_ExitUsage);
+}
+
+TEST_CASE(reportsEachTargetWhichCanNotBeOpened) {
+    const auto outOfRange = run({ "modules", "4294967296" });
+    CHECK(outOfRange.exitCode == c_ExitTargetFailed);
+    CHECK(outOfRange.output.find("Process id out of range") != std::string::npos);
+
+    const auto notANumber = run({ "modules", "12abc,-1" });
+    CHECK(notANumber.exitCode == c_ExitTargetFailed);
+    CHECK(notANumber.output.find("\"target\":\"12abc\"") != std::string::npos);
+    CHECK(notANumber.output.find("\"target\":\"-1\"") != std::string::npos);
+}
+
+int main() {
+    return Test::run();
+}
@@ -0,0 +1,124 @@
+#include "test.h"
+#include "fake_process.h"
+#include "dump_queue.h"
+#include <thread>
+
+namespace {
+// a directory of its own per test run, removed again by the destructor
+class CTemporaryDirectory {
+public:
+    CTemporaryDirectory()
+        : m_Path{ std::filesystem::temp_directory_path() / ("memobserver_test_dump_queue_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count())) } {
+        std::filesystem::create_directories(m_Path);
+    }
+    ~CTemporaryDirectory() {
+        std::filesystem::remove_all(m_Path);
+    }
+
+    std::string path(const std::string& name) const {
+        return (m_Path / name).string();
+    }
+private:
+    std::filesystem::path m_Path{ };
+};
+
+// runs until it is cancelled
+class CBlockingDumper : public IDumper {
+public:
+    CBlockingDumper()
+        : IDumper(std::weak_ptr<IProcessIO>()) { }
+
+    virtual const std::vector<std::uint8_t>& dump() override {
+        m_IsStarted = true;
+        while(!isCancelled()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return m_Data = { };
+    }
+
+    std::atomic<bool> m_IsStarted{ };
+};
+
+// @return Returns the finished jobs once there are count of them, empty after a few seconds
+std::vector<CDumpJobStatus> waitForFinished(CDumpQueue& queue, std::size_t count) {
+    std::vector<CDumpJobStatus> finished{ };
+    for(int i = 0; i < 5000 && finished.size() < count; ++i) {
+        const auto taken = queue.takeFinished();
+        finished.insert(finished.end(), taken.begin(), taken.end());
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return finished.size() == count ? finished : std::vector<CDumpJobStatus>{ };
+}
+
+std::vector<std::uint8_t> readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<std::uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+}
+
+TEST_CASE(savesSectionDump) {
+    const CTemporaryDirectory directory{ };
+    auto process = std::make_shared<CFakeProcessIO>();
+    std::uint8_t* bytes = process->addRegion(0x10000, 0x2000);
+    for(std::size_t i = 0; i < 0x2000; ++i) {
+        bytes[i] = static_cast<std::uint8_t>(i ^ (i >> 8));
+    }
+
+    CDumpQueue queue(2);
+    const std::size_t id = queue.enqueue(std::make_unique<CSectionDumper>(process, 0x10800, 0x1000), ".text", directory.path("text.dmp"));
+    const auto finished = waitForFinished(queue, 1);
+    REQUIRE(finished.size() == 1);
+    CHECK(finished[0].id == id && finished[0].state == TDumpJobState::Done);
+    CHECK(readFile(directory.path("text.dmp")) == std::vector<std::uint8_t>(bytes + 0x800, bytes + 0x1800));
+
+    // finished jobs are handed out once
+    CHECK(queue.takeFinished().empty());
+    CHECK(!queue.isBusy() && queue.jobs().empty());
+}
+
+TEST_CASE(failsOnExistingFileOrUnreadableMemory) {
+    const CTemporaryDirectory directory{ };
+    auto process = std::make_shared<CFakeProcessIO>();
+    process->addRegion(0x10000, 0x1000);
+    std::ofstream(directory.path("existing.dmp")) << "keep";
+
+    CDumpQueue queue(1);
+    queue.enqueue(std::make_unique<CSectionDumper>(process, 0x10000, 0x1000), "existing", directory.path("existing.dmp"));
+    queue.enqueue(std::make_unique<CSectionDumper>(process, 0x30000, 0x1000), "unmapped", directory.path("unmapped.dmp"));
+    const auto finished = waitForFinished(queue, 2);
+    REQUIRE(finished.size() == 2);
+    CHECK(finished[0].state == TDumpJobState::Failed && finished[1].state == TDumpJobState::Failed);
+    CHECK(readFile(directory.path("existing.dmp")).size() == 4);
+    CHECK(!std::filesystem::exists(directory.path("unmapped.dmp")));
+}
+
+TEST_CASE(cancelsQueuedAndRunningJobs) {
+    const CTemporaryDirectory directory{ };
+    auto process = std::make_shared<CFakeProcessIO>();
+    process->addRegion(0x10000, 0x1000);
+
+    // one worker, the second job stays queued behind the blocking one
+    CDumpQueue queue(1);
+    auto blockingDumper = std::make_unique<CBlockingDumper>();
+    const auto& isStarted = blockingDumper->m_IsStarted;
+    const std::size_t runningId = queue.enqueue(std::move(blockingDumper), "running", directory.path("running.dmp"));
+    const std::size_t queuedId = queue.enqueue(std::make_unique<CSectionDumper>(process, 0x10000, 0x1000), "queued", directory.path("queued.dmp"));
+    for(int i = 0; i < 5000 && !isStarted; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    REQUIRE(isStarted);
+    REQUIRE(queue.jobs().size() == 2);
+    CHECK(queue.jobs()[0].state == TDumpJobState::Running && queue.jobs()[1].state == TDumpJobState::Queued);
+
+    queue.cancel(queuedId);
+    queue.cancel(runningId);
+    const auto finished = waitForFinished(queue, 2);
+    REQUIRE(finished.size() == 2);
+    CHECK(finished[0].state == TDumpJobState::Cancelled && finished[1].state == TDumpJobState::Cancelled);
+    CHECK(!std::filesystem::exists(directory.path("running.dmp")) && !std::filesystem::exists(directory.path("queued.dmp")));
+    CHECK(!queue.isBusy());
+}
+
+int main() {
+    return Test::run();
+}
@@ -0,0 +1,72 @@
+#include "test.h"
+#include "fake_process.h"
+#include "dumper.h"
+#include <algorithm>
+
+namespace {
+constexpr std::uint64_t c_ImageBase{ 0x400000 };
+constexpr std::uint32_t c_SizeOfImage{ 0x5000 };
+// the headers reach into the second page, CModule only reads the first one
+constexpr std::uint32_t c_SizeOfHeaders{ 0x1200 };
+
+std::vector<std::uint8_t> readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<std::uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+bool isZero(const std::vector<std::uint8_t>& data, std::size_t begin, std::size_t end) {
+    return std::all_of(data.begin() + begin, data.begin() + end, [](std::uint8_t byte) { return byte == 0; });
+}
+
+bool isSame(const std::vector<std::uint8_t>& data, const std::uint8_t* image, std::size_t begin, std::size_t end) {
+    return std::equal(data.begin() + begin, data.begin() + end, image + begin);
+}
+}
+
+TEST_CASE(streamsImageAndZeroFillsUnreadablePages) {
+    auto process = std::make_shared<CFakeProcessIO>();
+    std::uint8_t* image = process->addImage(c_ImageBase, c_SizeOfImage, c_SizeOfHeaders, {
+        { ".text", 0x2000, 0x1800, 0x2000 },
+        { ".data", 0x4000, 0x800, 0x1000 },
+    });
+    for(std::uint32_t i = 0x1000; i < c_SizeOfImage; ++i) {
+        image[i] = static_cast<std::uint8_t>(i % 251 + 1);
+    }
+    // swapped out in the middle of .text
+    process->setPageReadable(c_ImageBase + 0x3000, false);
+
+    const std::string path = (std::filesystem::temp_directory_path() / "memobserver_test_dumper.dmp").string();
+    CModuleDumper dumper(process, c_ImageBase);
+    REQUIRE(dumper.dumpToFile(path));
+    CHECK(dumper.progress() == 1.f);
+    const auto data = readFile(path);
+    std::filesystem::remove(path);
+    REQUIRE(data.size() == c_SizeOfImage);
+
+    CHECK(isSame(data, image, 0, 0x80));
+    CHECK(isSame(data, image, 0x1000, c_SizeOfHeaders));
+    CHECK(isZero(data, c_SizeOfHeaders, 0x2000));
+    CHECK(isSame(data, image, 0x2000, 0x3000));
+    CHECK(isZero(data, 0x3000, 0x4000));
+    CHECK(isSame(data, image, 0x4000, c_SizeOfImage));
+
+    // section headers of the dump describe the image layout
+    const auto* ntHeaders = reinterpret_cast<const IMAGE_NT_HEADERS64*>(data.data() + 0x80);
+    const IMAGE_SECTION_HEADER* sections = IMAGE_FIRST_SECTION(const_cast<PIMAGE_NT_HEADERS64>(ntHeaders));
+    CHECK(sections[0].PointerToRawData == 0x2000 && sections[0].SizeOfRawData == 0x1800);
+    CHECK(sections[1].PointerToRawData == 0x4000 && sections[1].SizeOfRawData == 0x800);
+}
+
+TEST_CASE(refusesImagesWithoutHeaders) {
+    auto process = std::make_shared<CFakeProcessIO>();
+    process->addRegion(c_ImageBase, c_SizeOfImage);
+
+    const std::string path = (std::filesystem::temp_directory_path() / "memobserver_test_dumper_empty.dmp").string();
+    CModuleDumper dumper(process, c_ImageBase);
+    CHECK(!dumper.dumpToFile(path));
+    CHECK(!std::filesystem::exists(path));
+}
+
+int main() {
+    return Test::run();
+}
@@ -0,0 +1,101 @@
+#include "test.h"
+#include "utilities.h"
+#include <random>
+
+namespace {
+using TInstructionSet = Utilities::TInstructionSet;
+
+std::string referenceHex(std::span<const std::uint8_t> bytes) {
+    std::string text{ };
+    char buffer[4]{ };
+    for(const auto byte : bytes) {
+        snprintf(buffer, sizeof(buffer), "%02x ", byte);
+        text += buffer;
+    }
+    return text;
+}
+
+std::string referenceASCII(std::span<const std::uint8_t> bytes) {
+    std::string text{ };
+    for(const auto byte : bytes) {
+        text += byte > 0x20 && byte < 0x7f ? static_cast<char>(byte) : '.';
+    }
+    return text;
+}
+}
+
+TEST_CASE(kernelsMatchReference) {
+    // every set the CPU has is compared, lengths cover the 32 and 16 byte blocks and every tail
+    std::mt19937 random{ 7 };
+    for(std::size_t size = 0; size <= 200; ++size) {
+        std::vector<std::uint8_t> bytes(size);
+        for(auto& byte : bytes) {
+            byte = static_cast<std::uint8_t>(random());
+        }
+        const std::string hex = referenceHex(bytes), ascii = referenceASCII(bytes);
+
+        for(const auto set : { TInstructionSet::Scalar, TInstructionSet::SSSE3, TInstructionSet::AVX2 }) {
+            if(set > Utilities::instructionSet())
+                continue;
+
+            std::string text(size * 3 + 1, '#');
+            CHECK(Utilities::bytesToHex(bytes.data(), size, text.data(), set) == text.data() + size * 3);
+            CHECK(text.substr(0, size * 3) == hex);
+            CHECK(text.back() == '#'); // nothing written past the end
+
+            std::string chars(size + 1, '#');
+            CHECK(Utilities::bytesToASCII(bytes.data(), size, chars.data(), set) == chars.data() + size);
+            CHECK(chars.substr(0, size) == ascii);
+            CHECK(chars.back() == '#');
+        }
+    }
+}
+
+TEST_CASE(kernelsHandleEveryByteValue) {
+    std::vector<std::uint8_t> bytes(256);
+    for(std::size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<std::uint8_t>(i);
+    }
+
+    std::string hex(bytes.size() * 3, '\0'), ascii(bytes.size(), '\0');
+    Utilities::bytesToHex(bytes.data(), bytes.size(), hex.data());
+    Utilities::bytesToASCII(bytes.data(), bytes.size(), ascii.data());
+    CHECK(hex == referenceHex(bytes));
+    CHECK(ascii == referenceASCII(bytes));
+}
+
+TEST_CASE(maskPatchesUnreadableBytes) {
+    const std::vector<std::uint8_t> bytes{ 0x41, 0x42, 0x43, 0x44, 0x45 };
+    CBytesProtectionMaskFormattablePlain mask(bytes.size());
+    mask.setProtection(1, 2, PAGE_NOACCESS);
+    mask.setProtection(3, 1, PAGE_GUARD);
+
+    CHECK(mask.formatHex(bytes, 0) == "41 ?? ?? xx 45 ");
+    CHECK(mask.formatRows(bytes, 0, 4) == "41 ?? ?? xx ABCD\n45 E\n");
+    CHECK(mask.runCount() == 4);
+}
+
+TEST_CASE(maskKeepsMinimalRuns) {
+    using TByteType = CBytesProtectionMask::TByteType;
+    CBytesProtectionMask mask(0x1000);
+    CHECK(mask.runCount() == 1 && mask.runEnd(0) == 0x1000);
+
+    mask.setType(0x100, 0x100, TByteType::NoAccess);
+    CHECK(mask.runCount() == 3);
+    CHECK(mask[0xff] == TByteType::None && mask[0x100] == TByteType::NoAccess && mask[0x200] == TByteType::None);
+    CHECK(mask.runEnd(0x150) == 0x200);
+
+    // an adjacent range of the same type joins the run, writing the old type back splits and merges again
+    mask.setType(0x200, 0x80, TByteType::NoAccess);
+    CHECK(mask.runCount() == 3 && mask.runEnd(0x100) == 0x280);
+    mask[0x180] = TByteType::Guarded;
+    CHECK(mask.runCount() == 5);
+    mask[0x180] = TByteType::NoAccess;
+    CHECK(mask.runCount() == 3);
+    mask.setType(0, 0x1000, TByteType::None);
+    CHECK(mask.runCount() == 1);
+}
+
+int main() {
+    return Test::run();
+}
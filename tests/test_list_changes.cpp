@@ -0,0 +1,119 @@
+#include "test.h"
+#include "fake_process.h"
+
+namespace {
+// names follow the addresses, so every sort type keeps this order
+CModuleMemento moduleAt(std::uint64_t baseAddress, const std::string& name) {
+    return CModuleMemento(baseAddress, 0x3000, name);
+}
+
+std::vector<std::string> namesOf(const CModuleList& list) {
+    std::vector<std::string> names{ };
+    for(const auto& module : list.data()) {
+        names.push_back(module.memento().name());
+    }
+    return names;
+}
+
+// applies the changes the way the list windows do: removals first, then insertions
+std::vector<int> apply(std::vector<int> rows, const std::vector<int>& current, const CListChanges& changes) {
+    for(const auto row : changes.removedRows) {
+        rows.erase(rows.begin() + static_cast<std::ptrdiff_t>(row));
+    }
+    for(const auto row : changes.addedRows) {
+        rows.insert(rows.begin() + static_cast<std::ptrdiff_t>(row), current[row]);
+    }
+    return rows;
+}
+}
+
+TEST_CASE(identicalListsHaveNoChanges) {
+    const std::vector<int> rows{ 1, 2, 3 };
+    CHECK(CListChanges::compare(rows, rows).isEmpty());
+    CHECK(CListChanges::compare(std::vector<int>{ }, std::vector<int>{ }).isEmpty());
+}
+
+TEST_CASE(comparesRemovedAndAddedRows) {
+    const std::vector<int> previous{ 1, 2, 3, 4, 5 }, current{ 0, 2, 4, 6 };
+    const CListChanges changes = CListChanges::compare(previous, current);
+
+    CHECK((changes.removedRows == std::vector<std::size_t>{ 4, 2, 0 }));
+    CHECK((changes.addedRows == std::vector<std::size_t>{ 0, 3 }));
+    CHECK(!changes.isReordered);
+    CHECK(apply(previous, current, changes) == current);
+}
+
+TEST_CASE(startsFromAnEmptyList) {
+    const std::vector<int> current{ 7, 8 };
+    const CListChanges changes = CListChanges::compare(std::vector<int>{ }, current);
+
+    CHECK(changes.removedRows.empty());
+    CHECK((changes.addedRows == std::vector<std::size_t>{ 0, 1 }));
+    CHECK(apply({ }, current, changes) == current);
+}
+
+TEST_CASE(detectsReorderedKeptRows) {
+    const std::vector<int> previous{ 1, 2, 3 }, current{ 3, 2, 1, 4 };
+    const CListChanges changes = CListChanges::compare(previous, current);
+
+    CHECK(changes.isReordered);
+    CHECK(changes.removedRows.empty());
+    CHECK((changes.addedRows == std::vector<std::size_t>{ 3 }));
+}
+
+TEST_CASE(comparesCompositeKeys) {
+    // processes are keyed by id and name, an exec keeps the id but replaces the row
+    using TKey = std::tuple<std::uint32_t, std::string>;
+    const std::vector<TKey> previous{ { 10, "bash" }, { 11, "sleep" } }, current{ { 10, "vim" }, { 11, "sleep" } };
+    const CListChanges changes = CListChanges::compare(previous, current);
+
+    CHECK((changes.removedRows == std::vector<std::size_t>{ 0 }));
+    CHECK((changes.addedRows == std::vector<std::size_t>{ 0 }));
+    CHECK(!changes.isReordered);
+}
+
+TEST_CASE(firstRefreshAddsEveryModule) {
+    CFakeProcessIO process{ };
+    process.setModules({ moduleAt(0x400000, "a.so"), moduleAt(0x500000, "b.so") });
+    CModuleList list(&process);
+    CHECK(list.data().empty());
+
+    CHECK((list.refresh().addedRows == std::vector<std::size_t>{ 0, 1 }));
+    CHECK((namesOf(list) == std::vector<std::string>{ "a.so", "b.so" }));
+    CHECK(list.refresh().isEmpty());
+}
+
+TEST_CASE(reportsRemovedAndAddedRows) {
+    CFakeProcessIO process{ };
+    process.setModules({ moduleAt(0x400000, "a.so"), moduleAt(0x500000, "b.so"), moduleAt(0x600000, "c.so"), moduleAt(0x700000, "d.so") });
+    CModuleList list(&process);
+    list.refresh();
+
+    process.setModules({ moduleAt(0x400000, "a.so"), moduleAt(0x580000, "bb.so"), moduleAt(0x600000, "c.so"), moduleAt(0x800000, "e.so") });
+    const auto changes = list.refresh();
+    CHECK((changes.removedRows == std::vector<std::size_t>{ 3, 1 }));
+    CHECK((changes.addedRows == std::vector<std::size_t>{ 1, 3 }));
+    CHECK(!changes.isReordered);
+    CHECK((namesOf(list) == std::vector<std::string>{ "a.so", "bb.so", "c.so", "e.so" }));
+}
+
+TEST_CASE(keptModulesKeepParsedHeaders) {
+    CFakeProcessIO process{ };
+    process.addImage(0x400000, 0x3000, 0x400, { { ".text", 0x1000, 0x800, 0x1000 } });
+    process.setModules({ moduleAt(0x400000, "a.so") });
+    CModuleList list(&process);
+    list.refresh();
+    CHECK(list.data()[0].sections().size() == 1);
+    CHECK(process.reads() == 1);
+
+    // same base address and size, the module is the previous one and is not parsed again
+    process.setModules({ moduleAt(0x400000, "a.so"), moduleAt(0x500000, "b.so") });
+    CHECK((list.refresh().addedRows == std::vector<std::size_t>{ 1 }));
+    CHECK(list.data()[0].isParsed() && !list.data()[1].isParsed());
+    CHECK(list.data()[0].sections().size() == 1);
+    CHECK(process.reads() == 1);
+}
+
+int main() {
+    return Test::run();
+}
@@ -0,0 +1,129 @@
+#include "test.h"
+#include "fake_process.h"
+#include "snapshot.h"
+#include "memory_diff.h"
+#include <filesystem>
+#include <chrono>
+
+namespace {
+constexpr std::uint64_t c_PageSize{ 0x1000 };
+
+// removes the file when the test case ends
+struct CTemporaryPath {
+    explicit CTemporaryPath(const std::string& name)
+        : path{ (std::filesystem::temp_directory_path() / ("memobserver_test_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + name)).string() } { }
+    ~CTemporaryPath() {
+        std::error_code error{ };
+        std::filesystem::remove(path, error);
+    }
+
+    std::string path;
+};
+
+void fill(std::uint8_t* data, std::size_t size, std::uint8_t seed) {
+    for(std::size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<std::uint8_t>(seed + i * 7);
+    }
+}
+}
+
+TEST_CASE(diffReportsChangedPages) {
+    auto process = std::make_shared<CFakeProcessIO>();
+    std::uint8_t* data = process->addRegion(0x10000, 4 * c_PageSize);
+    fill(data, 4 * c_PageSize, 3);
+
+    CMemoryDiff diff(process);
+    CMemoryDiffResult result{ };
+    CHECK(!diff.diff(result));
+    REQUIRE(diff.capture());
+    CHECK(diff.capturedPages() == 4);
+
+    REQUIRE(diff.diff(result));
+    CHECK(result.changedPages.empty() && result.addedRegions.empty() && result.removedRegions.empty());
+
+    data[0x1010] ^= 0xff;
+    data[0x3ff0] ^= 0xff;
+    REQUIRE(diff.diff(result));
+    CHECK((result.changedPages == std::vector<std::uint64_t>{ 0x11000, 0x13000 }));
+    CHECK(result.changedBytes.empty()); // nothing was retained
+}
+
+TEST_CASE(diffReportsRetainedBytesOnce) {
+    auto process = std::make_shared<CFakeProcessIO>();
+    std::uint8_t* data = process->addRegion(0x10000, 4 * c_PageSize);
+    fill(data, 4 * c_PageSize, 4);
+
+    // overlapping and adjacent ranges become one, out of order on purpose
+    CMemoryDiff diff(process);
+    diff.retainRange(0x12000, 0x10);
+    diff.retainRange(0x11008, 0x1000);
+    diff.retainRange(0x11000, 0x10);
+    REQUIRE(diff.capture());
+
+    const std::uint8_t before[]{ data[0x1010], data[0x1011], data[0x2ffe] };
+    data[0x1010] ^= 0xff;
+    data[0x1011] ^= 0xff;
+    data[0x2ffe] ^= 0xff;
+    data[0x3000] ^= 0xff; // not retained
+
+    CMemoryDiffResult result{ };
+    REQUIRE(diff.diff(result));
+    CHECK((result.changedPages == std::vector<std::uint64_t>{ 0x11000, 0x12000, 0x13000 }));
+    REQUIRE(result.changedBytes.size() == 2);
+    CHECK(result.changedBytes[0].address == 0x11010);
+    CHECK((result.changedBytes[0].before == std::vector<std::uint8_t>{ before[0], before[1] }));
+    CHECK((result.changedBytes[0].after == std::vector<std::uint8_t>{ data[0x1010], data[0x1011] }));
+    CHECK(result.changedBytes[1].address == 0x12ffe);
+    CHECK((result.changedBytes[1].before == std::vector<std::uint8_t>{ before[2] }));
+}
+
+TEST_CASE(diffSkipsUnreadableRetainedPages) {
+    auto process = std::make_shared<CFakeProcessIO>();
+    std::uint8_t* data = process->addRegion(0x10000, 2 * c_PageSize);
+    fill(data, 2 * c_PageSize, 5);
+
+    CMemoryDiff diff(process);
+    diff.retainRange(0x10000, 2 * c_PageSize);
+    REQUIRE(diff.capture());
+
+    // the page turns unreadable: it changed, but there are no bytes to compare
+    process->setPageReadable(0x11000, false);
+    data[0x10] ^= 0xff;
+    CMemoryDiffResult result{ };
+    REQUIRE(diff.diff(result));
+    CHECK((result.changedPages == std::vector<std::uint64_t>{ 0x10000, 0x11000 }));
+    REQUIRE(result.changedBytes.size() == 1);
+    CHECK(result.changedBytes[0].address == 0x10010);
+
+    // unreadable at capture time and readable again now, the capture has no bytes of it either
+    REQUIRE(diff.capture());
+    process->setPageReadable(0x11000, true);
+    REQUIRE(diff.diff(result));
+    CHECK((result.changedPages == std::vector<std::uint64_t>{ 0x11000 }));
+    CHECK(result.changedBytes.empty());
+}
+
+TEST_CASE(diffReportsRegionChanges) {
+    auto process = std::make_shared<CFakeProcessIO>();
+    process->addRegion(0x10000, c_PageSize);
+    process->addRegion(0x20000, c_PageSize);
+
+    CMemoryDiff diff(process);
+    REQUIRE(diff.capture());
+    process->removeRegion(0x20000);
+    process->addRegion(0x30000, 2 * c_PageSize);
+    process->addRegion(0x10000, 2 * c_PageSize); // same base, other size
+
+    CMemoryDiffResult result{ };
+    REQUIRE(diff.diff(result));
+    REQUIRE(result.removedRegions.size() == 2);
+    CHECK(result.removedRegions[0].address == 0x10000 && result.removedRegions[0].size == c_PageSize);
+    CHECK(result.removedRegions[1].address == 0x20000);
+    REQUIRE(result.addedRegions.size() == 2);
+    CHECK(result.addedRegions[0].address == 0x10000 && result.addedRegions[0].size == 2 * c_PageSize);
+    CHECK(result.addedRegions[1].address == 0x30000);
+}
+
+int main() {
+    return Test::run();
+}
@@ -0,0 +1,94 @@
+#include "test.h"
+#include "metrics.h"
+
+#include <thread>
+
+// CMetrics summaries and histogram percentiles, every case records into an operation no other case uses
+namespace {
+CMetricSummary summaryOf(TMetric metric) {
+    return CMetrics::summaries().at(static_cast<std::size_t>(metric));
+}
+
+bool isWithinQuarter(std::uint64_t estimate, std::uint64_t expected) {
+    return estimate * 4 >= expected * 3 && estimate * 4 <= expected * 5;
+}
+}
+
+TEST_CASE(countsCallsFailuresAndBytes) {
+    CMetrics::record(TMetric::Dump, 100, 1000, true);
+    CMetrics::record(TMetric::Dump, 50, 2000, false);
+    CMetrics::record(TMetric::Dump, 20, 3000, true);
+
+    const CMetricSummary summary = summaryOf(TMetric::Dump);
+    CHECK(summary.metric == TMetric::Dump);
+    CHECK(summary.calls == 3);
+    CHECK(summary.failures == 1);
+    CHECK(summary.bytes == 120); // only successful calls
+    CHECK(summary.totalNanoseconds == 6000);
+}
+
+TEST_CASE(smallLatenciesAreExact) {
+    for(std::uint64_t nanoseconds : { 0, 1, 2, 2, 3 }) {
+        CMetrics::record(TMetric::Protect, 0, nanoseconds, true);
+    }
+
+    const CMetricSummary summary = summaryOf(TMetric::Protect);
+    CHECK(summary.p50Nanoseconds == 2);
+    CHECK(summary.p99Nanoseconds == 3);
+}
+
+TEST_CASE(percentilesWithinBucketPrecision) {
+    // 1 us .. 1 ms in even steps, the true p50 is 500 us and the true p99 990 us
+    for(std::uint64_t i = 1; i <= 1000; ++i) {
+        CMetrics::record(TMetric::ReadPages, 0, i * 1000, true);
+    }
+
+    const CMetricSummary summary = summaryOf(TMetric::ReadPages);
+    CHECK(isWithinQuarter(summary.p50Nanoseconds, 500000));
+    CHECK(isWithinQuarter(summary.p99Nanoseconds, 990000));
+    CHECK(summary.p50Nanoseconds < summary.p99Nanoseconds);
+}
+
+TEST_CASE(sumsAllThreads) {
+    constexpr std::size_t c_ThreadCount{ 4 }, c_CallsPerThread{ 1000 };
+    std::vector<std::thread> threads{ };
+    for(std::size_t i = 0; i < c_ThreadCount; ++i) {
+        threads.emplace_back([]() -> void {
+            for(std::size_t j = 0; j < c_CallsPerThread; ++j) {
+                CMetrics::record(TMetric::WriteFromBuffer, 8, 100, true);
+            }
+        });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+
+    // the blocks of exited threads are kept, their counts stay in the summary
+    const CMetricSummary summary = summaryOf(TMetric::WriteFromBuffer);
+    CHECK(summary.calls == c_ThreadCount * c_CallsPerThread);
+    CHECK(summary.bytes == 8 * c_ThreadCount * c_CallsPerThread);
+}
+
+TEST_CASE(scopeRecordsFailureUnlessSucceeded) {
+    {
+        CMetricScope metric{ TMetric::ModuleListRefresh, 16 };
+    }
+    {
+        CMetricScope metric{ TMetric::ModuleListRefresh, 16 };
+        metric.succeeded();
+    }
+
+    const CMetricSummary summary = summaryOf(TMetric::ModuleListRefresh);
+    CHECK(summary.calls == 2);
+    CHECK(summary.failures == 1);
+    CHECK(summary.bytes == 16);
+    CHECK(CMetrics::json().find("\"name\":\"moduleListRefresh\",\"calls\":2,\"failures\":1,\"bytes\":16") != std::string::npos);
+}
+
+int main() {
+    if(!CMetrics::c_IsEnabled) {
+        fprintf(stderr, "built without MEMOBSERVER_METRICS, nothing to test\n");
+        return 0;
+    }
+    return Test::run();
+}
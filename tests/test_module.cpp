@@ -0,0 +1,89 @@
+#include "test.h"
+#include "fake_process.h"
+#include "module.h"
+#include <thread>
+
+namespace {
+constexpr std::uint32_t c_SizeOfImage{ 0x3000 };
+
+std::shared_ptr<CFakeProcessIO> processWithImages(std::initializer_list<std::uint64_t> bases) {
+    auto process = std::make_shared<CFakeProcessIO>();
+    for(const auto base : bases) {
+        process->addImage(base, c_SizeOfImage, 0x400, {
+            { ".text", 0x1000, 0x800, 0x1000 },
+            { ".data", 0x2000, 0x100, 0x200 },
+        });
+    }
+    return process;
+}
+}
+
+TEST_CASE(parsesOnFirstAccess) {
+    auto process = processWithImages({ 0x400000 });
+    const CModule module(CModuleMemento(0x400000, c_SizeOfImage, "fake.so"), process.get());
+    CHECK(!module.isParsed());
+    CHECK(process->reads() == 0);
+
+    REQUIRE(module.sections().size() == 2);
+    CHECK(std::string(module.sections()[0].tag()) == ".text");
+    CHECK(std::get<0>(module.sections()[1].info()) == 0x402000);
+    CHECK(module.isParsed() && module.headers().size() == 0x1000);
+    CHECK(process->reads() == 1);
+
+    // a module without headers is parsed once as well and has no sections
+    const CModule unreadable(CModuleMemento(0x900000, c_SizeOfImage, "gone.so"), process.get());
+    CHECK(unreadable.sections().empty() && unreadable.sections().empty());
+    CHECK(unreadable.isParsed());
+    CHECK(process->reads() == 2);
+}
+
+TEST_CASE(concurrentFirstAccessParsesOnce) {
+    auto process = processWithImages({ 0x400000 });
+    const CModule module(CModuleMemento(0x400000, c_SizeOfImage, "fake.so"), process.get());
+    // copies share the parsed headers with the original
+    const std::vector<CModule> copies(16, module);
+
+    std::vector<const std::vector<CSection>*> seen(copies.size());
+    std::vector<std::thread> threads{ };
+    for(std::size_t i = 0; i < copies.size(); ++i) {
+        threads.emplace_back([&, i]() -> void {
+            seen[i] = &copies[i].sections();
+        });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+
+    CHECK(process->reads() == 1);
+    for(const auto* sections : seen) {
+        CHECK(sections == &module.sections());
+    }
+    CHECK(module.sections().size() == 2);
+}
+
+TEST_CASE(prefetchReadsPendingHeadersInOneBatch) {
+    auto process = processWithImages({ 0x400000, 0x500000, 0x600000 });
+    const std::vector<CModule> modules{
+        CModule(CModuleMemento(0x400000, c_SizeOfImage, "a.so"), process.get()),
+        CModule(CModuleMemento(0x500000, c_SizeOfImage, "b.so"), process.get()),
+        CModule(CModuleMemento(0x600000, c_SizeOfImage, "c.so"), process.get()),
+    };
+    modules[1].sections();
+    CHECK(process->reads() == 1);
+
+    CModule::prefetchSections(modules);
+    CHECK(process->scatterReads() == 1);
+    CHECK(process->reads() == 3); // the parsed one is skipped
+    for(const auto& module : modules) {
+        CHECK(module.isParsed() && module.sections().size() == 2);
+    }
+    CHECK(process->reads() == 3);
+
+    // nothing left to read
+    CModule::prefetchSections(modules);
+    CHECK(process->scatterReads() == 1);
+}
+
+int main() {
+    return Test::run();
+}
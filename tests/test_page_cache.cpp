@@ -0,0 +1,98 @@
+#include "test.h"
+#include "fake_process.h"
+#include "page_cache.h"
+#include <algorithm>
+#include <thread>
+
+namespace {
+constexpr std::uint64_t c_Base{ 0x10000 };
+constexpr std::uint32_t c_PageSize{ CPageCache::c_PageSize };
+
+std::uint32_t readValue(CPageCache& cache, std::uint64_t address) {
+    std::uint32_t value{ };
+    CHECK(cache.read(address, sizeof(value), &value));
+    return value;
+}
+}
+
+TEST_CASE(servesPagesWithinTimeToLive) {
+    CFakeProcessIO process{ };
+    process.addRegion(c_Base, 2 * c_PageSize);
+    process.put<std::uint32_t>(c_Base + 0x10, 1);
+
+    CPageCache cache(&process);
+    cache.setTimeToLive(std::chrono::milliseconds(50));
+    CHECK(readValue(cache, c_Base + 0x10) == 1);
+
+    // the target changed behind the cache, the cached page is still served until it expires
+    process.put<std::uint32_t>(c_Base + 0x10, 2);
+    CHECK(readValue(cache, c_Base + 0x10) == 1);
+    CHECK(cache.hits() == 1 && cache.misses() == 1);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    CHECK(readValue(cache, c_Base + 0x10) == 2);
+    CHECK(cache.misses() == 2);
+
+    process.put<std::uint32_t>(c_Base + 0x10, 3);
+    cache.invalidate(c_Base + 0x10, sizeof(std::uint32_t));
+    CHECK(readValue(cache, c_Base + 0x10) == 3);
+}
+
+TEST_CASE(evictsLeastRecentlyUsed) {
+    CFakeProcessIO process{ };
+    process.addRegion(c_Base, 3 * c_PageSize);
+    for(std::uint32_t i = 0; i < 3; ++i) {
+        process.put<std::uint32_t>(c_Base + i * c_PageSize, i + 1);
+    }
+
+    CPageCache cache(&process, 2 * c_PageSize);
+    cache.setTimeToLive(std::chrono::hours(1));
+    readValue(cache, c_Base);
+    readValue(cache, c_Base + c_PageSize);
+    readValue(cache, c_Base);
+    readValue(cache, c_Base + 2 * c_PageSize); // over budget, the second page is the least recently used
+    CHECK(cache.misses() == 3 && cache.hits() == 1);
+
+    readValue(cache, c_Base);
+    CHECK(cache.misses() == 3 && cache.hits() == 2);
+    readValue(cache, c_Base + c_PageSize);
+    CHECK(cache.misses() == 4);
+}
+
+TEST_CASE(readsAcrossPagesAndZeroFills) {
+    CFakeProcessIO process{ };
+    std::uint8_t* bytes = process.addRegion(c_Base, 2 * c_PageSize);
+    for(std::uint32_t i = 0; i < 2 * c_PageSize; ++i) {
+        bytes[i] = static_cast<std::uint8_t>(i * 7);
+    }
+
+    CPageCache cache(&process);
+    std::vector<std::uint8_t> buffer(0x20);
+    REQUIRE(cache.read(c_Base + c_PageSize - 0x10, static_cast<std::uint32_t>(buffer.size()), buffer.data()));
+    CHECK(std::equal(buffer.begin(), buffer.end(), bytes + c_PageSize - 0x10));
+
+    // a page the target can not read is zero-filled and fails the request, the readable part is still copied
+    process.setPageReadable(c_Base + c_PageSize, false);
+    cache.clear();
+    std::fill(buffer.begin(), buffer.end(), 0xff);
+    CHECK(!cache.read(c_Base + c_PageSize - 0x10, static_cast<std::uint32_t>(buffer.size()), buffer.data()));
+    CHECK(std::equal(buffer.begin(), buffer.begin() + 0x10, bytes + c_PageSize - 0x10));
+    CHECK(std::all_of(buffer.begin() + 0x10, buffer.end(), [](std::uint8_t byte) { return byte == 0; }));
+}
+
+TEST_CASE(batchesOverlappingRequests) {
+    CFakeProcessIO process{ };
+    process.addRegion(c_Base, c_PageSize);
+    process.put<std::uint32_t>(c_Base + 4, 0x1234);
+
+    CPageCache cache(&process);
+    std::uint32_t first{ }, second{ };
+    CReadRequest requests[] = { { c_Base + 4, sizeof(first), &first }, { c_Base + 4, sizeof(second), &second } };
+    CHECK(cache.readScatter(requests) == 2);
+    CHECK(first == 0x1234 && second == 0x1234);
+    CHECK(cache.misses() == 1);
+}
+
+int main() {
+    return Test::run();
+}
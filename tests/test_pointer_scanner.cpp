@@ -0,0 +1,108 @@
+#include "test.h"
+#include "fake_process.h"
+#include "pointer_scanner.h"
+#include <filesystem>
+
+// a module slot reaching the target directly and another one through a heap object:
+//   game+200 -> B, B+30 is the target
+//   game+100 -> A, A+18 -> B, B+30 is the target
+namespace {
+constexpr std::uint64_t c_ModuleBase{ 0x140000000 };
+constexpr std::uint64_t c_ObjectA{ 0x20000000 };
+constexpr std::uint64_t c_ObjectB{ 0x20010000 };
+constexpr std::uint64_t c_Target{ c_ObjectB + 0x30 };
+
+std::shared_ptr<CFakeProcessIO> makeFixture() {
+    auto process = std::make_shared<CFakeProcessIO>();
+    process->addRegion(c_ModuleBase, 0x1000, PAGE_READONLY);
+    process->addRegion(c_ObjectA, 0x1000);
+    process->addRegion(c_ObjectB, 0x1000);
+    process->put<std::uint64_t>(c_ModuleBase + 0x100, c_ObjectA);
+    process->put<std::uint64_t>(c_ObjectA + 0x18, c_ObjectB);
+    process->put<std::uint64_t>(c_ModuleBase + 0x200, c_ObjectB);
+    return process;
+}
+
+const std::vector<CModuleMemento> c_Modules{ CModuleMemento(c_ModuleBase, 0x1000, "game") };
+}
+
+TEST_CASE(findsKnownPaths) {
+    auto process = makeFixture();
+    CPointerScanner scanner(process);
+    REQUIRE(scanner.scan(c_Target, 3, 0x100, c_Modules));
+
+    const auto results = scanner.results();
+    REQUIRE(results.size() == 2);
+    // shorter paths come first
+    CHECK(scanner.formatPath(results[0]) == "game+200 -> 30");
+    CHECK(scanner.formatPath(results[1]) == "game+100 -> 18 -> 30");
+    for(const auto& result : results) {
+        CHECK(scanner.resolve(result, c_Modules) == c_Target);
+    }
+    CHECK(scanner.progress() == 1.0f);
+}
+
+TEST_CASE(respectsDepthAndOffset) {
+    auto process = makeFixture();
+    CPointerScanner scanner(process);
+    REQUIRE(scanner.scan(c_Target, 1, 0x100, c_Modules));
+    REQUIRE(scanner.results().size() == 1);
+    CHECK(scanner.formatPath(scanner.results()[0]) == "game+200 -> 30");
+
+    // the last offset is larger than the allowed one
+    REQUIRE(scanner.scan(c_Target, 3, 0x20, c_Modules));
+    CHECK(scanner.results().empty());
+
+    CHECK(!scanner.scan(c_Target, 0, 0x100, c_Modules));
+    CHECK(!scanner.scan(c_Target, CPointerPath::c_MaximumDepth + 1, 0x100, c_Modules));
+}
+
+TEST_CASE(savesAndLoadsPaths) {
+    auto process = makeFixture();
+    CPointerScanner scanner(process);
+    REQUIRE(scanner.scan(c_Target, 3, 0x100, c_Modules));
+
+    const std::string path = (std::filesystem::temp_directory_path() / "memobserver_test_paths.txt").string();
+    REQUIRE(scanner.save(path));
+    CPointerScanner loaded(process);
+    const bool isLoaded = loaded.load(path);
+    std::filesystem::remove(path);
+    REQUIRE(isLoaded);
+    REQUIRE(loaded.results().size() == scanner.results().size());
+    for(std::size_t i = 0; i < loaded.results().size(); ++i) {
+        CHECK(loaded.formatPath(loaded.results()[i]) == scanner.formatPath(scanner.results()[i]));
+        CHECK(loaded.resolve(loaded.results()[i], c_Modules) == c_Target);
+    }
+    CHECK(!loaded.load(path)); // gone, the paths are kept
+    CHECK(loaded.results().size() == 2);
+}
+
+TEST_CASE(revalidatesAgainstChangedProcess) {
+    auto process = makeFixture();
+    CPointerScanner scanner(process);
+    REQUIRE(scanner.scan(c_Target, 3, 0x100, c_Modules));
+
+    // another instance with the module elsewhere and the heap link broken
+    auto restarted = makeFixture();
+    restarted->removeRegion(c_ModuleBase);
+    constexpr std::uint64_t c_MovedBase{ 0x150000000 };
+    restarted->addRegion(c_MovedBase, 0x1000, PAGE_READONLY);
+    restarted->put<std::uint64_t>(c_MovedBase + 0x100, c_ObjectA);
+    restarted->put<std::uint64_t>(c_MovedBase + 0x200, c_ObjectB);
+    restarted->put<std::uint64_t>(c_ObjectA + 0x18, 0);
+    const std::vector<CModuleMemento> movedModules{ CModuleMemento(c_MovedBase, 0x1000, "game") };
+
+    scanner.setTargetProcess(restarted);
+    REQUIRE(scanner.revalidate(c_Target, movedModules));
+    REQUIRE(scanner.results().size() == 1);
+    CHECK(scanner.formatPath(scanner.results()[0]) == "game+200 -> 30");
+
+    process.reset();
+    restarted.reset();
+    CHECK(!scanner.revalidate(c_Target, movedModules));
+    CHECK(scanner.results().size() == 1);
+}
+
+int main() {
+    return Test::run();
+}
@@ -0,0 +1,143 @@
+#include "test.h"
+#include "process_core.h"
+#include <elf.h>
+#include <chrono>
+
+namespace {
+struct CSegment {
+    std::uint64_t address{ };
+    std::uint64_t size{ };
+    std::uint64_t dumpedSize{ };
+    std::uint32_t flags{ PF_R };
+};
+
+// hand-made ET_CORE with one PT_LOAD per segment and no notes, byte i of a dumped segment is its fill + i
+class CCoreFixture {
+public:
+    CCoreFixture(const std::vector<CSegment>& segments)
+        : m_Path{ (std::filesystem::temp_directory_path() / ("memobserver_test_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".core")).string() } {
+        Elf64_Ehdr elfHeader{ };
+        memcpy(elfHeader.e_ident, ELFMAG, SELFMAG);
+        elfHeader.e_ident[EI_CLASS] = ELFCLASS64;
+        elfHeader.e_ident[EI_DATA] = ELFDATA2LSB;
+        elfHeader.e_ident[EI_VERSION] = EV_CURRENT;
+        elfHeader.e_type = ET_CORE;
+        elfHeader.e_machine = EM_X86_64;
+        elfHeader.e_version = EV_CURRENT;
+        elfHeader.e_phoff = sizeof(Elf64_Ehdr);
+        elfHeader.e_ehsize = sizeof(Elf64_Ehdr);
+        elfHeader.e_phentsize = sizeof(Elf64_Phdr);
+        elfHeader.e_phnum = static_cast<Elf64_Half>(segments.size());
+
+        std::vector<Elf64_Phdr> programHeaders{ };
+        std::vector<std::uint8_t> data{ };
+        std::uint64_t offset = 0x1000;
+        for(std::size_t i = 0; i < segments.size(); ++i) {
+            Elf64_Phdr segment{ };
+            segment.p_type = PT_LOAD;
+            segment.p_flags = segments[i].flags;
+            segment.p_offset = segments[i].dumpedSize ? offset : 0;
+            segment.p_vaddr = segments[i].address;
+            segment.p_filesz = segments[i].dumpedSize;
+            segment.p_memsz = segments[i].size;
+            segment.p_align = 0x1000;
+            programHeaders.push_back(segment);
+
+            for(std::uint64_t j = 0; j < segments[i].dumpedSize; ++j) {
+                data.push_back(static_cast<std::uint8_t>(fill(i) + j));
+            }
+            offset += segments[i].dumpedSize;
+        }
+
+        std::ofstream file(m_Path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&elfHeader), sizeof(elfHeader));
+        file.write(reinterpret_cast<const char*>(programHeaders.data()), programHeaders.size() * sizeof(Elf64_Phdr));
+        file.seekp(0x1000);
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+    ~CCoreFixture() {
+        std::error_code error{ };
+        std::filesystem::remove(m_Path, error);
+    }
+
+    static std::uint8_t fill(std::size_t segment) {
+        return static_cast<std::uint8_t>(0x10 * (segment + 1));
+    }
+
+    const std::string& path() const {
+        return m_Path;
+    }
+private:
+    std::string m_Path{ };
+};
+
+const std::vector<CSegment> c_Segments{
+    { 0x10000, 0x1000, 0x1000, PF_R | PF_W },
+    { 0x11000, 0x1000, 0x1000, PF_R }, // adjacent to the first one
+    { 0x13000, 0x1000, 0 }, // not dumped
+    { 0x20000, 0x2000, 0x1000, PF_R | PF_X }, // second page not dumped
+};
+}
+
+TEST_CASE(readsAcrossAdjacentSegments) {
+    const CCoreFixture core(c_Segments);
+    CProcessCoreIO process(core.path());
+    CHECK(process.memento().name() == std::filesystem::path(core.path()).filename().string());
+
+    std::vector<std::uint8_t> buffer(0x20);
+    REQUIRE(process.readToBuffer(0x10ff0, static_cast<std::uint32_t>(buffer.size()), buffer.data()));
+    CHECK(buffer[0] == static_cast<std::uint8_t>(CCoreFixture::fill(0) + 0xff0));
+    CHECK(buffer[0x10] == CCoreFixture::fill(1));
+    CHECK(process.read<std::uint8_t>(0x20010) == static_cast<std::uint8_t>(CCoreFixture::fill(3) + 0x10));
+    CHECK(process.view(0x10000, 0x1000).size() == 0x1000);
+    CHECK(process.view(0x10ff0, 0x20).empty()); // views never span segments
+}
+
+TEST_CASE(failsOutsideDumpedMemory) {
+    const CCoreFixture core(c_Segments);
+    CProcessCoreIO process(core.path());
+
+    std::uint8_t buffer[0x20]{ };
+    CHECK(!process.readToBuffer(0x11ff0, sizeof(buffer), buffer)); // runs into the gap
+    CHECK(!process.readToBuffer(0x12000, sizeof(buffer), buffer));
+    CHECK(!process.readToBuffer(0x13000, sizeof(buffer), buffer));
+    CHECK(!process.readToBuffer(0x20ff0, sizeof(buffer), buffer)); // runs into the part which was not dumped
+    CHECK(!process.writeFromBuffer(0x10000, sizeof(buffer), buffer));
+    CHECK(!std::get<0>(process.protect(0x10000, 0x1000, PAGE_READWRITE)));
+}
+
+TEST_CASE(queriesSegments) {
+    const CCoreFixture core(c_Segments);
+    CProcessCoreIO process(core.path());
+
+    const MBIEx region = process.query(0x10010);
+    CHECK(reinterpret_cast<std::uint64_t>(region.BaseAddress) == 0x10000 && region.RegionSize == 0x1000);
+    CHECK(region.State == MEM_COMMIT && region.Protect == PAGE_READWRITE);
+    CHECK(process.query(0x11000).Protect == PAGE_READONLY);
+    CHECK(process.query(0x12000).State == MEM_FREE);
+    CHECK(process.query(0x13000).Protect == PAGE_NOACCESS);
+    CHECK(process.query(0x21000).Protect == PAGE_NOACCESS);
+
+    std::size_t committed{ };
+    for(const auto& listed : process.regions()) {
+        committed += listed.State == MEM_COMMIT;
+    }
+    CHECK(committed == 5);
+}
+
+TEST_CASE(rejectsOtherFiles) {
+    const std::string path = (std::filesystem::temp_directory_path() / "memobserver_test_not_a_core").string();
+    std::ofstream(path) << "not a core";
+    bool isThrown{ };
+    try {
+        CProcessCoreIO process(path);
+    } catch(const std::runtime_error&) {
+        isThrown = true;
+    }
+    std::filesystem::remove(path);
+    CHECK(isThrown);
+}
+
+int main() {
+    return Test::run();
+}
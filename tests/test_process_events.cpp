@@ -0,0 +1,127 @@
+#include "test.h"
+#include "process.h"
+#include "process_linux.h"
+
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+
+// the proc connector parse and CProcessList::applyEvents on synthetic datagrams, the socket itself needs CAP_NET_ADMIN
+namespace {
+constexpr std::uint32_t c_ExitedId{ 0x7ffffff0 }; // above the default pid_max, never a live process
+
+// netlink messages laid out the way the kernel sends them, one proc_event each
+class CDatagram final {
+public:
+    CDatagram& fork(std::uint32_t pid, std::uint32_t tgid) {
+        proc_event& event = add(proc_event::PROC_EVENT_FORK);
+        event.event_data.fork.child_pid = static_cast<__kernel_pid_t>(pid);
+        event.event_data.fork.child_tgid = static_cast<__kernel_pid_t>(tgid);
+        return *this;
+    }
+    CDatagram& exec(std::uint32_t tgid) {
+        proc_event& event = add(proc_event::PROC_EVENT_EXEC);
+        event.event_data.exec.process_pid = static_cast<__kernel_pid_t>(tgid);
+        event.event_data.exec.process_tgid = static_cast<__kernel_pid_t>(tgid);
+        return *this;
+    }
+    CDatagram& exit(std::uint32_t pid, std::uint32_t tgid) {
+        proc_event& event = add(proc_event::PROC_EVENT_EXIT);
+        event.event_data.exit.process_pid = static_cast<__kernel_pid_t>(pid);
+        event.event_data.exit.process_tgid = static_cast<__kernel_pid_t>(tgid);
+        return *this;
+    }
+
+    std::unordered_map<std::uint32_t, bool> parse() const {
+        std::unordered_map<std::uint32_t, bool> pending{ };
+        CProcessEvents::parseMessage(reinterpret_cast<const std::uint8_t*>(m_Buffer.data()), m_Size, pending);
+        return pending;
+    }
+private:
+    proc_event& add(enum proc_event::what what) {
+        const std::size_t length = NLMSG_LENGTH(sizeof(cn_msg) + sizeof(proc_event));
+        m_Buffer.resize((m_Size + NLMSG_SPACE(sizeof(cn_msg) + sizeof(proc_event)) + sizeof(nlmsghdr) - 1) / sizeof(nlmsghdr));
+        auto* bytes = reinterpret_cast<std::uint8_t*>(m_Buffer.data()) + m_Size;
+
+        auto* header = reinterpret_cast<nlmsghdr*>(bytes);
+        header->nlmsg_len = static_cast<std::uint32_t>(length);
+        header->nlmsg_type = NLMSG_DONE;
+
+        auto* message = static_cast<cn_msg*>(NLMSG_DATA(header));
+        message->id.idx = CN_IDX_PROC;
+        message->id.val = CN_VAL_PROC;
+        message->len = sizeof(proc_event);
+
+        auto* event = reinterpret_cast<proc_event*>(message->data);
+        event->what = what;
+        m_Size += NLMSG_ALIGN(length);
+        return *event;
+    }
+
+    std::vector<nlmsghdr> m_Buffer{ }; // keeps the messages aligned
+    std::size_t m_Size{ };
+};
+
+bool contains(const std::vector<CProcessMemento>& processes, std::uint32_t id) {
+    return std::any_of(processes.begin(), processes.end(), [id](const CProcessMemento& process) { return process.id() == id; });
+}
+}
+
+TEST_CASE(threadEventsAreIgnored) {
+    const auto self = static_cast<std::uint32_t>(getpid());
+    const auto pending = CDatagram{ }.fork(self + 1, self).exit(self + 1, self).parse();
+    CHECK(pending.empty());
+}
+
+TEST_CASE(lastEventPerProcessWins) {
+    const auto self = static_cast<std::uint32_t>(getpid());
+    const auto pending = CDatagram{ }.fork(c_ExitedId, c_ExitedId).exit(c_ExitedId, c_ExitedId).exec(self).parse();
+    REQUIRE(pending.size() == 2);
+    CHECK(!pending.at(c_ExitedId));
+    CHECK(pending.at(self));
+
+    const CProcessEventBatch batch = CProcessEvents::toBatch(pending);
+    CHECK((batch.started == std::vector<std::uint32_t>{ self }));
+    CHECK((batch.exited == std::vector<std::uint32_t>{ c_ExitedId }));
+    CHECK(!batch.isOverrun);
+}
+
+TEST_CASE(appliesForkExecAndExit) {
+    const auto self = static_cast<std::uint32_t>(getpid()), parent = static_cast<std::uint32_t>(getppid());
+    const std::string name{ CProcessLinuxIO::processName(self) };
+    REQUIRE(!name.empty());
+
+    // the parent forked, this process exec'd since its row was read and the stale row exited
+    const std::vector<CProcessMemento> previous{ { c_ExitedId, "gone" }, { self, "stale" } };
+    const auto batch = CProcessEvents::toBatch(CDatagram{ }.exit(c_ExitedId, c_ExitedId).exec(self).fork(parent, parent).parse());
+    const auto processes = CProcessList::applyEvents(previous, batch);
+
+    REQUIRE(processes.size() == 2);
+    CHECK(processes[0].id() == self);
+    CHECK(processes[0].name() == name);
+    CHECK(processes[1].id() == parent);
+    CHECK(processes[1].name() == CProcessLinuxIO::processName(parent));
+}
+
+TEST_CASE(startedProcessWhichAlreadyExitedIsSkipped) {
+    const std::vector<CProcessMemento> previous{ };
+    const auto batch = CProcessEvents::toBatch(CDatagram{ }.fork(c_ExitedId, c_ExitedId).parse());
+    CHECK(CProcessList::applyEvents(previous, batch).empty());
+}
+
+TEST_CASE(overrunEnumeratesAgain) {
+    const std::vector<CProcessMemento> previous{ { c_ExitedId, "gone" } };
+    CProcessEventBatch batch{ };
+    batch.isOverrun = true;
+
+    const auto processes = CProcessList::applyEvents(previous, batch);
+    CHECK(contains(processes, static_cast<std::uint32_t>(getpid())));
+    CHECK(!contains(processes, c_ExitedId));
+}
+
+int main() {
+    return Test::run();
+}
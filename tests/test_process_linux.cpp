@@ -0,0 +1,167 @@
+#include "test.h"
+#include "process_linux.h"
+
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <csignal>
+#include <chrono>
+#include <unistd.h>
+
+// CProcessLinuxIO against a forked child, which inherits the fixture pages at the same addresses
+namespace {
+constexpr std::size_t c_PageSize{ 0x1000 };
+
+// three pages: 0x11 filled, inaccessible, 0x33 filled
+struct CFixturePages {
+    CFixturePages() {
+        void* pages = mmap(std::nullptr_t(), 3 * c_PageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(pages == MAP_FAILED)
+            throw std::runtime_error("Can not allocate the fixture pages");
+
+        data = static_cast<std::uint8_t*>(pages);
+        memset(data, 0x11, c_PageSize);
+        memset(data + 2 * c_PageSize, 0x33, c_PageSize);
+        mprotect(data + c_PageSize, c_PageSize, PROT_NONE);
+    }
+    ~CFixturePages() {
+        munmap(data, 3 * c_PageSize);
+    }
+
+    std::uint64_t address(std::size_t offset = 0) const {
+        return reinterpret_cast<std::uint64_t>(data) + offset;
+    }
+
+    std::uint8_t* data{ };
+};
+
+class CChildProcess final {
+public:
+    CChildProcess() {
+        m_Id = fork();
+        if(m_Id == -1)
+            throw std::runtime_error("Can not fork the child process");
+        if(!m_Id) {
+            prctl(PR_SET_PDEATHSIG, SIGKILL);
+            for(;;) {
+                pause();
+            }
+        }
+    }
+    ~CChildProcess() {
+        stop();
+    }
+
+    void stop() {
+        if(m_Id <= 0)
+            return;
+
+        kill(m_Id, SIGKILL);
+        waitpid(m_Id, std::nullptr_t(), 0);
+        m_Id = -1;
+    }
+
+    std::uint32_t id() const {
+        return static_cast<std::uint32_t>(m_Id);
+    }
+private:
+    pid_t m_Id{ -1 };
+};
+}
+
+TEST_CASE(readsChildMemory) {
+    const CFixturePages pages{ };
+    CChildProcess child{ };
+    CProcessLinuxIO process(CProcessMemento(child.id(), "child"));
+    REQUIRE(process.isAttached());
+
+    std::uint8_t buffer[c_PageSize]{ };
+    REQUIRE(process.readToBuffer(pages.address(), sizeof(buffer), buffer));
+    CHECK(!memcmp(buffer, pages.data, sizeof(buffer)));
+    CHECK(process.read<std::uint32_t>(pages.address(2 * c_PageSize + 8)) == 0x33333333);
+
+    // partial reads fail as a whole
+    CHECK(!process.readToBuffer(pages.address(c_PageSize - 4), 8, buffer));
+}
+
+TEST_CASE(readScatterSkipsInvalidRanges) {
+    const CFixturePages pages{ };
+    CChildProcess child{ };
+    CProcessLinuxIO process(CProcessMemento(child.id(), "child"));
+    REQUIRE(process.isAttached());
+
+    std::uint8_t buffers[3][16]{ };
+    CReadRequest requests[3]{
+        { pages.address(), 16, buffers[0] },
+        { pages.address(c_PageSize), 16, buffers[1] },
+        { pages.address(2 * c_PageSize), 16, buffers[2] },
+    };
+    CHECK(process.readScatter(requests) == 2);
+    CHECK(requests[0].isSuccessful && buffers[0][15] == 0x11);
+    CHECK(!requests[1].isSuccessful);
+    CHECK(requests[2].isSuccessful && buffers[2][0] == 0x33);
+}
+
+TEST_CASE(writesOnlyIntoChild) {
+    const CFixturePages pages{ };
+    CChildProcess child{ };
+    CProcessLinuxIO process(CProcessMemento(child.id(), "child"));
+    REQUIRE(process.isAttached());
+
+    REQUIRE(process.write<std::uint32_t>(pages.address(4), 0xdeadbeef));
+    CHECK(process.read<std::uint32_t>(pages.address(4)) == 0xdeadbeef);
+    CHECK(pages.data[4] == 0x11);
+
+    // read-only pages are written through /proc/<pid>/mem
+    mprotect(pages.data + 2 * c_PageSize, c_PageSize, PROT_READ);
+    CChildProcess readOnlyChild{ };
+    CProcessLinuxIO readOnlyProcess(CProcessMemento(readOnlyChild.id(), "child"));
+    REQUIRE(readOnlyProcess.write<std::uint8_t>(pages.address(2 * c_PageSize), 0x44));
+    CHECK(readOnlyProcess.read<std::uint8_t>(pages.address(2 * c_PageSize)) == 0x44);
+}
+
+TEST_CASE(queriesChildMappings) {
+    const CFixturePages pages{ };
+    CChildProcess child{ };
+    CProcessLinuxIO process(CProcessMemento(child.id(), "child"));
+    REQUIRE(process.isAttached());
+
+    const MBIEx region = process.query(pages.address(8));
+    CHECK(reinterpret_cast<std::uint64_t>(region.BaseAddress) == pages.address());
+    CHECK(region.RegionSize == c_PageSize);
+    CHECK(region.State == MEM_COMMIT);
+    CHECK(region.Protect == PAGE_READWRITE);
+    CHECK(region.Type == MEM_PRIVATE);
+    CHECK(process.query(pages.address(c_PageSize)).Protect == PAGE_NOACCESS);
+
+    bool isListed{ };
+    for(const auto& listed : process.regions()) {
+        isListed = isListed || reinterpret_cast<std::uint64_t>(listed.BaseAddress) == pages.address(2 * c_PageSize);
+    }
+    CHECK(isListed);
+}
+
+TEST_CASE(detectsChildExit) {
+    const CFixturePages pages{ };
+    CChildProcess child{ };
+    CProcessLinuxIO process(CProcessMemento(child.id(), "child"));
+    REQUIRE(process.isAttached());
+
+    child.stop();
+    // the watcher reports the exit asynchronously
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while(process.isAttached() && std::chrono::steady_clock::now() < deadline) {
+        usleep(1000);
+    }
+    CHECK(!process.isAttached());
+    CHECK(!process.read<std::uint32_t>(pages.address()));
+}
+
+TEST_CASE(refusesOwnProcess) {
+    CProcessLinuxIO process(CProcessMemento(static_cast<std::uint32_t>(getpid()), "self"));
+    CHECK(!process.isAttached());
+}
+
+int main() {
+    return Test::run();
+}
@@ -0,0 +1,108 @@
+#include "test.h"
+#include "refresh_scheduler.h"
+
+#include <QCoreApplication>
+#include <thread>
+
+// CRefreshScheduler on a real event loop, the bounds leave room for a loaded machine but not for a missing backoff
+namespace {
+void runEventLoop(int milliseconds) {
+    QTimer::singleShot(milliseconds, QCoreApplication::instance(), &QCoreApplication::quit);
+    QCoreApplication::exec();
+}
+}
+
+TEST_CASE(cheapRefreshesKeepConfiguredInterval) {
+    int refreshes{ };
+    CRefreshScheduler scheduler(nullptr, [&]() -> void { ++refreshes; });
+    scheduler.setInterval(20);
+    scheduler.setActive(true);
+    runEventLoop(110);
+
+    // at 0, 20, .. 100 ms at most
+    CHECK(refreshes >= 2);
+    CHECK(refreshes <= 6);
+    CHECK(scheduler.interval() == 20);
+}
+
+TEST_CASE(slowRefreshesStretchThePeriod) {
+    int refreshes{ };
+    CRefreshScheduler scheduler(nullptr, [&]() -> void {
+        ++refreshes;
+        std::this_thread::sleep_for(std::chrono::milliseconds(15));
+    });
+    scheduler.setInterval(1);
+    scheduler.setActive(true);
+    runEventLoop(200);
+
+    // four times the cost between refreshes, a 1 ms period would have run a dozen
+    CHECK(scheduler.interval() >= 60);
+    CHECK(refreshes >= 1);
+    CHECK(refreshes <= 4);
+}
+
+TEST_CASE(addedCostStretchesThePeriod) {
+    // the refresh only starts a read elsewhere, which reports 30 ms of work before the next refresh
+    int refreshes{ };
+    CRefreshScheduler* scheduler{ };
+    CRefreshScheduler owner(nullptr, [&]() -> void {
+        ++refreshes;
+        scheduler->addCost(std::chrono::milliseconds(30));
+    });
+    scheduler = &owner;
+    owner.setInterval(1);
+    owner.setActive(true);
+    runEventLoop(300);
+
+    CHECK(owner.interval() >= 60);
+    CHECK(refreshes <= 8);
+}
+
+TEST_CASE(requestsCollapseIntoOneRefresh) {
+    int refreshes{ };
+    CRefreshScheduler scheduler(nullptr, [&]() -> void { ++refreshes; });
+    scheduler.setInterval(10000);
+    scheduler.requestRefresh(); // inactive, ignored
+    runEventLoop(20);
+    CHECK(refreshes == 0);
+
+    scheduler.setActive(true);
+    scheduler.requestRefresh();
+    scheduler.requestRefresh();
+    runEventLoop(50);
+    CHECK(refreshes == 1);
+}
+
+TEST_CASE(requestWhileRefreshingRunsRightAfter) {
+    int refreshes{ };
+    CRefreshScheduler* scheduler{ };
+    CRefreshScheduler owner(nullptr, [&]() -> void {
+        if(++refreshes == 1)
+            scheduler->requestRefresh();
+    });
+    scheduler = &owner;
+    owner.setInterval(10000);
+    owner.setActive(true);
+    runEventLoop(50);
+    CHECK(refreshes == 2);
+}
+
+TEST_CASE(refreshWhichDeactivatesStopsTheTimer) {
+    int refreshes{ };
+    CRefreshScheduler* scheduler{ };
+    CRefreshScheduler owner(nullptr, [&]() -> void {
+        ++refreshes;
+        scheduler->setActive(false);
+    });
+    scheduler = &owner;
+    owner.setInterval(5);
+    owner.setActive(true);
+    runEventLoop(60);
+    CHECK(refreshes == 1);
+    CHECK(!owner.isActive());
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication application(argc, argv);
+    return Test::run();
+}
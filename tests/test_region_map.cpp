@@ -0,0 +1,81 @@
+#include "test.h"
+#include "fake_process.h"
+#include "region_map.h"
+#include <algorithm>
+#include <thread>
+
+// a map of its own over the fake, the fake only invalidates the map of the process
+namespace {
+std::uint64_t baseOf(const MBIEx& region) {
+    return reinterpret_cast<std::uint64_t>(region.BaseAddress);
+}
+}
+
+TEST_CASE(answersFromSnapshot) {
+    CFakeProcessIO process{ };
+    process.addRegion(0x10000, 0x2000);
+    process.addRegion(0x20000, 0x1000, PAGE_READONLY);
+
+    CRegionMap map(&process);
+    const MBIEx region = map.query(0x11008);
+    CHECK(baseOf(region) == 0x10000 && region.RegionSize == 0x2000 && region.State == MEM_COMMIT);
+    CHECK(map.misses() == 1 && map.hits() == 0);
+
+    CHECK(map.query(0x20010).Protect == PAGE_READONLY);
+    const MBIEx gap = map.query(0x18000);
+    CHECK(gap.State == MEM_FREE && baseOf(gap) == 0x12000 && gap.RegionSize == 0xe000);
+    CHECK(map.misses() == 1 && map.hits() == 2);
+
+    // free regions are part of the snapshot, sorted by address
+    const auto regions = map.regions();
+    REQUIRE(regions.size() == 5);
+    CHECK(std::is_sorted(regions.begin(), regions.end(), [](const MBIEx& a, const MBIEx& b) { return baseOf(a) < baseOf(b); }));
+}
+
+TEST_CASE(invalidateBumpsGeneration) {
+    CFakeProcessIO process{ };
+    process.addRegion(0x10000, 0x1000);
+
+    CRegionMap map(&process);
+    map.setTimeToLive(std::chrono::hours(1));
+    CHECK(map.query(0x30000).State == MEM_FREE);
+
+    // the snapshot is kept until the generation changes
+    process.addRegion(0x30000, 0x1000);
+    CHECK(map.query(0x30000).State == MEM_FREE);
+    map.invalidate();
+    CHECK(map.query(0x30000).State == MEM_COMMIT);
+    CHECK(map.misses() == 2);
+
+    process.removeRegion(0x30000);
+    map.refresh();
+    CHECK(map.query(0x30000).State == MEM_FREE);
+}
+
+TEST_CASE(snapshotExpires) {
+    CFakeProcessIO process{ };
+    process.addRegion(0x10000, 0x1000);
+
+    CRegionMap map(&process);
+    map.setTimeToLive(std::chrono::milliseconds(20));
+    CHECK(map.query(0x30000).State == MEM_FREE);
+
+    process.addRegion(0x30000, 0x1000);
+    CHECK(map.query(0x30000).State == MEM_FREE);
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    CHECK(map.query(0x30000).State == MEM_COMMIT);
+    CHECK(map.misses() == 2 && map.hits() == 1);
+}
+
+TEST_CASE(processCacheFollowsRegionChanges) {
+    // the fake invalidates the map of the process on every change, as backends do after an allocation they know of
+    CFakeProcessIO process{ };
+    process.regionMap().setTimeToLive(std::chrono::hours(1));
+    CHECK(process.queryCached(0x10000).State == MEM_FREE);
+    process.addRegion(0x10000, 0x1000);
+    CHECK(process.queryCached(0x10000).State == MEM_COMMIT);
+}
+
+int main() {
+    return Test::run();
+}
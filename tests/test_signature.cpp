@@ -0,0 +1,80 @@
+#include "test.h"
+#include "signature_scanner.h"
+#include <random>
+
+namespace {
+bool throwsInvalidArgument(const std::string& pattern) {
+    try {
+        CSignature signature(pattern);
+    } catch(const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+// byte by byte reference for find()
+std::vector<std::size_t> naiveFind(const CSignature& signature, std::span<const std::uint8_t> data) {
+    std::vector<std::size_t> offsets{ };
+    for(std::size_t i = 0; i + signature.size() <= data.size(); ++i) {
+        if(signature.matches(data.data() + i))
+            offsets.push_back(i);
+    }
+    return offsets;
+}
+}
+
+TEST_CASE(parsesBytesAndWildcards) {
+    const CSignature signature("48 8B ?? ? 89");
+    REQUIRE(signature.size() == 5);
+
+    const std::uint8_t matching[]{ 0x48, 0x8b, 0x12, 0x34, 0x89 }, other[]{ 0x48, 0x8b, 0x12, 0x34, 0x88 };
+    CHECK(signature.matches(matching));
+    CHECK(!signature.matches(other));
+
+    // spaces are optional and hex digits are case insensitive
+    const std::uint8_t compact[]{ 0xab, 0xcd };
+    CHECK(CSignature("abCD").matches(compact));
+}
+
+TEST_CASE(trimsTrailingWildcards) {
+    CHECK(CSignature("48 ?? ??").size() == 1);
+    CHECK(CSignature("?? 48").size() == 2);
+}
+
+TEST_CASE(rejectsMalformedPatterns) {
+    CHECK(throwsInvalidArgument(""));
+    CHECK(throwsInvalidArgument("?? ??"));
+    CHECK(throwsInvalidArgument("4"));
+    CHECK(throwsInvalidArgument("48 8"));
+    CHECK(throwsInvalidArgument("zz"));
+    CHECK(throwsInvalidArgument("48 -1"));
+}
+
+TEST_CASE(findsEveryMatch) {
+    const std::vector<std::uint8_t> data{ 0x00, 0x48, 0x8b, 0x05, 0x48, 0x8b, 0x48, 0x8b, 0x07 };
+    const CSignature signature("48 8B ??");
+    CHECK((signature.find(data) == std::vector<std::size_t>{ 1, 4, 6 }));
+    CHECK((signature.find(data, true) == std::vector<std::size_t>{ 1 }));
+    CHECK(CSignature("48 8B 06").find(data).empty());
+}
+
+TEST_CASE(findAgreesWithNaiveSearch) {
+    // a small alphabet makes partial matches frequent, the filtered and shifted searches have to agree with the reference
+    std::mt19937 random{ 1 };
+    std::vector<std::uint8_t> data(0x10000);
+    for(auto& byte : data) {
+        byte = static_cast<std::uint8_t>(0x40 + random() % 4);
+    }
+
+    for(const char* pattern : { "41", "41 42", "41 ?? 43", "?? 42 42 ??", "40 41 42 43 40 41", "43 ?? ?? ?? 40", "42 42 42 42 42 42 42 42 42 42 42 42 42 42 42 42 42" }) {
+        const CSignature signature(pattern);
+        const auto expected = naiveFind(signature, data);
+        if(!CHECK(signature.find(data) == expected))
+            fprintf(stderr, "    pattern %s\n", pattern);
+        CHECK(signature.find(data, true) == (expected.empty() ? expected : std::vector<std::size_t>{ expected.front() }));
+    }
+}
+
+int main() {
+    return Test::run();
+}
@@ -0,0 +1,82 @@
+#include "test.h"
+#include "fake_process.h"
+#include "snapshot.h"
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+
+namespace {
+constexpr std::uint64_t c_PageSize{ 0x1000 };
+
+// removes the file when the test case ends
+struct CTemporaryPath {
+    explicit CTemporaryPath(const std::string& name)
+        : path{ (std::filesystem::temp_directory_path() / ("memobserver_test_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + name)).string() } { }
+    ~CTemporaryPath() {
+        std::error_code error{ };
+        std::filesystem::remove(path, error);
+    }
+
+    std::string path;
+};
+
+void fill(std::uint8_t* data, std::size_t size, std::uint8_t seed) {
+    for(std::size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<std::uint8_t>(seed + i * 7);
+    }
+}
+}
+
+TEST_CASE(snapshotRoundTrip) {
+    auto process = std::make_shared<CFakeProcessIO>();
+    std::uint8_t* readable = process->addRegion(0x10000, 3 * c_PageSize);
+    fill(readable, 3 * c_PageSize, 1);
+    process->addRegion(0x20000, c_PageSize, PAGE_NOACCESS);
+    std::uint8_t* partial = process->addRegion(0x30000, 2 * c_PageSize, PAGE_READONLY);
+    fill(partial, 2 * c_PageSize, 2);
+    process->setPageReadable(0x31000, false);
+
+    const CTemporaryPath file{ ".snap" };
+    CSnapshotDumper dumper(process);
+    REQUIRE(dumper.dumpToFile(file.path));
+
+    const CSnapshotFile snapshot(file.path);
+    CHECK(!memcmp(snapshot.header().magic, CSnapshotDumper::c_Magic, sizeof(CSnapshotDumper::c_Magic)));
+    CHECK(snapshot.header().processId == 1);
+    CHECK(std::string(snapshot.header().processName) == "fake");
+    REQUIRE(snapshot.regions().size() == 3);
+
+    std::vector<std::uint8_t> buffer(3 * c_PageSize);
+    const CSnapshotRegion* region = snapshot.find(0x10010);
+    REQUIRE(region);
+    CHECK(region->baseAddress == 0x10000 && region->size == 3 * c_PageSize);
+    CHECK(region->flags == SnapshotRegionCaptured);
+    CHECK(snapshot.read(0x10000, static_cast<std::uint32_t>(buffer.size()), buffer.data()));
+    CHECK(!memcmp(buffer.data(), readable, buffer.size()));
+
+    // inaccessible regions are indexed but not captured
+    region = snapshot.find(0x20000);
+    REQUIRE(region);
+    CHECK(!region->fileOffset && region->protect == PAGE_NOACCESS);
+    CHECK(!snapshot.read(0x20000, 1, buffer.data()));
+
+    // unreadable pages of a captured region are zero-filled and flag it
+    region = snapshot.find(0x30000);
+    REQUIRE(region);
+    CHECK(region->flags == (SnapshotRegionCaptured | SnapshotRegionPartial));
+    CHECK(region->fileOffset % c_PageSize == 0);
+    const auto data = snapshot.data(*region);
+    REQUIRE(data.size() == 2 * c_PageSize);
+    CHECK(!memcmp(data.data(), partial, c_PageSize));
+    CHECK(std::all_of(data.begin() + c_PageSize, data.end(), [](std::uint8_t byte) { return !byte; }));
+
+    // the in-memory dump is the same file
+    CSnapshotDumper memoryDumper(process);
+    const auto& memoryDump = memoryDumper.dump();
+    CHECK(memoryDump.size() == snapshot.header().fileSize);
+    CHECK(CSnapshotDumper(std::make_shared<CFakeProcessIO>()).dump().empty());
+}
+
+int main() {
+    return Test::run();
+}
@@ -0,0 +1,100 @@
+#include "test.h"
+#include "fake_process.h"
+#include "value_scanner.h"
+
+namespace {
+std::vector<std::uint64_t> addressesOf(const CValueScanner& scanner) {
+    std::vector<std::uint64_t> addresses{ };
+    for(const auto& result : scanner.results()) {
+        addresses.push_back(result.address);
+    }
+    return addresses;
+}
+}
+
+TEST_CASE(exactFindsAlignedValues) {
+    auto process = std::make_shared<CFakeProcessIO>();
+    process->addRegion(0x10000, 0x3000);
+    const std::int32_t value{ 1234 };
+    memcpy(process->addRegion(0x20000, 0x1000, PAGE_NOACCESS), &value, sizeof(value)); // not readable
+    process->put<std::int32_t>(0x10010, 1234);
+    process->put<std::int32_t>(0x12ffc, 1234);
+    process->put<std::int32_t>(0x10021, 1234); // unaligned
+
+    CValueScanner scanner(process);
+    REQUIRE(scanner.firstScan(TScanValueType::Int32, TScanCompare::Exact, "1234"));
+    CHECK((addressesOf(scanner) == std::vector<std::uint64_t>{ 0x10010, 0x12ffc }));
+
+    process->put<std::int32_t>(0x10010, 1235);
+    REQUIRE(scanner.nextScan(TScanCompare::Exact, "1234"));
+    CHECK((addressesOf(scanner) == std::vector<std::uint64_t>{ 0x12ffc }));
+    CHECK(!scanner.nextScan(TScanCompare::Unknown));
+}
+
+TEST_CASE(unknownThenChanged) {
+    auto process = std::make_shared<CFakeProcessIO>();
+    process->addRegion(0x10000, 0x2000);
+
+    CValueScanner scanner(process);
+    REQUIRE(scanner.firstScan(TScanValueType::Int32, TScanCompare::Unknown));
+    CHECK(scanner.resultCount() == 0x2000 / sizeof(std::int32_t));
+    CHECK(scanner.results().empty());
+
+    process->put<std::int32_t>(0x10100, -5);
+    process->put<std::int32_t>(0x11ffc, 9);
+    REQUIRE(scanner.nextScan(TScanCompare::Changed));
+    REQUIRE(scanner.results().size() == 2);
+    CHECK(scanner.results()[0].address == 0x10100 && static_cast<std::int32_t>(scanner.results()[0].value) == -5);
+    CHECK(scanner.results()[1].address == 0x11ffc && scanner.results()[1].value == 9);
+
+    process->put<std::int32_t>(0x11ffc, 10);
+    REQUIRE(scanner.nextScan(TScanCompare::Increased));
+    CHECK((addressesOf(scanner) == std::vector<std::uint64_t>{ 0x11ffc }));
+}
+
+TEST_CASE(spanNeverCoversUnmappedPage) {
+    // one unmapped page between the results, a span over both of them would fail as a whole
+    auto process = std::make_shared<CFakeProcessIO>();
+    process->addRegion(0x10000, 0x1000);
+    process->addRegion(0x12000, 0x1000);
+    process->put<std::int32_t>(0x10ffc, 7);
+    process->put<std::int32_t>(0x12000, 7);
+
+    CValueScanner scanner(process);
+    REQUIRE(scanner.firstScan(TScanValueType::Int32, TScanCompare::Exact, "7"));
+    REQUIRE(scanner.nextScan(TScanCompare::Unchanged));
+    CHECK((addressesOf(scanner) == std::vector<std::uint64_t>{ 0x10ffc, 0x12000 }));
+}
+
+TEST_CASE(failedSpanFallsBackToSingleReads) {
+    auto process = std::make_shared<CFakeProcessIO>();
+    process->addRegion(0x20000, 0x2000);
+    process->put<std::int32_t>(0x20ff8, 7);
+    process->put<std::int32_t>(0x21008, 7);
+
+    CValueScanner scanner(process);
+    REQUIRE(scanner.firstScan(TScanValueType::Int32, TScanCompare::Exact, "7"));
+    CHECK(scanner.results().size() == 2);
+
+    // both are read in one span, only the second page went away since the first scan
+    process->setPageReadable(0x21000, false);
+    REQUIRE(scanner.nextScan(TScanCompare::Unchanged));
+    CHECK((addressesOf(scanner) == std::vector<std::uint64_t>{ 0x20ff8 }));
+}
+
+TEST_CASE(parallelForRethrowsWorkerException) {
+    bool isThrown{ };
+    try {
+        Utilities::parallelFor(64, [](std::size_t i) -> void {
+            if(i == 37)
+                throw std::runtime_error("task failed");
+        });
+    } catch(const std::runtime_error&) {
+        isThrown = true;
+    }
+    CHECK(isThrown);
+}
+
+int main() {
+    return Test::run();
+}
@@ -1,10 +1,29 @@
 #include "utilities.h"
+#ifdef _WIN32
 #include <shlobj_core.h>
+#endif
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define MEMOBSERVER_X86
+// the SSSE3/AVX2 kernels are compiled for their instruction set regardless of the build target and picked at runtime
+#ifdef _MSC_VER
+#include <intrin.h>
+#include <immintrin.h>
+#define MEMOBSERVER_TARGET(isa)
+#else
+#include <immintrin.h>
+#define MEMOBSERVER_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
 
 bool Utilities::isHandleValid(HANDLE h) {
     return h != 0 && h != INVALID_HANDLE_VALUE;
 }
 
+#ifdef _WIN32
 std::uint32_t Utilities::processExitCode(HANDLE h) {
     DWORD exitCode{ };
     if(!GetExitCodeProcess(h, &exitCode)) // not sure about this one
@@ -23,22 +42,261 @@ bool Utilities::isProcessActive(HANDLE h) {
 bool Utilities::isProcessActive(std::uint32_t exitCode) {
     return exitCode == STILL_ACTIVE;
 }
+#endif
 
 bool Utilities::isValidASCIIChar(char c) {
     return c > 0x20 && c < 0x7f;
 }
 
-std::string Utilities::generatePathForDump(const std::string& processName, const std::string& moduleName, const std::string& sectionName) {
+namespace {
+constexpr char c_HexDigits[]{ "0123456789abcdef" };
+
+char* bytesToHexScalar(const std::uint8_t* bytes, std::size_t size, char* out) {
+    for(std::size_t i = 0; i < size; ++i) {
+        *out++ = c_HexDigits[bytes[i] >> 4];
+        *out++ = c_HexDigits[bytes[i] & 0x0f];
+        *out++ = ' ';
+    }
+    return out;
+}
+
+char* bytesToASCIIScalar(const std::uint8_t* bytes, std::size_t size, char* out) {
+    for(std::size_t i = 0; i < size; ++i) {
+        out[i] = Utilities::isValidASCIIChar(static_cast<char>(bytes[i])) ? static_cast<char>(bytes[i]) : '.';
+    }
+    return out + size;
+}
+
+#ifdef MEMOBSERVER_X86
+// pshufb indices spreading 16 high (or low) digits over the 48 chars of "xx xx ...", part selects which 16 of them
+// an index with the high bit set produces 0, so the three shuffles of a part can be or'ed together
+constexpr std::array<std::int8_t, 16> spreadIndices(std::size_t part, std::size_t digit) {
+    std::array<std::int8_t, 16> indices{ };
+    for(std::size_t i = 0; i < indices.size(); ++i) {
+        const std::size_t position = part * 16 + i;
+        indices[i] = position % 3 == digit ? static_cast<std::int8_t>(position / 3) : static_cast<std::int8_t>(-128);
+    }
+    return indices;
+}
+
+constexpr std::array<char, 16> spreadSpaces(std::size_t part) {
+    std::array<char, 16> spaces{ };
+    for(std::size_t i = 0; i < spaces.size(); ++i) {
+        spaces[i] = (part * 16 + i) % 3 == 2 ? ' ' : '\0';
+    }
+    return spaces;
+}
+
+alignas(16) constexpr std::array<std::array<std::int8_t, 16>, 3> c_HighDigitIndices{ spreadIndices(0, 0), spreadIndices(1, 0), spreadIndices(2, 0) };
+alignas(16) constexpr std::array<std::array<std::int8_t, 16>, 3> c_LowDigitIndices{ spreadIndices(0, 1), spreadIndices(1, 1), spreadIndices(2, 1) };
+alignas(16) constexpr std::array<std::array<char, 16>, 3> c_Spaces{ spreadSpaces(0), spreadSpaces(1), spreadSpaces(2) };
+
+inline __m128i load128(const void* p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+MEMOBSERVER_TARGET("ssse3") char* bytesToHexSSSE3(const std::uint8_t* bytes, std::size_t size, char* out) {
+    const __m128i digits = load128(c_HexDigits);
+    const __m128i lowNibble = _mm_set1_epi8(0x0f);
+    std::size_t i{ };
+    for(; i + 16 <= size; i += 16, out += 48) {
+        const __m128i input = load128(bytes + i);
+        const __m128i high = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(input, 4), lowNibble));
+        const __m128i low = _mm_shuffle_epi8(digits, _mm_and_si128(input, lowNibble));
+        for(std::size_t part = 0; part < 3; ++part) {
+            const __m128i chars = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(high, load128(c_HighDigitIndices[part].data())),
+                                                            _mm_shuffle_epi8(low, load128(c_LowDigitIndices[part].data()))),
+                                               load128(c_Spaces[part].data()));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + part * 16), chars);
+        }
+    }
+    return bytesToHexScalar(bytes + i, size - i, out);
+}
+
+MEMOBSERVER_TARGET("avx2") char* bytesToHexAVX2(const std::uint8_t* bytes, std::size_t size, char* out) {
+    // vpshufb works within 128 bit lanes, so each lane formats its own 16 bytes into 48 chars
+    const __m256i digits = _mm256_broadcastsi128_si256(load128(c_HexDigits));
+    const __m256i lowNibble = _mm256_set1_epi8(0x0f);
+    __m256i highIndices[3], lowIndices[3], spaces[3];
+    for(std::size_t part = 0; part < 3; ++part) {
+        highIndices[part] = _mm256_broadcastsi128_si256(load128(c_HighDigitIndices[part].data()));
+        lowIndices[part] = _mm256_broadcastsi128_si256(load128(c_LowDigitIndices[part].data()));
+        spaces[part] = _mm256_broadcastsi128_si256(load128(c_Spaces[part].data()));
+    }
+
+    std::size_t i{ };
+    for(; i + 32 <= size; i += 32, out += 96) {
+        const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i));
+        const __m256i high = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(input, 4), lowNibble));
+        const __m256i low = _mm256_shuffle_epi8(digits, _mm256_and_si256(input, lowNibble));
+        for(std::size_t part = 0; part < 3; ++part) {
+            const __m256i chars = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(high, highIndices[part]),
+                                                                  _mm256_shuffle_epi8(low, lowIndices[part])),
+                                                  spaces[part]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + part * 16), _mm256_castsi256_si128(chars));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 48 + part * 16), _mm256_extracti128_si256(chars, 1));
+        }
+    }
+    return bytesToHexSSSE3(bytes + i, size - i, out);
+}
+
+MEMOBSERVER_TARGET("ssse3") char* bytesToASCIISSSE3(const std::uint8_t* bytes, std::size_t size, char* out) {
+    // signed compares, bytes >= 0x80 are negative and fail the first one
+    const __m128i lower = _mm_set1_epi8(0x20), upper = _mm_set1_epi8(0x7f), dot = _mm_set1_epi8('.');
+    std::size_t i{ };
+    for(; i + 16 <= size; i += 16) {
+        const __m128i input = load128(bytes + i);
+        const __m128i isValid = _mm_and_si128(_mm_cmpgt_epi8(input, lower), _mm_cmplt_epi8(input, upper));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_or_si128(_mm_and_si128(isValid, input), _mm_andnot_si128(isValid, dot)));
+    }
+    return bytesToASCIIScalar(bytes + i, size - i, out + i);
+}
+
+MEMOBSERVER_TARGET("avx2") char* bytesToASCIIAVX2(const std::uint8_t* bytes, std::size_t size, char* out) {
+    const __m256i lower = _mm256_set1_epi8(0x20), upper = _mm256_set1_epi8(0x7f), dot = _mm256_set1_epi8('.');
+    std::size_t i{ };
+    for(; i + 32 <= size; i += 32) {
+        const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i));
+        const __m256i isValid = _mm256_and_si256(_mm256_cmpgt_epi8(input, lower), _mm256_cmpgt_epi8(upper, input));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_blendv_epi8(dot, input, isValid));
+    }
+    return bytesToASCIISSSE3(bytes + i, size - i, out + i);
+}
+
+Utilities::TInstructionSet detectInstructionSet() {
+#ifdef _MSC_VER
+    int registers[4]{ };
+    __cpuid(registers, 0);
+    const int maximumLeaf = registers[0];
+    __cpuid(registers, 1);
+    const bool hasSSSE3 = registers[2] & (1 << 9);
+    // AVX2 also needs the OS to save the ymm registers (OSXSAVE set and XCR0 enabling the SSE and AVX state)
+    const bool hasAVXState = (registers[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+    bool hasAVX2{ };
+    if(maximumLeaf >= 7) {
+        __cpuidex(registers, 7, 0);
+        hasAVX2 = hasAVXState && (registers[1] & (1 << 5));
+    }
+#else
+    __builtin_cpu_init();
+    const bool hasSSSE3 = __builtin_cpu_supports("ssse3");
+    const bool hasAVX2 = __builtin_cpu_supports("avx2");
+#endif
+    if(hasAVX2)
+        return Utilities::TInstructionSet::AVX2;
+    if(hasSSSE3)
+        return Utilities::TInstructionSet::SSSE3;
+    return Utilities::TInstructionSet::Scalar;
+}
+#else
+Utilities::TInstructionSet detectInstructionSet() {
+    return Utilities::TInstructionSet::Scalar;
+}
+#endif
+}
+
+Utilities::TInstructionSet Utilities::instructionSet() {
+    static const TInstructionSet instructionSet{ detectInstructionSet() };
+    return instructionSet;
+}
+
+char* Utilities::bytesToHex(const std::uint8_t* bytes, std::size_t size, char* out) {
+    return bytesToHex(bytes, size, out, instructionSet());
+}
+
+char* Utilities::bytesToHex(const std::uint8_t* bytes, std::size_t size, char* out, TInstructionSet instructionSet) {
+    switch(std::min(instructionSet, Utilities::instructionSet())) {
+#ifdef MEMOBSERVER_X86
+    case TInstructionSet::AVX2: return bytesToHexAVX2(bytes, size, out);
+    case TInstructionSet::SSSE3: return bytesToHexSSSE3(bytes, size, out);
+#endif
+    default: return bytesToHexScalar(bytes, size, out);
+    }
+}
+
+char* Utilities::bytesToASCII(const std::uint8_t* bytes, std::size_t size, char* out) {
+    return bytesToASCII(bytes, size, out, instructionSet());
+}
+
+char* Utilities::bytesToASCII(const std::uint8_t* bytes, std::size_t size, char* out, TInstructionSet instructionSet) {
+    switch(std::min(instructionSet, Utilities::instructionSet())) {
+#ifdef MEMOBSERVER_X86
+    case TInstructionSet::AVX2: return bytesToASCIIAVX2(bytes, size, out);
+    case TInstructionSet::SSSE3: return bytesToASCIISSSE3(bytes, size, out);
+#endif
+    default: return bytesToASCIIScalar(bytes, size, out);
+    }
+}
+
+void Utilities::parallelFor(std::size_t count, const std::function<void(std::size_t)>& task) {
+    const std::size_t threadCount = std::min<std::size_t>(count, std::max(1u, std::thread::hardware_concurrency()));
+    if(threadCount <= 1) {
+        for(std::size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    // the first exception stops handing out indices, it is rethrown on the calling thread once all workers finished
+    std::atomic<std::size_t> nextIndex{ };
+    std::exception_ptr exception{ };
+    std::mutex exceptionMutex{ };
+    auto worker = [&]() -> void {
+        for(std::size_t i = nextIndex++; i < count; i = nextIndex++) {
+            try {
+                task(i);
+            } catch(...) {
+                std::scoped_lock lock{ exceptionMutex };
+                if(!exception)
+                    exception = std::current_exception();
+                nextIndex = count;
+                return;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads{ };
+    threads.reserve(threadCount - 1);
+    for(std::size_t i = 1; i < threadCount; ++i) {
+        try {
+            threads.emplace_back(worker);
+        } catch(const std::system_error&) { // out of threads, the ones already running share the work
+            break;
+        }
+    }
+    worker();
+    for(auto& thread : threads) {
+        thread.join();
+    }
+    if(exception)
+        std::rethrow_exception(exception);
+}
+
+std::string Utilities::generatePathForDump(const std::string& processName, const std::string& moduleName, std::uint64_t baseAddress, const std::string& sectionName) {
+    char address[24]{ };
+    sprintf_s(address, "%llx", static_cast<unsigned long long>(baseAddress));
+
     if(sectionName.empty())
-        return programDataDirectory() + std::string("\\") +
+        return programDataDirectory() + std::string(1, c_PathSeparator) +
                processName + std::string("_") +
                moduleName + std::string("_") +
-               std::to_string(time(NULL)) + std::string(".dmp");
+               address + uniqueSuffix() + std::string(".dmp");
     else
-        return programDataDirectory() + std::string("\\") +
+        return programDataDirectory() + std::string(1, c_PathSeparator) +
                moduleName + std::string("_") +
                sectionName + std::string("_") +
-               std::to_string(time(NULL)) + std::string(".dmp");
+               address + uniqueSuffix() + std::string(".dmp");
+}
+
+std::string Utilities::generatePathForSnapshot(const std::string& processName) {
+    return programDataDirectory() + std::string(1, c_PathSeparator) +
+           processName + uniqueSuffix() + std::string(".snap");
+}
+
+std::string Utilities::uniqueSuffix() {
+    // paths generated within the same second differ by the counter
+    static std::atomic<std::uint32_t> counter{ };
+    return std::string("_") + std::to_string(time(NULL)) + std::string("_") + std::to_string(counter++);
 }
 
 const std::string& Utilities::programDataDirectory() {
@@ -46,12 +304,22 @@ const std::string& Utilities::programDataDirectory() {
     if(!path.empty())
         return path;
 
+#ifdef _WIN32
     char buffer[MAX_PATH] = { };
     if (!SUCCEEDED(SHGetFolderPathA(NULL, CSIDL_LOCAL_APPDATA, NULL, SHGFP_TYPE_CURRENT, buffer))) {
         throw std::runtime_error("Critical: SHGetFolderPathW failed when getting program data directory");
     }
 
     path = std::string(buffer) + std::string("\\memObserver");
+#else
+    // XDG base directory spec: $XDG_DATA_HOME, falling back to ~/.local/share
+    if(const char* dataHome = getenv("XDG_DATA_HOME"); dataHome && *dataHome)
+        path = std::string(dataHome) + std::string("/memObserver");
+    else if(const char* home = getenv("HOME"); home && *home)
+        path = std::string(home) + std::string("/.local/share/memObserver");
+    else
+        throw std::runtime_error("Critical: neither XDG_DATA_HOME nor HOME is set when getting program data directory");
+#endif
     std::filesystem::create_directories(path);
 
     return path;
@@ -100,24 +368,82 @@ std::string MBIEx::format() const {
 }
 
 CBytesProtectionMask::CBytesProtectionMask(std::size_t size)
-    : m_Mask{ std::vector<CBytesProtectionMask::TByteType>(size, CBytesProtectionMask::TByteType::None) } { }
+    : m_Size{ size }, m_Runs{ CRun{ 0, CBytesProtectionMask::TByteType::None } } { }
 
 std::size_t CBytesProtectionMask::size() const {
-    return m_Mask.size();
+    return m_Size;
+}
+
+CBytesProtectionMask::TByteType CBytesProtectionMask::type(std::size_t index) const {
+    if(index >= m_Size)
+        throw std::out_of_range("CBytesProtectionMask type out of range");
+
+    return m_Runs[findRun(index)].type;
 }
 
-CBytesProtectionMask::TByteType& CBytesProtectionMask::operator[](std::size_t index) {
-    if(index >= m_Mask.size())
+CBytesProtectionMask::CTypeReference CBytesProtectionMask::operator[](std::size_t index) {
+    if(index >= m_Size)
         throw std::out_of_range("CBytesProtectionMask operator[] out of range");
 
-    return m_Mask[index];
+    return CTypeReference(*this, index);
+}
+
+CBytesProtectionMask::TByteType CBytesProtectionMask::operator[](std::size_t index) const {
+    return type(index);
 }
 
-const CBytesProtectionMask::TByteType& CBytesProtectionMask::operator[](std::size_t index) const {
-    if(index >= m_Mask.size())
-        throw std::out_of_range("CBytesProtectionMask const operator[] out of range");
+std::size_t CBytesProtectionMask::runEnd(std::size_t index) const {
+    if(index >= m_Size)
+        throw std::out_of_range("CBytesProtectionMask runEnd out of range");
 
-    return m_Mask[index];
+    const std::size_t run = findRun(index);
+    return run + 1 < m_Runs.size() ? m_Runs[run + 1].start : m_Size;
+}
+
+std::size_t CBytesProtectionMask::runCount() const {
+    return m_Runs.size();
+}
+
+void CBytesProtectionMask::setType(std::size_t index, std::size_t size, TByteType type) {
+    if(!size)
+        return;
+    if(index >= m_Size || size > m_Size - index)
+        throw std::out_of_range("CBytesProtectionMask setType out of range");
+
+    const std::size_t end = index + size;
+    if(index >= m_Runs.back().start) { // inside the last run, only the tail changes
+        const TByteType lastType = m_Runs.back().type;
+        if(lastType == type)
+            return;
+
+        if(index == m_Runs.back().start) {
+            m_Runs.pop_back();
+            if(m_Runs.empty() || m_Runs.back().type != type)
+                m_Runs.push_back({ index, type });
+        } else {
+            m_Runs.push_back({ index, type });
+        }
+        if(end < m_Size)
+            m_Runs.push_back({ end, lastType });
+        return;
+    }
+
+    const auto byStart = [](const CRun& run, std::size_t start) -> bool { return run.start < start; };
+    const TByteType endType = end < m_Size ? m_Runs[findRun(end)].type : type;
+
+    // drop every run starting inside the range, then re-add the range and the run continuing after it
+    auto first = std::lower_bound(m_Runs.begin(), m_Runs.end(), index, byStart);
+    auto last = std::lower_bound(first, m_Runs.end(), end, byStart);
+    const bool hasRunAtEnd = last != m_Runs.end() && last->start == end;
+    auto position = m_Runs.erase(first, last);
+
+    if(end < m_Size && !hasRunAtEnd)
+        position = m_Runs.insert(position, { end, endType });
+    if(position != m_Runs.end() && position->type == type) // the following run continues the range
+        position = m_Runs.erase(position);
+
+    if(position == m_Runs.begin() || std::prev(position)->type != type)
+        m_Runs.insert(position, { index, type });
 }
 
 CBytesProtectionMask::TByteType CBytesProtectionMask::typeByProtection(std::uint32_t protection) {
@@ -134,15 +460,23 @@ CBytesProtectionMask::TByteType CBytesProtectionMask::typeByProtection(std::uint
     return result;
 }
 
+std::size_t CBytesProtectionMask::findRun(std::size_t index) const {
+    const auto run = std::upper_bound(m_Runs.begin(), m_Runs.end(), index, [](std::size_t i, const CRun& r) -> bool {
+        return i < r.start;
+    });
+    return static_cast<std::size_t>(std::prev(run) - m_Runs.begin());
+}
+
 void CBytesProtectionMask::setProtection(std::size_t index, std::uint32_t protection) {
-    operator[](index) = typeByProtection(protection);
+    setType(index, 1, typeByProtection(protection));
+}
+
+void CBytesProtectionMask::setProtection(std::size_t index, std::size_t size, std::uint32_t protection) {
+    setType(index, size, typeByProtection(protection));
 }
 
 void CBytesProtectionMask::setAllProtection(std::uint32_t protection) {
-    const auto type = typeByProtection(protection);
-    for(std::size_t i = 0; i < m_Mask.size(); ++i) {
-        operator[](i) = type;
-    }
+    m_Runs = { CRun{ 0, typeByProtection(protection) } };
 }
 
 CBytesProtectionMaskFormattablePlain::CBytesProtectionMaskFormattablePlain(std::size_t size)
@@ -152,6 +486,26 @@ std::string CBytesProtectionMaskFormattablePlain::format(std::size_t index, std:
     return byteToString(byte, operator[](index));
 }
 
+std::string CBytesProtectionMaskFormattablePlain::formatHex(std::span<const std::uint8_t> bytes, std::size_t index) const {
+    std::string result(bytes.size() * 3, '\0');
+    formatHexTo(bytes, index, result.data());
+    return result;
+}
+
+std::string CBytesProtectionMaskFormattablePlain::formatRows(std::span<const std::uint8_t> bytes, std::size_t index, std::size_t bytesInRow) const {
+    const std::size_t rows = (bytes.size() + bytesInRow - 1) / bytesInRow;
+    std::string result(bytes.size() * 4 + rows, '\0');
+
+    char* out = result.data();
+    for(std::size_t offset = 0; offset < bytes.size(); offset += bytesInRow) {
+        const auto row = bytes.subspan(offset, std::min(bytesInRow, bytes.size() - offset));
+        out = formatHexTo(row, index + offset, out);
+        out = Utilities::bytesToASCII(row.data(), row.size(), out);
+        *out++ = '\n';
+    }
+    return result;
+}
+
 std::string CBytesProtectionMaskFormattablePlain::byteToString(std::uint8_t byte, CBytesProtectionMask::TByteType type) const {
     static char invalidByte[4]{"??"}, guardedByte[4]{"xx"};
 
@@ -160,27 +514,87 @@ std::string CBytesProtectionMaskFormattablePlain::byteToString(std::uint8_t byte
     if(type == CBytesProtectionMask::TByteType::NoAccess)
         return std::string(invalidByte);
 
-    char buffer[4]{ };
-    sprintf_s(buffer, "%02x", byte);
-    return std::string(buffer);
+    char buffer[3]{ };
+    Utilities::bytesToHex(&byte, 1, buffer);
+    return std::string(buffer, 2);
+}
+
+char* CBytesProtectionMaskFormattablePlain::formatHexTo(std::span<const std::uint8_t> bytes, std::size_t index, char* out) const {
+    char* end = Utilities::bytesToHex(bytes.data(), bytes.size(), out);
+
+    // unreadable bytes come in page sized runs, patch them afterwards instead of branching per byte
+    for(std::size_t i = index; i < index + bytes.size(); ) {
+        const std::size_t next = std::min(runEnd(i), index + bytes.size());
+        const auto type = operator[](i);
+        if(type == CBytesProtectionMask::TByteType::Guarded || type == CBytesProtectionMask::TByteType::NoAccess) {
+            const char placeholder = type == CBytesProtectionMask::TByteType::Guarded ? 'x' : '?';
+            for(std::size_t j = i; j < next; ++j) {
+                out[(j - index) * 3] = out[(j - index) * 3 + 1] = placeholder;
+            }
+        }
+        i = next;
+    }
+    return end;
 }
 
 CBytesProtectionMaskFormattableHTML::CBytesProtectionMaskFormattableHTML(std::size_t size)
     : CBytesProtectionMaskFormattablePlain(size) { }
 
 std::string CBytesProtectionMaskFormattableHTML::format(std::size_t index, std::uint8_t byte) const {
-    static std::unordered_map<CBytesProtectionMask::TByteType, const std::string> protectionColors{
-        { CBytesProtectionMask::TByteType::NoAccess, "<font color=\"LightSlateGray\">" },
-        { CBytesProtectionMask::TByteType::Guarded, "<font color=\"Navy\">" },
-        { CBytesProtectionMask::TByteType::RWX, "<font color=\"Indigo\">" },
-        { CBytesProtectionMask::TByteType::Execute, "<font color=\"OliveDrab\">" },
-    };
-
     static const std::string styleEnd{ "</font>" };
 
     CBytesProtectionMask::TByteType type{ operator[](index) };
     if(type == CBytesProtectionMask::TByteType::None)
         return byteToString(byte);
 
-    return protectionColors[type] + byteToString(byte, type) + styleEnd;
+    return protectionColor(type) + byteToString(byte, type) + styleEnd;
+}
+
+std::string CBytesProtectionMaskFormattableHTML::formatRows(std::span<const std::uint8_t> bytes, std::size_t index, std::size_t bytesInRow) const {
+    static const std::string styleEnd{ "</font>" }, lineEnd{ "<br>" };
+
+    std::string result{ };
+    result.reserve(bytes.size() * 5);
+    std::string chars(bytesInRow, '\0');
+    for(std::size_t offset = 0; offset < bytes.size(); offset += bytesInRow) {
+        const auto row = bytes.subspan(offset, std::min(bytesInRow, bytes.size() - offset));
+        for(std::size_t i = index + offset; i < index + offset + row.size(); ) {
+            const std::size_t next = std::min(runEnd(i), index + offset + row.size());
+            const auto type = operator[](i);
+            const auto run = row.subspan(i - index - offset, next - i);
+            if(type == CBytesProtectionMask::TByteType::None) {
+                result += formatHex(run, i);
+            } else {
+                result += protectionColor(type);
+                result += formatHex(run, i);
+                result += styleEnd;
+            }
+            i = next;
+        }
+
+        Utilities::bytesToASCII(row.data(), row.size(), chars.data());
+        for(std::size_t i = 0; i < row.size(); ++i) {
+            switch(chars[i]) {
+            case '<': result += "&lt;"; break;
+            case '>': result += "&gt;"; break;
+            case '&': result += "&amp;"; break;
+            default: result += chars[i]; break;
+            }
+        }
+        result += lineEnd;
+    }
+    return result;
+}
+
+const std::string& CBytesProtectionMaskFormattableHTML::protectionColor(CBytesProtectionMask::TByteType type) {
+    static const std::unordered_map<CBytesProtectionMask::TByteType, const std::string> protectionColors{
+        { CBytesProtectionMask::TByteType::NoAccess, "<font color=\"LightSlateGray\">" },
+        { CBytesProtectionMask::TByteType::Guarded, "<font color=\"Navy\">" },
+        { CBytesProtectionMask::TByteType::RWX, "<font color=\"Indigo\">" },
+        { CBytesProtectionMask::TByteType::Execute, "<font color=\"OliveDrab\">" },
+    };
+    static const std::string noColor{ };
+
+    const auto colorIterator = protectionColors.find(type);
+    return colorIterator != protectionColors.end() ? colorIterator->second : noColor;
 }
@@ -1,17 +1,25 @@
 #pragma once
 #include <string>
 #include <QString>
-#include <Windows.h>
+#include "platform.h"
 #include <stdexcept>
 #include <array>
 #include <fstream>
 #include <filesystem>
+#include <span>
+#include <functional>
 
 class IFormattable {
 public:
     virtual std::string format() const = 0;
 };
 
+enum class TSort {
+    None,
+    ID, // base address for modules
+    Name,
+};
+
 template<class T>
 class ISortStrategy {
 public:
@@ -29,13 +37,47 @@ public:
 class Utilities {
 public:
     static bool isHandleValid(HANDLE h);
+#ifdef _WIN32
     static std::uint32_t processExitCode(HANDLE h);
     static bool isProcessActive(HANDLE h);
     static bool isProcessActive(std::uint32_t exitCode);
+#endif
     static bool isValidASCIIChar(char c);
 
-    static std::string generatePathForDump(const std::string& processName, const std::string& moduleName, const std::string& sectionName = "");
+    // ordered, a kernel of a set also uses the ones below it for the tail
+    enum class TInstructionSet {
+        Scalar,
+        SSSE3,
+        AVX2,
+    };
+    // best set the CPU supports, detected once
+    static TInstructionSet instructionSet();
+    // bulk formatting kernels (SSSE3/AVX2 when the CPU has them, table driven otherwise)
+    // @return Returns pointer past the last written char, bytesToHex writes "xx " (3 chars) per byte
+    static char* bytesToHex(const std::uint8_t* bytes, std::size_t size, char* out);
+    // @return Returns pointer past the last written char, bytes failing isValidASCIIChar are written as '.'
+    static char* bytesToASCII(const std::uint8_t* bytes, std::size_t size, char* out);
+    // instructionSet is capped at instructionSet(), lets callers compare the kernels against each other
+    static char* bytesToHex(const std::uint8_t* bytes, std::size_t size, char* out, TInstructionSet instructionSet);
+    static char* bytesToASCII(const std::uint8_t* bytes, std::size_t size, char* out, TInstructionSet instructionSet);
+
+    // runs task(0) ... task(count - 1) on up to hardware_concurrency threads, indices are handed out in ascending order.
+    // When a task throws no further indices are started and the first exception is rethrown after all threads joined
+    static void parallelFor(std::size_t count, const std::function<void(std::size_t)>& task);
+
+    // baseAddress of the module or the section, two dumps never get the same path within one run
+    static std::string generatePathForDump(const std::string& processName, const std::string& moduleName, std::uint64_t baseAddress, const std::string& sectionName = "");
+    static std::string generatePathForSnapshot(const std::string& processName);
     static const std::string& programDataDirectory();
+private:
+    // "_<timestamp>_<counter>"
+    static std::string uniqueSuffix();
+
+#ifdef _WIN32
+    static constexpr char c_PathSeparator{ '\\' };
+#else
+    static constexpr char c_PathSeparator{ '/' };
+#endif
 };
 
 class MBIEx final : public MEMORY_BASIC_INFORMATION, public IFormattable {
@@ -46,6 +88,7 @@ public:
     virtual std::string format() const override;
 };
 
+// protection type per byte, stored as runs since protection only changes at page boundaries
 class CBytesProtectionMask {
 public:
     enum class TByteType : std::uint8_t {
@@ -56,6 +99,19 @@ public:
         Execute,
         RWX,
     };
+
+    // what non-const operator[] returns, assignment goes through setType
+    class CTypeReference {
+    public:
+        CTypeReference(CBytesProtectionMask& mask, std::size_t index)
+            : m_Mask{ mask }, m_Index{ index } { }
+
+        operator TByteType() const { return m_Mask.type(m_Index); }
+        CTypeReference& operator=(TByteType type) { m_Mask.setType(m_Index, 1, type); return *this; }
+    private:
+        CBytesProtectionMask& m_Mask;
+        std::size_t m_Index{ };
+    };
 public:
     CBytesProtectionMask(std::size_t size);
 
@@ -63,15 +119,31 @@ public:
     CBytesProtectionMask& operator=(const CBytesProtectionMask&) = delete;
 public:
     std::size_t size() const;
-    TByteType& operator[](std::size_t index);
-    const TByteType& operator[](std::size_t index) const;
+    // O(log runs)
+    TByteType type(std::size_t index) const;
+    CTypeReference operator[](std::size_t index);
+    TByteType operator[](std::size_t index) const;
+    // @return Returns index past the run of equally typed bytes containing index
+    std::size_t runEnd(std::size_t index) const;
+    std::size_t runCount() const;
 
+    // O(1) when the range starts inside the last run, which is how readPages fills the mask front to back
+    void setType(std::size_t index, std::size_t size, TByteType type);
     void setProtection(std::size_t index, std::uint32_t protection);
+    void setProtection(std::size_t index, std::size_t size, std::uint32_t protection);
     void setAllProtection(std::uint32_t protection);
 private:
-    TByteType typeByProtection(std::uint32_t protection);
+    struct CRun {
+        std::size_t start{ };
+        TByteType type{ };
+    };
+
+    static TByteType typeByProtection(std::uint32_t protection);
+    // @return Returns index of the run containing index
+    std::size_t findRun(std::size_t index) const;
 
-    std::vector<TByteType> m_Mask{ };
+    std::size_t m_Size{ };
+    std::vector<CRun> m_Runs{ }; // sorted by start, the first one starts at 0 and neighbours never share a type
 };
 
 class CBytesProtectionMaskFormattablePlain : public CBytesProtectionMask {
@@ -79,8 +151,13 @@ public:
     CBytesProtectionMaskFormattablePlain(std::size_t size);
 
     std::string format(std::size_t index, std::uint8_t byte) const;
+    // bytes start at mask position index, "xx " per byte with inaccessible bytes written as "?? " and guarded as "xx "
+    std::string formatHex(std::span<const std::uint8_t> bytes, std::size_t index) const;
+    // hex column followed by the ascii column for every bytesInRow bytes, one row per line
+    virtual std::string formatRows(std::span<const std::uint8_t> bytes, std::size_t index, std::size_t bytesInRow) const;
 protected:
     std::string byteToString(std::uint8_t byte, CBytesProtectionMask::TByteType type = CBytesProtectionMask::TByteType::None) const;
+    char* formatHexTo(std::span<const std::uint8_t> bytes, std::size_t index, char* out) const;
 };
 
 class CBytesProtectionMaskFormattableHTML : public CBytesProtectionMaskFormattablePlain {
@@ -88,4 +165,8 @@ public:
     CBytesProtectionMaskFormattableHTML(std::size_t size);
 
     std::string format(std::size_t index, std::uint8_t byte) const;
+    // one <font> span per protection run instead of one per byte
+    virtual std::string formatRows(std::span<const std::uint8_t> bytes, std::size_t index, std::size_t bytesInRow) const override;
+private:
+    static const std::string& protectionColor(CBytesProtectionMask::TByteType type);
 };
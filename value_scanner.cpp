@@ -0,0 +1,492 @@
+#include "value_scanner.h"
+#include <functional>
+#include <algorithm>
+#include <limits>
+
+namespace {
+template<class T>
+T loadValue(const std::uint8_t* data) {
+    T value{ };
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+template<class T>
+T fromRaw(std::uint64_t raw) {
+    T value{ };
+    std::memcpy(&value, &raw, sizeof(T));
+    return value;
+}
+
+template<class T>
+std::uint64_t toRaw(T value) {
+    std::uint64_t raw{ };
+    std::memcpy(&raw, &value, sizeof(T));
+    return raw;
+}
+
+// compares count values spaced by step, match flags are produced for blocks of 64 values so the compare loop vectorizes
+// and only blocks with a match are walked again
+template<class T, class Predicate, class OnMatch>
+void forEachMatch(const std::uint8_t* current, const std::uint8_t* previous, std::size_t count, std::size_t step, Predicate predicate, OnMatch onMatch) {
+    constexpr std::size_t c_BlockSize{ 64 };
+    bool isMatch[c_BlockSize]{ };
+    for(std::size_t block = 0; block < count; block += c_BlockSize) {
+        const std::size_t blockCount = std::min(c_BlockSize, count - block);
+        bool isAnyMatch{ };
+        for(std::size_t i = 0; i < blockCount; ++i) {
+            const std::size_t offset = (block + i) * step;
+            isMatch[i] = predicate(loadValue<T>(current + offset), loadValue<T>(previous + offset));
+            isAnyMatch |= isMatch[i];
+        }
+        if(!isAnyMatch)
+            continue;
+
+        for(std::size_t i = 0; i < blockCount; ++i) {
+            if(isMatch[i])
+                onMatch((block + i) * step);
+        }
+    }
+}
+
+// calls function with the predicate for compare, so the switch stays outside of the compare loops
+template<class T, class Function>
+void withPredicate(TScanCompare compare, T value, T upperValue, Function function) {
+    switch(compare) {
+    case TScanCompare::Exact: function([value](T current, T) -> bool { return current == value; }); break;
+    case TScanCompare::Range: function([value, upperValue](T current, T) -> bool { return value <= current && current <= upperValue; }); break;
+    case TScanCompare::Unknown: function([](T, T) -> bool { return true; }); break;
+    case TScanCompare::Changed: function([](T current, T previous) -> bool { return current != previous; }); break;
+    case TScanCompare::Unchanged: function([](T current, T previous) -> bool { return current == previous; }); break;
+    case TScanCompare::Increased: function([](T current, T previous) -> bool { return current > previous; }); break;
+    case TScanCompare::Decreased: function([](T current, T previous) -> bool { return current < previous; }); break;
+    }
+}
+}
+
+CValueScanner::CValueScanner(std::weak_ptr<IProcessIO> targetProcess)
+    : m_TargetProcess{ targetProcess } { }
+
+bool CValueScanner::firstScan(TScanValueType valueType, TScanCompare compare, const std::string& value, const std::string& upperValue) {
+    reset();
+    m_ValueType = valueType;
+
+    if(!isCompareSupported(valueType, compare, true))
+        return false;
+
+    bool isSuccessful{ };
+    if(valueType == TScanValueType::String) {
+        m_String = value;
+        isSuccessful = !m_String.empty() && scanString(compare, true);
+    } else {
+        std::uint64_t lower{ }, upper{ };
+        if(compare != TScanCompare::Unknown && !parseValue(value, lower))
+            return false;
+        if(compare == TScanCompare::Range && !parseValue(upperValue, upper))
+            return false;
+
+        switch(valueType) {
+        case TScanValueType::Int8: isSuccessful = scan<std::int8_t>(compare, lower, upper, true); break;
+        case TScanValueType::Int16: isSuccessful = scan<std::int16_t>(compare, lower, upper, true); break;
+        case TScanValueType::Int32: isSuccessful = scan<std::int32_t>(compare, lower, upper, true); break;
+        case TScanValueType::Int64: isSuccessful = scan<std::int64_t>(compare, lower, upper, true); break;
+        case TScanValueType::Float: isSuccessful = scan<float>(compare, lower, upper, true); break;
+        case TScanValueType::Double: isSuccessful = scan<double>(compare, lower, upper, true); break;
+        default: break;
+        }
+    }
+
+    if(!isSuccessful) // cancelled or the process is gone, partial first scan results are useless
+        reset();
+    m_HasResults = isSuccessful;
+    return isSuccessful;
+}
+
+bool CValueScanner::nextScan(TScanCompare compare, const std::string& value, const std::string& upperValue) {
+    if(!m_HasResults || !isCompareSupported(m_ValueType, compare, false))
+        return false;
+
+    if(m_ValueType == TScanValueType::String) {
+        if(compare == TScanCompare::Exact && !value.empty())
+            m_String = value;
+        return scanString(compare, false);
+    }
+
+    std::uint64_t lower{ }, upper{ };
+    if((compare == TScanCompare::Exact || compare == TScanCompare::Range) && !parseValue(value, lower))
+        return false;
+    if(compare == TScanCompare::Range && !parseValue(upperValue, upper))
+        return false;
+
+    switch(m_ValueType) {
+    case TScanValueType::Int8: return scan<std::int8_t>(compare, lower, upper, false);
+    case TScanValueType::Int16: return scan<std::int16_t>(compare, lower, upper, false);
+    case TScanValueType::Int32: return scan<std::int32_t>(compare, lower, upper, false);
+    case TScanValueType::Int64: return scan<std::int64_t>(compare, lower, upper, false);
+    case TScanValueType::Float: return scan<float>(compare, lower, upper, false);
+    case TScanValueType::Double: return scan<double>(compare, lower, upper, false);
+    default: return false;
+    }
+}
+
+void CValueScanner::reset() {
+    m_HasResults = false;
+    m_Results.clear();
+    m_Results.shrink_to_fit();
+    m_Snapshot.clear();
+    m_Snapshot.shrink_to_fit();
+    m_SnapshotCandidates = { };
+    m_CompletedTasks = m_TotalTasks = { };
+}
+
+bool CValueScanner::isCompareSupported(TScanValueType valueType, TScanCompare compare, bool isFirstScan) {
+    if(valueType == TScanValueType::String)
+        return compare == TScanCompare::Exact || (!isFirstScan && (compare == TScanCompare::Changed || compare == TScanCompare::Unchanged));
+
+    switch(compare) {
+    case TScanCompare::Exact:
+    case TScanCompare::Range:
+        return true;
+    case TScanCompare::Unknown:
+        return isFirstScan;
+    case TScanCompare::Changed:
+    case TScanCompare::Unchanged:
+    case TScanCompare::Increased:
+    case TScanCompare::Decreased:
+        return !isFirstScan;
+    default:
+        return false;
+    }
+}
+
+void CValueScanner::cancel() {
+    m_IsCancelled = true;
+}
+
+float CValueScanner::progress() const {
+    const std::size_t total = m_TotalTasks;
+    return total ? static_cast<float>(m_CompletedTasks) / static_cast<float>(total) : 0.f;
+}
+
+bool CValueScanner::hasResults() const {
+    return m_HasResults;
+}
+
+TScanValueType CValueScanner::valueType() const {
+    return m_ValueType;
+}
+
+std::uint64_t CValueScanner::resultCount() const {
+    return m_Snapshot.empty() ? m_Results.size() : m_SnapshotCandidates;
+}
+
+std::span<const CScanResult> CValueScanner::results() const {
+    return m_Results;
+}
+
+std::string CValueScanner::formatValue(const CScanResult& result) const {
+    char buffer[64]{ };
+    switch(m_ValueType) {
+    case TScanValueType::Int8: sprintf_s(buffer, "%d", fromRaw<std::int8_t>(result.value)); break;
+    case TScanValueType::Int16: sprintf_s(buffer, "%d", fromRaw<std::int16_t>(result.value)); break;
+    case TScanValueType::Int32: sprintf_s(buffer, "%d", fromRaw<std::int32_t>(result.value)); break;
+    case TScanValueType::Int64: sprintf_s(buffer, "%lld", static_cast<long long>(fromRaw<std::int64_t>(result.value))); break;
+    case TScanValueType::Float: sprintf_s(buffer, "%.7g", fromRaw<float>(result.value)); break;
+    case TScanValueType::Double: sprintf_s(buffer, "%.15g", fromRaw<double>(result.value)); break;
+    case TScanValueType::String: return m_String;
+    }
+    return std::string(buffer);
+}
+
+bool CValueScanner::parseValue(const std::string& text, std::uint64_t& value) const {
+    try {
+        std::size_t parsedLength{ };
+        switch(m_ValueType) {
+        case TScanValueType::Float:
+            value = toRaw(std::stof(text, &parsedLength));
+            break;
+        case TScanValueType::Double:
+            value = toRaw(std::stod(text, &parsedLength));
+            break;
+        case TScanValueType::String:
+            return false;
+        default: {
+            // both signed and unsigned notations are accepted (255 and -1 are the same int8), base prefixes work too
+            const std::uint64_t parsed = text.find('-') != std::string::npos ?
+                static_cast<std::uint64_t>(std::stoll(text, &parsedLength, 0)) :
+                std::stoull(text, &parsedLength, 0);
+            const std::size_t bits = valueSize() * 8;
+            value = bits == 64 ? parsed : parsed & ((1ull << bits) - 1);
+            break;
+        }
+        }
+        return parsedLength == text.size();
+    } catch(const std::exception&) {
+        return false;
+    }
+}
+
+std::size_t CValueScanner::valueSize() const {
+    switch(m_ValueType) {
+    case TScanValueType::Int8: return 1;
+    case TScanValueType::Int16: return 2;
+    case TScanValueType::Int32: return 4;
+    case TScanValueType::Int64: return 8;
+    case TScanValueType::Float: return 4;
+    case TScanValueType::Double: return 8;
+    case TScanValueType::String: return m_String.size();
+    }
+    return 1;
+}
+
+std::size_t CValueScanner::valueStep() const {
+    // values are expected to be naturally aligned, strings can start anywhere
+    return m_ValueType == TScanValueType::String ? 1 : valueSize();
+}
+
+std::vector<CValueScanner::CScanChunk> CValueScanner::scanChunks() const {
+    auto process = m_TargetProcess.lock();
+    if(!process)
+        return { };
+
+    std::vector<CScanChunk> chunks{ };
+    for(const auto& region : process->regions()) {
+        if(region.State != MEM_COMMIT || !region.Protect || region.Protect & (PAGE_NOACCESS | PAGE_GUARD))
+            continue;
+
+        const std::uint64_t regionStart = reinterpret_cast<std::uint64_t>(region.BaseAddress);
+        const std::uint64_t regionEnd = regionStart + region.RegionSize;
+        for(std::uint64_t address = regionStart; address < regionEnd; address += c_ChunkSize) {
+            const std::uint64_t size = std::min(c_ChunkSize, regionEnd - address);
+            chunks.push_back({ address, size, std::min(address + size + valueSize() - 1, regionEnd) });
+        }
+    }
+    return chunks;
+}
+
+template<class T>
+bool CValueScanner::scan(TScanCompare compare, std::uint64_t value, std::uint64_t upperValue, bool isFirstScan) {
+    auto process = m_TargetProcess.lock();
+    if(!process)
+        return false;
+
+    m_IsCancelled = false;
+    m_CompletedTasks = { };
+    const std::size_t step = valueStep();
+
+    withPredicate<T>(compare, fromRaw<T>(value), fromRaw<T>(upperValue), [&](auto predicate) -> void {
+        if(isFirstScan) {
+            const auto chunks = scanChunks();
+            m_TotalTasks = chunks.size();
+
+            std::vector<std::vector<CScanResult>> chunkResults(chunks.size());
+            std::vector<std::vector<CSnapshotBlock>> chunkBlocks(chunks.size());
+            Utilities::parallelFor(chunks.size(), [&](std::size_t i) -> void {
+                if(m_IsCancelled)
+                    return;
+
+                const auto& chunk = chunks[i];
+                std::vector<std::uint8_t> buffer(chunk.readEnd - chunk.address);
+                for(const auto& [offset, size] : process->readAvailable(chunk.address, static_cast<std::uint32_t>(buffer.size()), buffer.data())) {
+                    // values have to start inside the chunk and fit into the readable range
+                    const std::size_t startsEnd = std::min<std::size_t>(offset + size, chunk.size);
+                    if(startsEnd <= offset || size < sizeof(T))
+                        continue;
+                    const std::size_t count = std::min((startsEnd - offset + step - 1) / step, (size - sizeof(T)) / step + 1);
+
+                    if(compare == TScanCompare::Unknown) {
+                        chunkBlocks[i].push_back({ chunk.address + offset, std::vector<std::uint8_t>(buffer.begin() + offset, buffer.begin() + offset + size) });
+                        continue;
+                    }
+
+                    forEachMatch<T>(buffer.data() + offset, buffer.data() + offset, count, step, predicate, [&](std::size_t matchOffset) -> void {
+                        chunkResults[i].push_back({ chunk.address + offset + matchOffset, toRaw(loadValue<T>(buffer.data() + offset + matchOffset)) });
+                    });
+                }
+                ++m_CompletedTasks;
+            });
+            if(m_IsCancelled)
+                return;
+
+            for(std::size_t i = 0; i < chunks.size(); ++i) {
+                m_Results.insert(m_Results.end(), chunkResults[i].begin(), chunkResults[i].end());
+                for(auto& block : chunkBlocks[i]) {
+                    m_SnapshotCandidates += (block.data.size() - sizeof(T)) / step + 1;
+                    m_Snapshot.push_back(std::move(block));
+                }
+            }
+            return;
+        }
+
+        std::vector<CScanResult> results{ };
+        if(!m_Snapshot.empty()) {
+            // first narrowing of an unknown scan, compare every candidate against the snapshot
+            m_TotalTasks = m_Snapshot.size();
+            std::vector<std::vector<CScanResult>> blockResults(m_Snapshot.size());
+            Utilities::parallelFor(m_Snapshot.size(), [&](std::size_t i) -> void {
+                if(m_IsCancelled)
+                    return;
+
+                const auto& block = m_Snapshot[i];
+                std::vector<std::uint8_t> buffer(block.data.size());
+                for(const auto& [offset, size] : process->readAvailable(block.address, static_cast<std::uint32_t>(buffer.size()), buffer.data())) {
+                    if(size < sizeof(T))
+                        continue;
+                    // the overlap with the next block is shorter than a value, so values which fit never start in it
+                    const std::size_t count = (size - sizeof(T)) / step + 1;
+
+                    forEachMatch<T>(buffer.data() + offset, block.data.data() + offset, count, step, predicate, [&](std::size_t matchOffset) -> void {
+                        blockResults[i].push_back({ block.address + offset + matchOffset, toRaw(loadValue<T>(buffer.data() + offset + matchOffset)) });
+                    });
+                }
+                ++m_CompletedTasks;
+            });
+            if(m_IsCancelled)
+                return;
+
+            for(auto& blockResult : blockResults) {
+                results.insert(results.end(), blockResult.begin(), blockResult.end());
+            }
+        } else {
+            // previous results are sorted, neighbours are read together in spans of up to a chunk
+            constexpr std::size_t c_SliceSize{ 0x10000 };
+            const std::size_t slices = (m_Results.size() + c_SliceSize - 1) / c_SliceSize;
+            m_TotalTasks = slices;
+
+            std::vector<std::vector<CScanResult>> sliceResults(slices);
+            Utilities::parallelFor(slices, [&](std::size_t i) -> void {
+                if(m_IsCancelled)
+                    return;
+
+                const std::span<const CScanResult> slice{ m_Results.data() + i * c_SliceSize, std::min(c_SliceSize, m_Results.size() - i * c_SliceSize) };
+                std::vector<CReadRequest> spans{ };
+                std::vector<std::size_t> resultSpans(slice.size()); // span index of every result
+                for(std::size_t j = 0; j < slice.size(); ++j) {
+                    const std::uint64_t address = slice[j].address;
+                    // gaps of a whole page are never bridged, the page in between may be unmapped
+                    if(spans.empty() || address + sizeof(T) - spans.back().address > c_ChunkSize || address >= spans.back().address + spans.back().size + 0x1000)
+                        spans.push_back({ address, 0 });
+                    spans.back().size = static_cast<std::uint32_t>(address + sizeof(T) - spans.back().address);
+                    resultSpans[j] = spans.size() - 1;
+                }
+
+                std::vector<std::size_t> spanOffsets(spans.size());
+                std::size_t bufferSize{ };
+                for(std::size_t j = 0; j < spans.size(); ++j) {
+                    spanOffsets[j] = bufferSize;
+                    bufferSize += spans[j].size;
+                }
+                std::vector<std::uint8_t> buffer(bufferSize);
+                for(std::size_t j = 0; j < spans.size(); ++j) {
+                    spans[j].buffer = buffer.data() + spanOffsets[j];
+                }
+                process->readScatter(spans);
+
+                // a span fails as a whole when a page inside it is gone, its results are read one by one instead
+                std::vector<CReadRequest> retries{ };
+                std::vector<std::size_t> resultRetries(slice.size(), std::numeric_limits<std::size_t>::max());
+                for(std::size_t j = 0; j < slice.size(); ++j) {
+                    if(spans[resultSpans[j]].isSuccessful)
+                        continue;
+
+                    resultRetries[j] = retries.size();
+                    retries.push_back({ slice[j].address, sizeof(T) });
+                }
+                std::vector<std::uint8_t> retryBuffer(retries.size() * sizeof(T));
+                for(std::size_t j = 0; j < retries.size(); ++j) {
+                    retries[j].buffer = retryBuffer.data() + j * sizeof(T);
+                }
+                if(!retries.empty())
+                    process->readScatter(retries);
+
+                for(std::size_t j = 0; j < slice.size(); ++j) {
+                    const std::uint8_t* valueBytes{ };
+                    if(const auto& span = spans[resultSpans[j]]; span.isSuccessful)
+                        valueBytes = static_cast<std::uint8_t*>(span.buffer) + (slice[j].address - span.address);
+                    else if(retries[resultRetries[j]].isSuccessful)
+                        valueBytes = static_cast<std::uint8_t*>(retries[resultRetries[j]].buffer);
+                    else
+                        continue;
+
+                    const T current = loadValue<T>(valueBytes);
+                    if(predicate(current, fromRaw<T>(slice[j].value)))
+                        sliceResults[i].push_back({ slice[j].address, toRaw(current) });
+                }
+                ++m_CompletedTasks;
+            });
+            if(m_IsCancelled)
+                return;
+
+            for(auto& sliceResult : sliceResults) {
+                results.insert(results.end(), sliceResult.begin(), sliceResult.end());
+            }
+        }
+
+        m_Results = std::move(results);
+        m_Snapshot.clear();
+        m_Snapshot.shrink_to_fit();
+        m_SnapshotCandidates = { };
+    });
+
+    return !m_IsCancelled;
+}
+
+bool CValueScanner::scanString(TScanCompare compare, bool isFirstScan) {
+    auto process = m_TargetProcess.lock();
+    if(!process || m_String.empty())
+        return false;
+
+    m_IsCancelled = false;
+    m_CompletedTasks = { };
+
+    if(isFirstScan) {
+        const auto chunks = scanChunks();
+        m_TotalTasks = chunks.size();
+
+        const std::boyer_moore_horspool_searcher searcher(m_String.begin(), m_String.end());
+        std::vector<std::vector<CScanResult>> chunkResults(chunks.size());
+        Utilities::parallelFor(chunks.size(), [&](std::size_t i) -> void {
+            if(m_IsCancelled)
+                return;
+
+            const auto& chunk = chunks[i];
+            std::vector<std::uint8_t> buffer(chunk.readEnd - chunk.address);
+            for(const auto& [offset, size] : process->readAvailable(chunk.address, static_cast<std::uint32_t>(buffer.size()), buffer.data())) {
+                const auto begin = reinterpret_cast<const char*>(buffer.data()) + offset, end = begin + size;
+                for(auto match = std::search(begin, end, searcher); match != end; match = std::search(match + 1, end, searcher)) {
+                    const std::size_t matchOffset = match - reinterpret_cast<const char*>(buffer.data());
+                    if(matchOffset >= chunk.size) // belongs to the next chunk
+                        break;
+                    chunkResults[i].push_back({ chunk.address + matchOffset });
+                }
+            }
+            ++m_CompletedTasks;
+        });
+        if(m_IsCancelled)
+            return false;
+
+        for(auto& chunkResult : chunkResults) {
+            m_Results.insert(m_Results.end(), chunkResult.begin(), chunkResult.end());
+        }
+        return true;
+    }
+
+    // only equality with the remembered string is known for next scans, Changed is its negation
+    std::vector<CReadRequest> requests(m_Results.size());
+    std::vector<char> buffer(m_Results.size() * m_String.size());
+    for(std::size_t i = 0; i < m_Results.size(); ++i) {
+        requests[i] = { m_Results[i].address, static_cast<std::uint32_t>(m_String.size()), buffer.data() + i * m_String.size() };
+    }
+    m_TotalTasks = 1;
+    process->readScatter(requests);
+
+    std::vector<CScanResult> results{ };
+    for(std::size_t i = 0; i < m_Results.size(); ++i) {
+        const bool isEqual = requests[i].isSuccessful && !std::memcmp(requests[i].buffer, m_String.data(), m_String.size());
+        if(isEqual == (compare != TScanCompare::Changed))
+            results.push_back(m_Results[i]);
+    }
+    m_Results = std::move(results);
+    ++m_CompletedTasks;
+    return true;
+}
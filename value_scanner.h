@@ -0,0 +1,91 @@
+#pragma once
+#include "process.h"
+#include <atomic>
+
+enum class TScanValueType : std::uint8_t {
+    Int8,
+    Int16,
+    Int32,
+    Int64,
+    Float,
+    Double,
+    String,
+};
+
+enum class TScanCompare : std::uint8_t {
+    Exact,
+    Range, // value <= x <= upperValue
+    Unknown, // first scan only, remembers all readable memory
+    Changed, // next scans only, compared against the value seen by the previous scan
+    Unchanged,
+    Increased,
+    Decreased,
+};
+
+struct CScanResult {
+    std::uint64_t address{ };
+    std::uint64_t value{ }; // raw bytes of the value seen by the last scan, unused for strings
+};
+
+// Scans committed readable memory of a process for values and narrows the results down with next scans.
+// Regions are split into chunks which are read and compared on all cores
+class CValueScanner {
+public:
+    CValueScanner(std::weak_ptr<IProcessIO> targetProcess);
+    ~CValueScanner() = default;
+
+    // @return Returns false when value can not be parsed as valueType or compare is not a first scan compare
+    bool firstScan(TScanValueType valueType, TScanCompare compare, const std::string& value = "", const std::string& upperValue = "");
+    // @return Returns false when there was no first scan, value can not be parsed or compare is Unknown
+    bool nextScan(TScanCompare compare, const std::string& value = "", const std::string& upperValue = "");
+    void reset();
+
+    // strings are only compared for equality, so they have no Range/Unknown/Increased/Decreased
+    // @return Returns true when firstScan (isFirstScan) or nextScan accepts compare for valueType
+    static bool isCompareSupported(TScanValueType valueType, TScanCompare compare, bool isFirstScan);
+
+    // both are safe to call from other threads while a scan runs
+    void cancel();
+    float progress() const;
+
+    bool hasResults() const;
+    TScanValueType valueType() const;
+    // after an unknown first scan this is the number of candidate addresses, results() stays empty until the next scan
+    std::uint64_t resultCount() const;
+    std::span<const CScanResult> results() const;
+    std::string formatValue(const CScanResult& result) const;
+private:
+    // a chunk of memory remembered by an unknown first scan
+    struct CSnapshotBlock {
+        std::uint64_t address{ };
+        std::vector<std::uint8_t> data{ };
+    };
+
+    struct CScanChunk {
+        std::uint64_t address{ };
+        std::uint64_t size{ }; // values have to start inside, the read may go up to valueSize - 1 bytes further
+        std::uint64_t readEnd{ };
+    };
+
+    static constexpr std::uint64_t c_ChunkSize{ 0x100000 };
+
+    bool parseValue(const std::string& text, std::uint64_t& value) const;
+    std::size_t valueSize() const;
+    std::size_t valueStep() const;
+    std::vector<CScanChunk> scanChunks() const;
+    template<class T>
+    bool scan(TScanCompare compare, std::uint64_t value, std::uint64_t upperValue, bool isFirstScan);
+    bool scanString(TScanCompare compare, bool isFirstScan);
+private:
+    std::weak_ptr<IProcessIO> m_TargetProcess;
+
+    TScanValueType m_ValueType{ };
+    std::string m_String{ };
+    bool m_HasResults{ };
+    std::vector<CScanResult> m_Results{ };
+    std::vector<CSnapshotBlock> m_Snapshot{ };
+    std::uint64_t m_SnapshotCandidates{ };
+
+    std::atomic<bool> m_IsCancelled{ };
+    std::atomic<std::size_t> m_CompletedTasks{ }, m_TotalTasks{ };
+};